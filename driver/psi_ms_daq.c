@@ -5,7 +5,21 @@
 ############################################################################*/
 
 #include "psi_ms_daq.h"
+#include "psi_ms_daq_atomic.h"
 #include <stdlib.h>
+#include <math.h>
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+	#include <arm_neon.h>
+#endif
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+//Writable configuration bits of the MODE register (ARM is a pulse, REC is read-only)
+#define MODE_CFG_MSK	(	(((1 << (PSI_MS_DAQ_REG_MODE_MSB_RECM+1))-1) << PSI_MS_DAQ_REG_MODE_LSB_RECM) | \
+							PSI_MS_DAQ_REG_MODE_BIT_TODISABLE | PSI_MS_DAQ_REG_MODE_BIT_FRAMETO)
 
 //*******************************************************************************
 // Types
@@ -15,17 +29,87 @@ typedef struct {
 	bool isConfigured;
 	uint8_t widthBytes;
 	uint8_t windows;
+	atomic_uint_fast32_t modeShadow;		//Configuration bits of the MODE register (see WriteArm())
 	int8_t lastProcWin;
-	uint32_t irqCalledWin;
+	atomic_uint_fast32_t irqCalledWin;
+	atomic_uint_fast16_t* winRefCnt;
+	PsiMsDaq_DataChunk_f* statsFct;
+	int64_t statsThreshold;
+	PsiMsDaq_WinStats_t* winStats;
+	atomic_uint_fast32_t statsValid;
 	PsiMsDaqn_WinIrq_f* irqFctWin;
 	PsiMsDaqn_StrIrq_f* irqFctStr;
+	PsiMsDaqn_BatchIrq_f* irqFctBatch;
+	PsiMsDaq_BatchConfig_t batchCfg;
+	PsiMsDaq_WinMeta_t* batch;
+	uint32_t batchCnt;
+	uint64_t batchSince;
+	PsiMsDaq_HistoryEntry_t* history;
+	uint32_t historySize;
+	atomic_uint_least64_t historyWr;
 	void* irqArg;
 	PsiMsDaq_IpHandle ipHandle;
 	uint32_t bufStart;
 	uint32_t winSize;
 	uint32_t postTrig;
+	PsiMsDaq_AutoRearmConfig_t rearmCfg;
+	atomic_bool rearmPending;
+	uint8_t rearmLastWin;
+	atomic_uint_fast32_t rearmTrigCnt;
+	atomic_uint_fast32_t rearmCnt;
+	atomic_uint_fast32_t rearmDeferredCnt;
+	atomic_uint_fast32_t rearmMissedTrigs;
+	PsiMsDaq_AtomicCnt_t rearmLastDeadTime;
+	PsiMsDaq_AtomicCnt_t rearmMaxDeadTime;
+	PsiMsDaq_AtomicCnt_t rearmTotalDeadTime;
+	PsiMsDaq_AtomicCnt_t metWindows;
+	PsiMsDaq_AtomicCnt_t metBytes;
+	PsiMsDaq_AtomicCnt_t metSpurious;
+	PsiMsDaq_AtomicCnt_t metSkipped;
+	atomic_uint_fast32_t metLatencyHist[PSI_MS_DAQ_HIST_BINS];
+	PsiMsDaq_AtomicCnt_t metLatencySum;
 }PsiMsDaq_StrInst_t;
 
+typedef struct {
+	uint32_t addr;
+	uint32_t bytes;
+} DataSpan_t;
+
+typedef union {
+	int64_t s;
+	uint64_t u;
+} DecimAcc_t;
+
+typedef struct {
+	PsiMsDaq_DecimMode_t mode;
+	uint32_t ratio;
+	void* out_p;
+	uint32_t outIdx;
+	uint32_t binCnt;
+	DecimAcc_t sum;
+	DecimAcc_t min;
+	DecimAcc_t max;
+} DecimState_t;
+
+typedef struct {
+	uint32_t stride;			//Channel values per sample (including unused ones)
+	uint8_t channels;
+	void* const* out_p;
+} DeintState_t;
+
+typedef struct {
+	int64_t threshold;
+	bool prevAbove;
+	uint32_t samples;
+	double sum;
+	double sumSq;
+	int64_t min;
+	int64_t max;
+	uint32_t minIdx;
+	uint32_t maxIdx;
+	uint32_t crossings;
+} StatsState_t;
+
 
 typedef struct {
 	uint32_t baseAddr;
@@ -36,6 +120,13 @@ typedef struct {
 	PsiMsDaq_DataCopy_f* memcpyFct;
 	PsiMsDaq_RegWrite_f* regWrFct;
 	PsiMsDaq_RegRead_f* regRdFct;
+	PsiMsDaq_RegReadBlock_f* regRdBlkFct;
+	PsiMsDaq_AddrTranslate_f* addrFct;
+	PsiMsDaq_TimeSource_f* timeFct;
+	void* timeArg;
+	PsiMsDaq_AtomicCnt_t metIrqs;
+	atomic_uint_fast32_t metIrqDurationHist[PSI_MS_DAQ_HIST_BINS];
+	PsiMsDaq_AtomicCnt_t metIrqDurationSum;
 } PsiMsDaq_Inst_t;
 
 //*******************************************************************************
@@ -65,6 +156,34 @@ uint32_t PsiMsDaq_RegRead_Standard(const uint32_t addr)
 	return *addr_p;
 }
 
+void PsiMsDaq_RegReadBlock_Standard(const uint32_t addr, uint32_t* const values_p, const uint32_t count)
+{
+	volatile uint32_t* addr_p = (volatile uint32_t *)(size_t)addr;
+	for (uint32_t i = 0; i < count; i++) {
+		values_p[i] = addr_p[i];
+	}
+}
+
+void HistAdd(	atomic_uint_fast32_t* const hist_p,
+				PsiMsDaq_AtomicCnt_t* const sum_p,
+				const uint64_t value)
+{
+	uint32_t bin = 0;
+	while ((bin < PSI_MS_DAQ_HIST_BINS-1) && ((value >> bin) != 0)) {
+		bin++;
+	}
+	atomic_fetch_add_explicit(&hist_p[bin], 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(sum_p, (PsiMsDaq_Cnt_t)value, memory_order_relaxed);
+}
+
+void HistGet(	atomic_uint_fast32_t* const hist_p,
+				uint32_t* const bins_p)
+{
+	for (int i = 0; i < PSI_MS_DAQ_HIST_BINS; i++) {
+		bins_p[i] = (uint32_t)atomic_load_explicit(&hist_p[i], memory_order_relaxed);
+	}
+}
+
 PsiMsDaq_RetCode_t CheckStrDisabled(	PsiMsDaq_IpHandle ipHandle,
 										const uint8_t streamNr)
 {
@@ -96,6 +215,574 @@ PsiMsDaq_RetCode_t CheckWinNr(	PsiMsDaq_StrHandle strHandle,
 	return PsiMsDaq_RetCode_Success;
 }
 
+PsiMsDaq_RetCode_t CheckStrMask(	PsiMsDaq_IpHandle ipHandle,
+									const uint32_t strMask)
+{
+	PsiMsDaq_Inst_t* inst_p = (PsiMsDaq_Inst_t*) ipHandle;
+	if ((inst_p->maxStreams < 32) && (0 != (strMask >> inst_p->maxStreams))) {
+		return PsiMsDaq_RetCode_IllegalStrNr;
+	}
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RecMode_t GetRecMode(	PsiMsDaq_StrInst_t* const inst_p)
+{
+	const uint32_t mode = (uint32_t)atomic_load_explicit(&inst_p->modeShadow, memory_order_relaxed);
+	return (PsiMsDaq_RecMode_t)((mode >> PSI_MS_DAQ_REG_MODE_LSB_RECM) & ((1 << (PSI_MS_DAQ_REG_MODE_MSB_RECM+1))-1));
+}
+
+PsiMsDaq_RetCode_t WriteArm(	PsiMsDaq_StrInst_t* const inst_p)
+{
+	//The ARM bit is a pulse, so the mode register is written from the shadow of its configuration bits instead of
+	//a read-modify-write. The shadow is updated by every write to the MODE register (see PsiMsDaq_RegWrite()).
+	const uint32_t mode = (uint32_t)atomic_load_explicit(&inst_p->modeShadow, memory_order_relaxed);
+	SAFE_CALL(PsiMsDaq_RegWrite(inst_p->ipHandle,
+								PSI_MS_DAQ_REG_MODE(inst_p->nr),
+								mode | PSI_MS_DAQ_REG_MODE_BIT_ARM));
+	return PsiMsDaq_RetCode_Success;
+}
+
+void ReadWinMeta(	PsiMsDaq_StrInst_t* const inst_p,
+					const uint8_t win,
+					PsiMsDaq_WinMeta_t* const meta_p)
+{
+	PsiMsDaq_Inst_t* ip_p = (PsiMsDaq_Inst_t*) inst_p->ipHandle;
+	//Read all window registers in one block access
+	uint32_t regs[4];
+	PsiMsDaq_RegReadBlock(inst_p->ipHandle, PSI_MS_DAQ_WIN_WINCNT(inst_p->nr, win, ip_p->strAddrOffs), regs, 4);
+	meta_p->winInfo.ipHandle = inst_p->ipHandle;
+	meta_p->winInfo.strHandle = (PsiMsDaq_StrHandle) inst_p;
+	meta_p->winInfo.winNr = win;
+	meta_p->samples = regs[0] & ~PSI_MS_DAQ_WIN_WINCNT_BIT_ISTRIG;
+	meta_p->isTrig = (0 != (regs[0] & PSI_MS_DAQ_WIN_WINCNT_BIT_ISTRIG));
+	meta_p->lastSplAddr = regs[1];
+	meta_p->timestamp = (((uint64_t)regs[3]) << 32) + regs[2];
+}
+
+void RecordHistory(	PsiMsDaq_StrInst_t* const inst_p,
+					const PsiMsDaq_WinMeta_t* const meta_p)
+{
+	//Only windows with trigger have a timestamp
+	if ((0 == inst_p->historySize) || (!meta_p->isTrig)) {
+		return;
+	}
+	const uint64_t wr = atomic_load_explicit(&inst_p->historyWr, memory_order_relaxed);
+	PsiMsDaq_HistoryEntry_t* const entry_p = &inst_p->history[wr % inst_p->historySize];
+	entry_p->timestamp = meta_p->timestamp;
+	entry_p->samples = meta_p->samples;
+	entry_p->lastSplAddr = meta_p->lastSplAddr;
+	entry_p->strNr = inst_p->nr;
+	entry_p->winNr = meta_p->winInfo.winNr;
+	atomic_store_explicit(&inst_p->historyWr, wr+1, memory_order_release);
+}
+
+//First index of the history not overwritten (the entry at wr-size is being overwritten while RecordHistory() writes wr)
+uint64_t HistoryOldest(	PsiMsDaq_StrInst_t* const inst_p,
+						const uint64_t wr)
+{
+	return (wr >= inst_p->historySize) ? wr - inst_p->historySize + 1 : 0;
+}
+
+//Index of the first history entry not older than tsFrom (binary search, entries are in trigger order)
+uint64_t HistorySearch(	PsiMsDaq_StrInst_t* const inst_p,
+						const uint64_t wr,
+						const uint64_t tsFrom)
+{
+	uint64_t lo = HistoryOldest(inst_p, wr);
+	uint64_t hi = wr;
+	while (lo < hi) {
+		const uint64_t mid = lo + (hi - lo)/2;
+		if (inst_p->history[mid % inst_p->historySize].timestamp < tsFrom) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+void CollectBatch(	PsiMsDaq_StrInst_t* const inst_p)
+{
+	PsiMsDaq_Inst_t* ip_p = (PsiMsDaq_Inst_t*) inst_p->ipHandle;
+	const PsiMsDaq_StrHandle strHandle = (PsiMsDaq_StrHandle) inst_p;
+	int8_t win = inst_p->lastProcWin;
+	uint8_t lastWin;
+	uint32_t added = 0;
+	bool busy = false;
+	//The last written window is only re-read after all windows known to be ready are collected
+	for (bool first = true; !busy; first = false) {
+		//Clear stream IRQ before reading the last window, so windows arriving later fire a new IRQ
+		PsiMsDaq_RegWrite(inst_p->ipHandle, PSI_MS_DAQ_REG_IRQVEC, (1 << inst_p->nr));
+		PsiMsDaq_Str_GetLastWrittenWin(strHandle, &lastWin);
+		if ((!first) && (win == lastWin)) {
+			break;
+		}
+		do {
+			win = (win + 1) % inst_p->windows;
+			//Stop if this window was not yet marked as free by the user
+			if (atomic_load(&inst_p->irqCalledWin) & (1 << win)) {
+				if (inst_p->lastProcWin != lastWin) {
+					atomic_fetch_add_explicit(&inst_p->metSkipped, 1, memory_order_relaxed);
+				}
+				else if (0 == added) {
+					atomic_fetch_add_explicit(&inst_p->metSpurious, 1, memory_order_relaxed);
+				}
+				busy = true;
+				break;
+			}
+			atomic_fetch_or(&inst_p->irqCalledWin, (1 << win));
+			PsiMsDaq_WinMeta_t* const meta_p = &inst_p->batch[inst_p->batchCnt];
+			ReadWinMeta(inst_p, win, meta_p);
+			RecordHistory(inst_p, meta_p);
+			if (0 == inst_p->batchCnt) {
+				inst_p->batchSince = (NULL != ip_p->timeFct) ? ip_p->timeFct(ip_p->timeArg) : 0;
+			}
+			if ((NULL != ip_p->timeFct) && meta_p->isTrig) {
+				HistAdd(inst_p->metLatencyHist, &inst_p->metLatencySum, ip_p->timeFct(ip_p->timeArg) - meta_p->timestamp);
+			}
+			atomic_fetch_add_explicit(&inst_p->metWindows, 1, memory_order_relaxed);
+			inst_p->batchCnt++;
+			added++;
+			//Update State
+			inst_p->lastProcWin = win;
+		} while (win != lastWin);
+	}
+}
+
+void DispatchBatch(	PsiMsDaq_StrInst_t* const inst_p,
+					const bool force)
+{
+	PsiMsDaq_Inst_t* ip_p = (PsiMsDaq_Inst_t*) inst_p->ipHandle;
+	const PsiMsDaq_BatchConfig_t* const cfg_p = &inst_p->batchCfg;
+	//Check if the batch is due (never wait for more windows than the stream has)
+	if (0 == inst_p->batchCnt) {
+		return;
+	}
+	const uint32_t minWindows = (cfg_p->minWindows < inst_p->windows) ? cfg_p->minWindows : inst_p->windows;
+	bool due = force || (inst_p->batchCnt >= minWindows);
+	if ((!due) && (0 != cfg_p->maxDelay) && (NULL != ip_p->timeFct)) {
+		due = (ip_p->timeFct(ip_p->timeArg) - inst_p->batchSince >= cfg_p->maxDelay);
+	}
+	if (!due) {
+		return;
+	}
+	//Pass windows to the user
+	const uint32_t maxWindows = (0 == cfg_p->maxWindows) ? inst_p->batchCnt : cfg_p->maxWindows;
+	for (uint32_t i = 0; i < inst_p->batchCnt; i += maxWindows) {
+		const uint32_t left = inst_p->batchCnt - i;
+		inst_p->irqFctBatch(&inst_p->batch[i], (left < maxWindows) ? left : maxWindows, inst_p->irqArg);
+	}
+	inst_p->batchCnt = 0;
+}
+
+bool IsNextWinFree(	PsiMsDaq_StrInst_t* const inst_p,
+					const uint8_t lastWin)
+{
+	PsiMsDaq_Inst_t* ip_p = (PsiMsDaq_Inst_t*) inst_p->ipHandle;
+	uint32_t winCnt;
+	const uint8_t nextWin = (lastWin + 1) % inst_p->windows;
+	PsiMsDaq_RegRead(inst_p->ipHandle, PSI_MS_DAQ_WIN_WINCNT(inst_p->nr, nextWin, ip_p->strAddrOffs), &winCnt);
+	return 0 == winCnt;
+}
+
+void Rearm(	PsiMsDaq_StrInst_t* const inst_p,
+			const uint8_t lastWin)
+{
+	WriteArm(inst_p);
+	//Statistics (after arming to not add to the dead time). Rearm() may run on the IRQ thread and on a thread freeing
+	//windows (deferred re-arm) at the same time, so all statistics are atomic.
+	atomic_fetch_add_explicit(&inst_p->rearmCnt, 1, memory_order_relaxed);
+	if (NULL != inst_p->rearmCfg.timeFct) {
+		//The timestamp registers are read directly, the window may already be freed for deferred re-arms
+		PsiMsDaq_Inst_t* ip_p = (PsiMsDaq_Inst_t*) inst_p->ipHandle;
+		uint32_t tsLo;
+		uint32_t tsHi;
+		PsiMsDaq_RegRead(inst_p->ipHandle, PSI_MS_DAQ_WIN_TSLO(inst_p->nr, lastWin, ip_p->strAddrOffs), &tsLo);
+		PsiMsDaq_RegRead(inst_p->ipHandle, PSI_MS_DAQ_WIN_TSHI(inst_p->nr, lastWin, ip_p->strAddrOffs), &tsHi);
+		const uint64_t trigTs = (((uint64_t)tsHi) << 32) + tsLo;
+		const uint64_t deadTime = inst_p->rearmCfg.timeFct(inst_p->rearmCfg.arg) - trigTs;
+		atomic_store_explicit(&inst_p->rearmLastDeadTime, (PsiMsDaq_Cnt_t)deadTime, memory_order_relaxed);
+		atomic_fetch_add_explicit(&inst_p->rearmTotalDeadTime, (PsiMsDaq_Cnt_t)deadTime, memory_order_relaxed);
+		PsiMsDaq_Cnt_t maxDeadTime = atomic_load_explicit(&inst_p->rearmMaxDeadTime, memory_order_relaxed);
+		while ((deadTime > maxDeadTime) &&
+			   (!atomic_compare_exchange_weak_explicit(&inst_p->rearmMaxDeadTime, &maxDeadTime, (PsiMsDaq_Cnt_t)deadTime,
+													   memory_order_relaxed, memory_order_relaxed))) {}
+	}
+	if (NULL != inst_p->rearmCfg.trigCntFct) {
+		//All triggers since the last arm except the one captured were missed
+		const uint32_t trigCnt = inst_p->rearmCfg.trigCntFct(inst_p->rearmCfg.arg);
+		const uint32_t triggers = trigCnt - (uint32_t)atomic_exchange(&inst_p->rearmTrigCnt, trigCnt);
+		if (triggers > 1) {
+			atomic_fetch_add_explicit(&inst_p->rearmMissedTrigs, triggers - 1, memory_order_relaxed);
+		}
+	}
+}
+
+void HandleAutoRearm(	PsiMsDaq_StrInst_t* const inst_p)
+{
+	//Only required for modes that disarm after a trigger
+	if ((!inst_p->rearmCfg.enable) ||
+		((PsiMsDaqn_RecMode_SingleShot != GetRecMode(inst_p)) && (PsiMsDaqn_RecMode_TriggerMask != GetRecMode(inst_p)))) {
+		return;
+	}
+	//Nothing to do if the recorder is still armed (or a deferred re-arm is already pending)
+	bool isArmed;
+	PsiMsDaq_RegGetBit(inst_p->ipHandle, PSI_MS_DAQ_REG_MODE(inst_p->nr), PSI_MS_DAQ_REG_MODE_BIT_ARM, &isArmed);
+	if (isArmed || atomic_load(&inst_p->rearmPending)) {
+		return;
+	}
+	//Re-arm or defer until the next window is freed. Check again after setting the pending flag, since the window may
+	//have been freed in between. The last written window does not change while the recorder is disarmed.
+	uint8_t lastWin;
+	PsiMsDaq_Str_GetLastWrittenWin((PsiMsDaq_StrHandle) inst_p, &lastWin);
+	if (IsNextWinFree(inst_p, lastWin)) {
+		Rearm(inst_p, lastWin);
+		return;
+	}
+	atomic_fetch_add_explicit(&inst_p->rearmDeferredCnt, 1, memory_order_relaxed);
+	inst_p->rearmLastWin = lastWin;
+	atomic_store(&inst_p->rearmPending, true);
+	if (IsNextWinFree(inst_p, lastWin) && atomic_exchange(&inst_p->rearmPending, false)) {
+		Rearm(inst_p, lastWin);
+	}
+}
+
+void HandleDeferredRearm(	PsiMsDaq_StrInst_t* const inst_p)
+{
+	if (atomic_load(&inst_p->rearmPending) && IsNextWinFree(inst_p, inst_p->rearmLastWin) &&
+		atomic_exchange(&inst_p->rearmPending, false)) {
+		Rearm(inst_p, inst_p->rearmLastWin);
+	}
+}
+
+PsiMsDaq_RetCode_t GetDataSpans(	PsiMsDaq_WinInfo_t winInfo,
+									const uint32_t preTrigSamples,
+									const uint32_t postTrigSamples,
+									DataSpan_t* const spans_p)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* str_p = (PsiMsDaq_StrInst_t*) winInfo.strHandle;
+
+	//Setup
+	const uint32_t samples = preTrigSamples+postTrigSamples;
+	const uint32_t bytes = samples*str_p->widthBytes;
+	uint32_t preTrig;
+	SAFE_CALL(PsiMsDaq_StrWin_GetPreTrigSamples(winInfo, &preTrig));
+
+	//Checks
+	if (postTrigSamples > str_p->postTrig) {
+		return PsiMsDaq_RetCode_MorePostTrigThanConfigured;
+	}
+	if (preTrigSamples > preTrig) {
+		return PsiMsDaq_RetCode_MorePreTrigThanAvailable;
+	}
+
+	//Calculate window addresses
+	const uint32_t winStart = str_p->bufStart + str_p->winSize*winInfo.winNr;
+	const uint32_t winLast = winStart + str_p->winSize - 1;
+
+	//Calculate address of last byte and trigger byte (with regard to wrapping)
+	uint32_t lastSplAddr;
+	SAFE_CALL(PsiMsDaq_StrWin_GetLastSplAddr(winInfo, &lastSplAddr));
+	uint32_t trigByteAddr = lastSplAddr - str_p->postTrig*str_p->widthBytes;
+	if (trigByteAddr < winStart) {
+		trigByteAddr += str_p->winSize;
+	}
+	uint32_t lastByteAddr = trigByteAddr + postTrigSamples*str_p->widthBytes + str_p->widthBytes-1;
+	if (lastByteAddr > winLast) {
+		lastByteAddr -= str_p->winSize;
+	}
+
+	//If all bytes are written without wrap, there is only one span
+	const int64_t firstByteLinear = (int64_t)lastByteAddr - bytes + 1;
+	if (firstByteLinear >= winStart) {
+		spans_p[0].addr = (uint32_t)firstByteLinear;
+		spans_p[0].bytes = bytes;
+		spans_p[1].addr = winStart;
+		spans_p[1].bytes = 0;
+	}
+	//Split at the wrap otherwise
+	else {
+		const uint32_t secondChunkSize = lastByteAddr - winStart + 1;
+		const uint32_t firstChunkSize = bytes-secondChunkSize;
+		spans_p[0].addr = winLast-firstChunkSize+1;
+		spans_p[0].bytes = firstChunkSize;
+		spans_p[1].addr = winStart;
+		spans_p[1].bytes = secondChunkSize;
+	}
+	return PsiMsDaq_RetCode_Success;
+}
+
+//Decimation kernels, one per sample type. The inner loops run over contiguous samples of one bin,
+//so they are auto-vectorized by the compiler.
+#define DECIM_CHUNK_FCT(name, T, ACC_T, fld) \
+void name(const void* data_p, const uint32_t samples, const uint32_t firstSpl, void* arg_p) \
+{ \
+	DecimState_t* s = (DecimState_t*) arg_p; \
+	const T* in = (const T*) data_p; \
+	T* out = (T*) s->out_p; \
+	(void)firstSpl; \
+	uint32_t i = 0; \
+	do { \
+		uint32_t take = s->ratio - s->binCnt; \
+		if (take > samples-i) { \
+			take = samples-i; \
+		} \
+		const T* bin = &in[i]; \
+		if (take > 0) { \
+			if (PsiMsDaq_DecimMode_Average == s->mode) { \
+				ACC_T sum = 0; \
+				for (uint32_t k = 0; k < take; k++) { \
+					sum += bin[k]; \
+				} \
+				s->sum.fld = (0 == s->binCnt) ? sum : s->sum.fld + sum; \
+			} \
+			else if (PsiMsDaq_DecimMode_MinMax == s->mode) { \
+				T mn = bin[0]; \
+				T mx = bin[0]; \
+				for (uint32_t k = 1; k < take; k++) { \
+					mn = (bin[k] < mn) ? bin[k] : mn; \
+					mx = (bin[k] > mx) ? bin[k] : mx; \
+				} \
+				if ((0 == s->binCnt) || (mn < (T)s->min.fld)) { \
+					s->min.fld = mn; \
+				} \
+				if ((0 == s->binCnt) || (mx > (T)s->max.fld)) { \
+					s->max.fld = mx; \
+				} \
+			} \
+			else if (0 == s->binCnt) { \
+				s->min.fld = bin[0]; \
+			} \
+		} \
+		s->binCnt += take; \
+		i += take; \
+		if (s->binCnt == s->ratio) { \
+			switch (s->mode) { \
+				case PsiMsDaq_DecimMode_Average: \
+					out[s->outIdx++] = (T)(s->sum.fld/(ACC_T)s->ratio); \
+					break; \
+				case PsiMsDaq_DecimMode_MinMax: \
+					out[s->outIdx++] = (T)s->min.fld; \
+					out[s->outIdx++] = (T)s->max.fld; \
+					break; \
+				default: \
+					out[s->outIdx++] = (T)s->min.fld; \
+					break; \
+			} \
+			s->binCnt = 0; \
+		} \
+	} while (i < samples); \
+}
+
+DECIM_CHUNK_FCT(DecimChunk_U8, uint8_t, uint64_t, u)
+DECIM_CHUNK_FCT(DecimChunk_S8, int8_t, int64_t, s)
+DECIM_CHUNK_FCT(DecimChunk_U16, uint16_t, uint64_t, u)
+DECIM_CHUNK_FCT(DecimChunk_S16, int16_t, int64_t, s)
+DECIM_CHUNK_FCT(DecimChunk_U32, uint32_t, uint64_t, u)
+DECIM_CHUNK_FCT(DecimChunk_S32, int32_t, int64_t, s)
+DECIM_CHUNK_FCT(DecimChunk_U64, uint64_t, uint64_t, u)
+DECIM_CHUNK_FCT(DecimChunk_S64, int64_t, int64_t, s)
+
+//Deinterleaving of 4 x 16-bit channels with vector shuffles, 8 samples per iteration. Returns the number of
+//samples processed (the rest is processed by the scalar kernel).
+#if defined(__SSE2__) || defined(__ARM_NEON)
+static uint32_t Deint4x16(const uint16_t* in, const uint32_t samples, const uint32_t firstSpl, void* const* out_p,
+						  const bool isSigned, const bool toFloat)
+{
+	uint32_t k = 0;
+	for (; k+8 <= samples; k += 8) {
+		#if defined(__SSE2__)
+			//Two rounds of 16-bit unpacking transpose the 4x8 block, 64-bit unpacking combines the halves
+			const __m128i a = _mm_loadu_si128((const __m128i*)&in[4*k]);
+			const __m128i b = _mm_loadu_si128((const __m128i*)&in[4*k+8]);
+			const __m128i c = _mm_loadu_si128((const __m128i*)&in[4*k+16]);
+			const __m128i d = _mm_loadu_si128((const __m128i*)&in[4*k+24]);
+			const __m128i t0 = _mm_unpacklo_epi16(a, b);
+			const __m128i t1 = _mm_unpackhi_epi16(a, b);
+			const __m128i t2 = _mm_unpacklo_epi16(c, d);
+			const __m128i t3 = _mm_unpackhi_epi16(c, d);
+			const __m128i u0 = _mm_unpacklo_epi16(t0, t1);
+			const __m128i u1 = _mm_unpackhi_epi16(t0, t1);
+			const __m128i u2 = _mm_unpacklo_epi16(t2, t3);
+			const __m128i u3 = _mm_unpackhi_epi16(t2, t3);
+			const __m128i ch[4] = {	_mm_unpacklo_epi64(u0, u2), _mm_unpackhi_epi64(u0, u2),
+									_mm_unpacklo_epi64(u1, u3), _mm_unpackhi_epi64(u1, u3)};
+			for (int c = 0; c < 4; c++) {
+				if (NULL == out_p[c]) {
+					continue;
+				}
+				if (!toFloat) {
+					_mm_storeu_si128((__m128i*)((uint16_t*)out_p[c]+firstSpl+k), ch[c]);
+				}
+				else {
+					const __m128i lo = isSigned ? _mm_srai_epi32(_mm_unpacklo_epi16(ch[c], ch[c]), 16) : _mm_unpacklo_epi16(ch[c], _mm_setzero_si128());
+					const __m128i hi = isSigned ? _mm_srai_epi32(_mm_unpackhi_epi16(ch[c], ch[c]), 16) : _mm_unpackhi_epi16(ch[c], _mm_setzero_si128());
+					float* const o = (float*)out_p[c]+firstSpl+k;
+					_mm_storeu_ps(o, _mm_cvtepi32_ps(lo));
+					_mm_storeu_ps(o+4, _mm_cvtepi32_ps(hi));
+				}
+			}
+		#else
+			//NEON loads and deinterleaves in one instruction
+			const uint16x8x4_t v = vld4q_u16(&in[4*k]);
+			for (int c = 0; c < 4; c++) {
+				if (NULL == out_p[c]) {
+					continue;
+				}
+				if (!toFloat) {
+					vst1q_u16((uint16_t*)out_p[c]+firstSpl+k, v.val[c]);
+				}
+				else {
+					float* const o = (float*)out_p[c]+firstSpl+k;
+					if (isSigned) {
+						const int16x8_t sv = vreinterpretq_s16_u16(v.val[c]);
+						vst1q_f32(o, vcvtq_f32_s32(vmovl_s16(vget_low_s16(sv))));
+						vst1q_f32(o+4, vcvtq_f32_s32(vmovl_s16(vget_high_s16(sv))));
+					}
+					else {
+						vst1q_f32(o, vcvtq_f32_u32(vmovl_u16(vget_low_u16(v.val[c]))));
+						vst1q_f32(o+4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(v.val[c]))));
+					}
+				}
+			}
+		#endif
+	}
+	return k;
+}
+#define DEINT_4X16(in, samples, firstSpl, out_p, isSigned, toFloat)	Deint4x16((const uint16_t*)(in), samples, firstSpl, out_p, isSigned, toFloat)
+#else
+#define DEINT_4X16(in, samples, firstSpl, out_p, isSigned, toFloat)	0
+#endif
+
+//Deinterleaving kernels, one per channel type and output type. The data is processed channel by channel,
+//so every output buffer is written sequentially.
+#define DEINT_CHUNK_FCT(name, T, OUT_T, SIMD_CALL) \
+void name(const void* data_p, const uint32_t samples, const uint32_t firstSpl, void* arg_p) \
+{ \
+	DeintState_t* s = (DeintState_t*) arg_p; \
+	const T* in = (const T*) data_p; \
+	uint32_t done = 0; \
+	if ((4 == s->stride) && (4 == s->channels)) { \
+		done = SIMD_CALL; \
+	} \
+	for (uint8_t c = 0; c < s->channels; c++) { \
+		if (NULL == s->out_p[c]) { \
+			continue; \
+		} \
+		OUT_T* const out = (OUT_T*)s->out_p[c]+firstSpl; \
+		for (uint32_t k = done; k < samples; k++) { \
+			out[k] = (OUT_T)in[k*s->stride+c]; \
+		} \
+	} \
+}
+
+DEINT_CHUNK_FCT(DeintChunk_U8, uint8_t, uint8_t, 0)
+DEINT_CHUNK_FCT(DeintChunk_S8, int8_t, int8_t, 0)
+DEINT_CHUNK_FCT(DeintChunk_U16, uint16_t, uint16_t, DEINT_4X16(data_p, samples, firstSpl, s->out_p, false, false))
+DEINT_CHUNK_FCT(DeintChunk_S16, int16_t, int16_t, DEINT_4X16(data_p, samples, firstSpl, s->out_p, true, false))
+DEINT_CHUNK_FCT(DeintChunk_U32, uint32_t, uint32_t, 0)
+DEINT_CHUNK_FCT(DeintChunk_S32, int32_t, int32_t, 0)
+DEINT_CHUNK_FCT(DeintChunk_U8_F, uint8_t, float, 0)
+DEINT_CHUNK_FCT(DeintChunk_S8_F, int8_t, float, 0)
+DEINT_CHUNK_FCT(DeintChunk_U16_F, uint16_t, float, DEINT_4X16(data_p, samples, firstSpl, s->out_p, false, true))
+DEINT_CHUNK_FCT(DeintChunk_S16_F, int16_t, float, DEINT_4X16(data_p, samples, firstSpl, s->out_p, true, true))
+DEINT_CHUNK_FCT(DeintChunk_U32_F, uint32_t, float, 0)
+DEINT_CHUNK_FCT(DeintChunk_S32_F, int32_t, float, 0)
+
+//Statistics kernels, one per sample type. Reductions run over the chunk that was just copied (still in cache)
+//and are auto-vectorized. Positions of extrema are only searched for if a chunk contains a new extremum.
+#define STATS_CHUNK_FCT(name, T, SUM_T, SQ_T) \
+void name(const void* data_p, const uint32_t samples, const uint32_t firstSpl, void* arg_p) \
+{ \
+	StatsState_t* s = (StatsState_t*) arg_p; \
+	const T* in = (const T*) data_p; \
+	const T thr = (T)s->threshold; \
+	if (0 == samples) { \
+		return; \
+	} \
+	SUM_T sum = 0; \
+	SQ_T sumSq = 0; \
+	T mn = in[0]; \
+	T mx = in[0]; \
+	for (uint32_t k = 0; k < samples; k++) { \
+		sum += in[k]; \
+		sumSq += (SQ_T)in[k]*(SQ_T)in[k]; \
+		mn = (in[k] < mn) ? in[k] : mn; \
+		mx = (in[k] > mx) ? in[k] : mx; \
+	} \
+	uint32_t crossings = 0; \
+	for (uint32_t k = 1; k < samples; k++) { \
+		crossings += ((in[k] >= thr) != (in[k-1] >= thr)); \
+	} \
+	if ((0 != s->samples) && ((in[0] >= thr) != s->prevAbove)) { \
+		crossings++; \
+	} \
+	s->prevAbove = (in[samples-1] >= thr); \
+	if ((0 == s->samples) || (mn < (T)s->min)) { \
+		uint32_t k = 0; \
+		while (in[k] != mn) { \
+			k++; \
+		} \
+		s->min = (int64_t)mn; \
+		s->minIdx = firstSpl+k; \
+	} \
+	if ((0 == s->samples) || (mx > (T)s->max)) { \
+		uint32_t k = 0; \
+		while (in[k] != mx) { \
+			k++; \
+		} \
+		s->max = (int64_t)mx; \
+		s->maxIdx = firstSpl+k; \
+	} \
+	s->sum += (double)sum; \
+	s->sumSq += (double)sumSq; \
+	s->crossings += crossings; \
+	s->samples += samples; \
+}
+
+STATS_CHUNK_FCT(StatsChunk_U8, uint8_t, uint64_t, uint64_t)
+STATS_CHUNK_FCT(StatsChunk_S8, int8_t, int64_t, uint64_t)
+STATS_CHUNK_FCT(StatsChunk_U16, uint16_t, uint64_t, uint64_t)
+STATS_CHUNK_FCT(StatsChunk_S16, int16_t, int64_t, uint64_t)
+STATS_CHUNK_FCT(StatsChunk_U32, uint32_t, uint64_t, double)
+STATS_CHUNK_FCT(StatsChunk_S32, int32_t, int64_t, double)
+STATS_CHUNK_FCT(StatsChunk_U64, uint64_t, double, double)
+STATS_CHUNK_FCT(StatsChunk_S64, int64_t, double, double)
+
+void StatsStart(	StatsState_t* const state_p,
+					const PsiMsDaq_StrInst_t* const str_p)
+{
+	state_p->threshold = str_p->statsThreshold;
+	state_p->prevAbove = false;
+	state_p->samples = 0;
+	state_p->sum = 0;
+	state_p->sumSq = 0;
+	state_p->min = 0;
+	state_p->max = 0;
+	state_p->minIdx = 0;
+	state_p->maxIdx = 0;
+	state_p->crossings = 0;
+}
+
+void StatsFinish(	const StatsState_t* const state_p,
+					PsiMsDaq_StrInst_t* const str_p,
+					const uint8_t winNr)
+{
+	PsiMsDaq_WinStats_t* stats_p = &str_p->winStats[winNr];
+	const double n = (0 == state_p->samples) ? 1 : state_p->samples;
+	stats_p->samples = state_p->samples;
+	stats_p->mean = state_p->sum/n;
+	stats_p->rms = sqrt(state_p->sumSq/n);
+	stats_p->min = state_p->min;
+	stats_p->max = state_p->max;
+	stats_p->minIdx = state_p->minIdx;
+	stats_p->maxIdx = state_p->maxIdx;
+	stats_p->thresholdCrossings = state_p->crossings;
+	atomic_fetch_or(&str_p->statsValid, (1 << winNr));
+}
+
 uint32_t Log2(const uint32_t x)
 {
 	uint32_t v = x;
@@ -124,6 +811,18 @@ uint32_t Pow(const uint32_t x, const uint32_t y)
 	return r;
 }
 
+//Free an instance whose initialization failed (stream buffers not allocated yet are NULL)
+void FreeInst(PsiMsDaq_Inst_t* const inst_p)
+{
+	for (int str = 0; str < inst_p->maxStreams; str++) {
+		free(inst_p->streams[str].winRefCnt);
+		free(inst_p->streams[str].winStats);
+		free(inst_p->streams[str].batch);
+	}
+	free(inst_p->streams);
+	free(inst_p);
+}
+
 
 
 //*******************************************************************************
@@ -136,21 +835,49 @@ PsiMsDaq_IpHandle PsiMsDaq_Init(	const uint32_t baseAddr,
 {
 	//Initialization and allocation
 	PsiMsDaq_Inst_t* inst_p = (PsiMsDaq_Inst_t*) malloc(sizeof(PsiMsDaq_Inst_t));
+	if (NULL == inst_p) {
+		return NULL;
+	}
 	inst_p->baseAddr = baseAddr;
-	inst_p->streams = (PsiMsDaq_StrInst_t*) malloc(sizeof(PsiMsDaq_StrInst_t)*maxStreams);
+	inst_p->streams = (PsiMsDaq_StrInst_t*) calloc(maxStreams, sizeof(PsiMsDaq_StrInst_t));
+	if (NULL == inst_p->streams) {
+		free(inst_p);
+		return NULL;
+	}
 	inst_p->maxWindows = maxWindows;
 	inst_p->maxStreams = maxStreams;
+	for (int str = 0; str < maxStreams; str++) {
+		inst_p->streams[str].winRefCnt = (atomic_uint_fast16_t*) malloc(sizeof(atomic_uint_fast16_t)*maxWindows);
+		inst_p->streams[str].winStats = (PsiMsDaq_WinStats_t*) malloc(sizeof(PsiMsDaq_WinStats_t)*maxWindows);
+		inst_p->streams[str].batch = (PsiMsDaq_WinMeta_t*) malloc(sizeof(PsiMsDaq_WinMeta_t)*maxWindows);
+		if ((NULL == inst_p->streams[str].winRefCnt) || (NULL == inst_p->streams[str].winStats) ||
+			(NULL == inst_p->streams[str].batch)) {
+			FreeInst(inst_p);
+			return NULL;
+		}
+	}
 	inst_p->strAddrOffs = Pow(2, Log2Ceil(maxWindows))*0x10;
+	inst_p->timeFct = NULL;
+	inst_p->timeArg = NULL;
+	atomic_init(&inst_p->metIrqs, 0);
+	atomic_init(&inst_p->metIrqDurationSum, 0);
+	for (int i = 0; i < PSI_MS_DAQ_HIST_BINS; i++) {
+		atomic_init(&inst_p->metIrqDurationHist[i], 0);
+	}
 	//Standard access functions
 	if (NULL == accessFct_p) {
 		inst_p->memcpyFct = PsiMsDaq_DataCopy_Standard;
 		inst_p->regWrFct = PsiMsDaq_RegWrite_Standard;
 		inst_p->regRdFct = PsiMsDaq_RegRead_Standard;
+		inst_p->regRdBlkFct = PsiMsDaq_RegReadBlock_Standard;
+		inst_p->addrFct = NULL;
 	}
 	else {
 		inst_p->memcpyFct = accessFct_p->dataCopy;
 		inst_p->regWrFct = accessFct_p->regWrite;
 		inst_p->regRdFct = accessFct_p->regRead;
+		inst_p->regRdBlkFct = NULL;
+		inst_p->addrFct = NULL;
 	}
 	//Disable complete IP (all streams, IRQs, etc.)
 	PsiMsDaq_RegWrite(inst_p, PSI_MS_DAQ_REG_GCFG, 0);
@@ -168,12 +895,44 @@ PsiMsDaq_IpHandle PsiMsDaq_Init(	const uint32_t baseAddr,
 		//Initialize data structure
 		inst_p->streams[str].nr = str;
 		inst_p->streams[str].isConfigured = false;
+		uint32_t mode;
+		PsiMsDaq_RegRead(inst_p, PSI_MS_DAQ_REG_MODE(str), &mode);
+		atomic_init(&inst_p->streams[str].modeShadow, mode & MODE_CFG_MSK);
+		inst_p->streams[str].rearmCfg.enable = false;
+		atomic_init(&inst_p->streams[str].rearmPending, false);
+		inst_p->streams[str].rearmLastWin = 0;
+		atomic_init(&inst_p->streams[str].rearmTrigCnt, 0);
+		atomic_init(&inst_p->streams[str].rearmCnt, 0);
+		atomic_init(&inst_p->streams[str].rearmDeferredCnt, 0);
+		atomic_init(&inst_p->streams[str].rearmMissedTrigs, 0);
+		atomic_init(&inst_p->streams[str].rearmLastDeadTime, 0);
+		atomic_init(&inst_p->streams[str].rearmMaxDeadTime, 0);
+		atomic_init(&inst_p->streams[str].rearmTotalDeadTime, 0);
+		atomic_init(&inst_p->streams[str].metWindows, 0);
+		atomic_init(&inst_p->streams[str].metBytes, 0);
+		atomic_init(&inst_p->streams[str].metSpurious, 0);
+		atomic_init(&inst_p->streams[str].metSkipped, 0);
+		for (int i = 0; i < PSI_MS_DAQ_HIST_BINS; i++) {
+			atomic_init(&inst_p->streams[str].metLatencyHist[i], 0);
+		}
+		atomic_init(&inst_p->streams[str].metLatencySum, 0);
+		inst_p->streams[str].statsFct = NULL;
+		inst_p->streams[str].statsThreshold = 0;
+		atomic_init(&inst_p->streams[str].statsValid, 0);
 		inst_p->streams[str].irqFctWin = NULL;
 		inst_p->streams[str].irqFctStr = NULL;
+		inst_p->streams[str].irqFctBatch = NULL;
+		inst_p->streams[str].batchCnt = 0;
+		inst_p->streams[str].history = NULL;
+		inst_p->streams[str].historySize = 0;
+		atomic_init(&inst_p->streams[str].historyWr, 0);
 		inst_p->streams[str].irqArg = NULL;
 		inst_p->streams[str].ipHandle = (PsiMsDaq_IpHandle) inst_p;
 		inst_p->streams[str].lastProcWin = -1;
-		inst_p->streams[str].irqCalledWin = 0;
+		atomic_init(&inst_p->streams[str].irqCalledWin, 0);
+		for (int win = 0; win < maxWindows; win++) {
+			atomic_init(&inst_p->streams[str].winRefCnt[win], 0);
+		}
 	}
 	//Set general Enables (never touched later)
 	PsiMsDaq_RegWrite(inst_p, PSI_MS_DAQ_REG_GCFG, PSI_MS_DAQ_REG_GCFG_BIT_ENA | PSI_MS_DAQ_REG_GCFG_BIT_IRQENA);
@@ -198,6 +957,8 @@ void PsiMsDaq_HandleIrq(PsiMsDaq_IpHandle ipHandle)
 {
 	//Pointer Cast
 	PsiMsDaq_Inst_t* inst_p = (PsiMsDaq_Inst_t*) ipHandle;
+	const uint64_t irqStart = (NULL != inst_p->timeFct) ? inst_p->timeFct(inst_p->timeArg) : 0;
+	atomic_fetch_add_explicit(&inst_p->metIrqs, 1, memory_order_relaxed);
 
 	//Check which stream caused the IRQ and acknowledge it
 	uint32_t strWithIrq;
@@ -215,12 +976,21 @@ void PsiMsDaq_HandleIrq(PsiMsDaq_IpHandle ipHandle)
 			continue;
 		}
 
+		//Re-arm before calling user callbacks to minimize the dead time
+		HandleAutoRearm(str_p);
+
 		//IRQ Handling Type: Stream
 		if (NULL != str_p->irqFctStr) {
 			str_p->irqFctStr(strHandle, str_p->irqArg);
 		}
 
 
+		//IRQ Handling Type: Batch
+		if (NULL != str_p->irqFctBatch) {
+			CollectBatch(str_p);
+			DispatchBatch(str_p, false);
+		}
+
 		//IRQ Handling Type: Window
 		if (NULL != str_p->irqFctWin) {
 
@@ -229,6 +999,7 @@ void PsiMsDaq_HandleIrq(PsiMsDaq_IpHandle ipHandle)
 
 			//Call user callbacks for new windows
 			int8_t win = str_p->lastProcWin;
+			uint32_t delivered = 0;
 			do {
 				//Check if new data arrived and clear stream IRQ
 				PsiMsDaq_RegWrite(ipHandle, PSI_MS_DAQ_REG_IRQVEC, (1 << str));
@@ -236,25 +1007,246 @@ void PsiMsDaq_HandleIrq(PsiMsDaq_IpHandle ipHandle)
 				//Choose next window
 				win = (win + 1) % str_p->windows;
 				//Stopp if this window was not yet marked as free by the user
-				if (str_p->irqCalledWin & (1 << win)) {
+				if (atomic_load(&str_p->irqCalledWin) & (1 << win)) {
+					if (str_p->lastProcWin != lastWin) {
+						atomic_fetch_add_explicit(&str_p->metSkipped, 1, memory_order_relaxed);
+					}
+					else if (0 == delivered) {
+						atomic_fetch_add_explicit(&str_p->metSpurious, 1, memory_order_relaxed);
+					}
 					break;
 				}
-				str_p->irqCalledWin |= (1 << win);
+				atomic_fetch_or(&str_p->irqCalledWin, (1 << win));
 				//Call user IRQ
 				PsiMsDaq_WinInfo_t winInfo;
 				winInfo.ipHandle = ipHandle;
 				winInfo.strHandle = strHandle;
 				winInfo.winNr = win;
+				if ((NULL != inst_p->timeFct) || (0 != str_p->historySize)) {
+					PsiMsDaq_WinMeta_t meta;
+					ReadWinMeta(str_p, win, &meta);
+					RecordHistory(str_p, &meta);
+					if ((NULL != inst_p->timeFct) && meta.isTrig) {
+						HistAdd(str_p->metLatencyHist, &str_p->metLatencySum, inst_p->timeFct(inst_p->timeArg) - meta.timestamp);
+					}
+				}
 				if (str_p->irqFctWin != NULL) {
 					str_p->irqFctWin(winInfo, str_p->irqArg);
 				}
+				atomic_fetch_add_explicit(&str_p->metWindows, 1, memory_order_relaxed);
+				delivered++;
 				//Update State
 				str_p->lastProcWin = win;
 			} while (win != lastWin);
 		}
 	}
 
+	//Statistics
+	if (NULL != inst_p->timeFct) {
+		HistAdd(inst_p->metIrqDurationHist, &inst_p->metIrqDurationSum, inst_p->timeFct(inst_p->timeArg) - irqStart);
+	}
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_SetTimeSource(	PsiMsDaq_IpHandle ipHandle,
+											PsiMsDaq_TimeSource_f* timeFct,
+											void* arg)
+{
+	//Pointer Cast
+	PsiMsDaq_Inst_t* inst_p = (PsiMsDaq_Inst_t*) ipHandle;
+	//Implementation
+	inst_p->timeArg = arg;
+	inst_p->timeFct = timeFct;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_SetRegReadBlock(	PsiMsDaq_IpHandle ipHandle,
+												PsiMsDaq_RegReadBlock_f* regRdBlkFct)
+{
+	//Pointer Cast
+	PsiMsDaq_Inst_t* inst_p = (PsiMsDaq_Inst_t*) ipHandle;
+	//Implementation
+	inst_p->regRdBlkFct = regRdBlkFct;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_SetAddrTranslate(	PsiMsDaq_IpHandle ipHandle,
+												PsiMsDaq_AddrTranslate_f* addrFct)
+{
+	//Pointer Cast
+	PsiMsDaq_Inst_t* inst_p = (PsiMsDaq_Inst_t*) ipHandle;
+	//Implementation
+	inst_p->addrFct = addrFct;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+void PsiMsDaq_PollBatches(PsiMsDaq_IpHandle ipHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_Inst_t* inst_p = (PsiMsDaq_Inst_t*) ipHandle;
+	//Implementation
+	for (int str = 0; str < inst_p->maxStreams; str++) {
+		if (NULL != inst_p->streams[str].irqFctBatch) {
+			DispatchBatch(&inst_p->streams[str], NULL == inst_p->timeFct);
+		}
+	}
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_GetHistory(	PsiMsDaq_IpHandle ipHandle,
+										const uint32_t strMask,
+										const uint64_t tsFrom,
+										const uint64_t tsTo,
+										PsiMsDaq_HistoryEntry_t* const entries_p,
+										const uint32_t maxEntries,
+										uint32_t* const count_p)
+{
+	//Pointer Cast
+	PsiMsDaq_Inst_t* inst_p = (PsiMsDaq_Inst_t*) ipHandle;
+	//Checks
+	SAFE_CALL(CheckStrMask(ipHandle, strMask));
+	//Implementation (the histories of all streams are merged by timestamp, so the earliest entries are returned if the
+	//buffer is too small)
+	uint64_t next[32];
+	uint64_t first[32];
+	uint64_t wr[32];
+	for (uint8_t str = 0; str < inst_p->maxStreams; str++) {
+		PsiMsDaq_StrInst_t* const str_p = &inst_p->streams[str];
+		wr[str] = 0;
+		first[str] = 0;
+		if ((0 != (strMask & (1u << str))) && (0 != str_p->historySize)) {
+			wr[str] = atomic_load_explicit(&str_p->historyWr, memory_order_acquire);
+			first[str] = HistorySearch(str_p, wr[str], tsFrom);
+		}
+		next[str] = first[str];
+	}
+	uint32_t found = 0;
+	for (;;) {
+		int sel = -1;
+		uint64_t selTs = 0;
+		for (uint8_t str = 0; str < inst_p->maxStreams; str++) {
+			PsiMsDaq_StrInst_t* const str_p = &inst_p->streams[str];
+			if (next[str] < wr[str]) {
+				const uint64_t ts = str_p->history[next[str] % str_p->historySize].timestamp;
+				if ((ts <= tsTo) && ((sel < 0) || (ts < selTs))) {
+					sel = str;
+					selTs = ts;
+				}
+			}
+		}
+		if (sel < 0) {
+			break;
+		}
+		if (found < maxEntries) {
+			entries_p[found] = inst_p->streams[sel].history[next[sel] % inst_p->streams[sel].historySize];
+		}
+		next[sel]++;
+		found++;
+	}
+	//Discard entries that were overwritten by the IRQ while copying (only possible if the ring wrapped meanwhile)
+	atomic_thread_fence(memory_order_acquire);
+	uint64_t lost[32];
+	uint64_t lostTotal = 0;
+	for (uint8_t str = 0; str < inst_p->maxStreams; str++) {
+		lost[str] = 0;
+		if (next[str] > first[str]) {
+			const uint64_t valid = HistoryOldest(&inst_p->streams[str],
+												 atomic_load_explicit(&inst_p->streams[str].historyWr, memory_order_relaxed));
+			lost[str] = (valid > first[str]) ? ((valid < next[str]) ? valid : next[str]) - first[str] : 0;
+			lostTotal += lost[str];
+		}
+	}
+	uint32_t copied = (found < maxEntries) ? found : maxEntries;
+	if (lostTotal > 0) {
+		//The lost entries of a stream are its first ones in the result
+		uint32_t keep = 0;
+		for (uint32_t i = 0; i < copied; i++) {
+			const uint8_t str = entries_p[i].strNr;
+			if (lost[str] > 0) {
+				lost[str]--;
+				continue;
+			}
+			entries_p[keep++] = entries_p[i];
+		}
+		copied = keep;
+		found -= (uint32_t)lostTotal;
+	}
+	*count_p = copied;
+	//Done
+	if (found > maxEntries) {
+		return PsiMsDaq_RetCode_BufferTooSmall;
+	}
+	return PsiMsDaq_RetCode_Success;
+}
+
+void* PsiMsDaq_AddrToPtr(	PsiMsDaq_IpHandle ipHandle,
+							const uint32_t addr)
+{
+	//Pointer Cast
+	PsiMsDaq_Inst_t* inst_p = (PsiMsDaq_Inst_t*) ipHandle;
+	//Implementation
+	if (NULL != inst_p->addrFct) {
+		return inst_p->addrFct(addr);
+	}
+	return (void*)(size_t)addr;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_GetIrqMetrics(	PsiMsDaq_IpHandle ipHandle,
+											PsiMsDaq_IrqMetrics_t* const metrics_p)
+{
+	//Pointer Cast
+	PsiMsDaq_Inst_t* inst_p = (PsiMsDaq_Inst_t*) ipHandle;
+	//Implementation
+	metrics_p->irqs = atomic_load_explicit(&inst_p->metIrqs, memory_order_relaxed);
+	HistGet(inst_p->metIrqDurationHist, metrics_p->durationHist);
+	metrics_p->durationSum = atomic_load_explicit(&inst_p->metIrqDurationSum, memory_order_relaxed);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+//*******************************************************************************
+// Stream Group Functions
+//*******************************************************************************
+PsiMsDaq_RetCode_t PsiMsDaq_Grp_SetEnable(	PsiMsDaq_IpHandle ipHandle,
+											const uint32_t strMask,
+											const bool enable)
+{
+	//Checks
+	SAFE_CALL(CheckStrMask(ipHandle, strMask));
+	//Implementation
+	SAFE_CALL(PsiMsDaq_RegSetBit(ipHandle, PSI_MS_DAQ_REG_STRENA, strMask, enable));
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Grp_SetIrqEnable(	PsiMsDaq_IpHandle ipHandle,
+												const uint32_t strMask,
+												const bool irqEna)
+{
+	//Checks
+	SAFE_CALL(CheckStrMask(ipHandle, strMask));
+	//Implementation
+	SAFE_CALL(PsiMsDaq_RegSetBit(ipHandle, PSI_MS_DAQ_REG_IRQENA, strMask, irqEna));
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
 
+PsiMsDaq_RetCode_t PsiMsDaq_Grp_Arm(	PsiMsDaq_IpHandle ipHandle,
+										const uint32_t strMask)
+{
+	//Pointer Cast
+	PsiMsDaq_Inst_t* inst_p = (PsiMsDaq_Inst_t*) ipHandle;
+	//Checks
+	SAFE_CALL(CheckStrMask(ipHandle, strMask));
+	//Implementation
+	for (uint8_t str = 0; str < inst_p->maxStreams; str++) {
+		if (0 != (strMask & (1u << str))) {
+			SAFE_CALL(WriteArm(&inst_p->streams[str]));
+		}
+	}
+	//Done
+	return PsiMsDaq_RetCode_Success;
 }
 
 
@@ -319,6 +1311,82 @@ PsiMsDaq_RetCode_t PsiMsDaq_Str_Configure(	PsiMsDaq_StrHandle strHndl,
 	return PsiMsDaq_RetCode_Success;
 }
 
+PsiMsDaq_RetCode_t PsiMsDaq_Str_ConfigureStats(	PsiMsDaq_StrHandle strHndl,
+												const bool enable,
+												const bool isSigned,
+												const int64_t threshold)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* inst_p = (PsiMsDaq_StrInst_t*) strHndl;
+	//Disable
+	if (!enable) {
+		inst_p->statsFct = NULL;
+		return PsiMsDaq_RetCode_Success;
+	}
+	//Select kernel
+	switch (inst_p->widthBytes) {
+		case 1: inst_p->statsFct = isSigned ? StatsChunk_S8 : StatsChunk_U8; break;
+		case 2: inst_p->statsFct = isSigned ? StatsChunk_S16 : StatsChunk_U16; break;
+		case 4: inst_p->statsFct = isSigned ? StatsChunk_S32 : StatsChunk_U32; break;
+		case 8: inst_p->statsFct = isSigned ? StatsChunk_S64 : StatsChunk_U64; break;
+		default: return PsiMsDaq_RetCode_IllegalStrWidth;
+	}
+	inst_p->statsThreshold = threshold;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Str_SetAutoRearm(	PsiMsDaq_StrHandle strHndl,
+												const PsiMsDaq_AutoRearmConfig_t* const config_p)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* inst_p = (PsiMsDaq_StrInst_t*) strHndl;
+	//Implementation
+	inst_p->rearmCfg = *config_p;
+	atomic_store(&inst_p->rearmPending, false);
+	atomic_store(&inst_p->rearmCnt, 0);
+	atomic_store(&inst_p->rearmDeferredCnt, 0);
+	atomic_store(&inst_p->rearmMissedTrigs, 0);
+	atomic_store(&inst_p->rearmLastDeadTime, 0);
+	atomic_store(&inst_p->rearmMaxDeadTime, 0);
+	atomic_store(&inst_p->rearmTotalDeadTime, 0);
+	atomic_store(&inst_p->rearmTrigCnt, (NULL != config_p->trigCntFct) ? config_p->trigCntFct(config_p->arg) : 0);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Str_GetRearmStats(	PsiMsDaq_StrHandle strHndl,
+												PsiMsDaq_RearmStats_t* const stats_p)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* inst_p = (PsiMsDaq_StrInst_t*) strHndl;
+	//Implementation
+	stats_p->rearms = atomic_load_explicit(&inst_p->rearmCnt, memory_order_relaxed);
+	stats_p->deferredRearms = atomic_load_explicit(&inst_p->rearmDeferredCnt, memory_order_relaxed);
+	stats_p->missedTriggers = atomic_load_explicit(&inst_p->rearmMissedTrigs, memory_order_relaxed);
+	stats_p->lastDeadTime = atomic_load_explicit(&inst_p->rearmLastDeadTime, memory_order_relaxed);
+	stats_p->maxDeadTime = atomic_load_explicit(&inst_p->rearmMaxDeadTime, memory_order_relaxed);
+	stats_p->totalDeadTime = atomic_load_explicit(&inst_p->rearmTotalDeadTime, memory_order_relaxed);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Str_GetMetrics(	PsiMsDaq_StrHandle strHndl,
+											PsiMsDaq_StrMetrics_t* const metrics_p)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* inst_p = (PsiMsDaq_StrInst_t*) strHndl;
+	//Implementation
+	metrics_p->windows = atomic_load_explicit(&inst_p->metWindows, memory_order_relaxed);
+	metrics_p->bytesRead = atomic_load_explicit(&inst_p->metBytes, memory_order_relaxed);
+	metrics_p->spuriousIrqs = atomic_load_explicit(&inst_p->metSpurious, memory_order_relaxed);
+	metrics_p->skippedCallbacks = atomic_load_explicit(&inst_p->metSkipped, memory_order_relaxed);
+	HistGet(inst_p->metLatencyHist, metrics_p->latencyHist);
+	metrics_p->latencySum = atomic_load_explicit(&inst_p->metLatencySum, memory_order_relaxed);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
 PsiMsDaq_RetCode_t PsiMsDaq_Str_SetEnable(	PsiMsDaq_StrHandle strHndl,
 											const bool enable)
 {
@@ -340,7 +1408,7 @@ PsiMsDaq_RetCode_t PsiMsDaq_Str_SetIrqCallbackWin(	PsiMsDaq_StrHandle strHndl,
 	//Pointer Cast
 	PsiMsDaq_StrInst_t* inst_p = (PsiMsDaq_StrInst_t*) strHndl;
 	//Checks
-	if (NULL != inst_p->irqFctStr) {
+	if ((NULL != inst_p->irqFctStr) || (NULL != inst_p->irqFctBatch)) {
 		return PsiMsDaq_RetCode_IrqSchemesWinAndStrAreExclusive;
 	}
 	//Implementation
@@ -357,7 +1425,7 @@ PsiMsDaq_RetCode_t PsiMsDaq_Str_SetIrqCallbackStr(	PsiMsDaq_StrHandle strHndl,
 	//Pointer Cast
 	PsiMsDaq_StrInst_t* inst_p = (PsiMsDaq_StrInst_t*) strHndl;
 	//Checks
-	if (NULL != inst_p->irqFctWin) {
+	if ((NULL != inst_p->irqFctWin) || (NULL != inst_p->irqFctBatch)) {
 		return PsiMsDaq_RetCode_IrqSchemesWinAndStrAreExclusive;
 	}
 	//Implementation
@@ -367,6 +1435,51 @@ PsiMsDaq_RetCode_t PsiMsDaq_Str_SetIrqCallbackStr(	PsiMsDaq_StrHandle strHndl,
 	return PsiMsDaq_RetCode_Success;
 }
 
+PsiMsDaq_RetCode_t PsiMsDaq_Str_SetHistory(	PsiMsDaq_StrHandle strHndl,
+											const uint32_t entries)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* inst_p = (PsiMsDaq_StrInst_t*) strHndl;
+	//Checks (the ring is replaced without synchronization, so HandleIrq() must not record into it)
+	SAFE_CALL(CheckStrDisabled(inst_p->ipHandle, inst_p->nr));
+	//Implementation (allocate first, so the old history is kept if the allocation fails)
+	PsiMsDaq_HistoryEntry_t* history = NULL;
+	if (0 != entries) {
+		//One additional slot, since the oldest slot is being overwritten while a new entry is written
+		history = (PsiMsDaq_HistoryEntry_t*) malloc(sizeof(PsiMsDaq_HistoryEntry_t)*(entries+1));
+		if (NULL == history) {
+			return PsiMsDaq_RetCode_NoMemory;
+		}
+	}
+	free(inst_p->history);
+	inst_p->history = history;
+	inst_p->historySize = (0 != entries) ? entries+1 : 0;
+	atomic_store(&inst_p->historyWr, 0);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Str_SetIrqCallbackBatch(	PsiMsDaq_StrHandle strHndl,
+														PsiMsDaqn_BatchIrq_f* irqCb,
+														const PsiMsDaq_BatchConfig_t* const config_p,
+														void* arg_p)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* inst_p = (PsiMsDaq_StrInst_t*) strHndl;
+	//Checks
+	if ((NULL != inst_p->irqFctWin) || (NULL != inst_p->irqFctStr)) {
+		return PsiMsDaq_RetCode_IrqSchemesWinAndStrAreExclusive;
+	}
+	//Implementation
+	const PsiMsDaq_BatchConfig_t dfltCfg = {0, 0, 0};
+	inst_p->batchCfg = (NULL != config_p) ? *config_p : dfltCfg;
+	inst_p->batchCnt = 0;
+	inst_p->irqFctBatch = irqCb;
+	inst_p->irqArg = arg_p;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
 PsiMsDaq_RetCode_t PsiMsDaq_Str_SetIrqEnable(	PsiMsDaq_StrHandle strHndl,
 												const bool irqEna)
 {
@@ -393,6 +1506,42 @@ PsiMsDaq_RetCode_t PsiMsDaq_Str_Arm(PsiMsDaq_StrHandle strHndl)
 	return PsiMsDaq_RetCode_Success;
 }
 
+PsiMsDaq_RetCode_t PsiMsDaq_Str_MarkWinsAsFree(	PsiMsDaq_StrHandle strHndl,
+												const uint32_t winMask)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* inst_p = (PsiMsDaq_StrInst_t*) strHndl;
+	PsiMsDaq_Inst_t* ip_p = (PsiMsDaq_Inst_t*) inst_p->ipHandle;
+	const uint8_t strNr = inst_p->nr;
+	//Checks
+	if ((inst_p->windows < 32) && (0 != (winMask >> inst_p->windows))) {
+		return PsiMsDaq_RetCode_IllegalWinNr;
+	}
+	//Implementation (windows are freed in address order to allow write combining)
+	atomic_fetch_and(&inst_p->statsValid, ~winMask);
+	atomic_fetch_and(&inst_p->irqCalledWin, ~winMask);
+	for (uint8_t win = 0; win < inst_p->windows; win++) {
+		if (0 != (winMask & (1u << win))) {
+			SAFE_CALL(PsiMsDaq_RegWrite(inst_p->ipHandle, PSI_MS_DAQ_WIN_WINCNT(strNr, win, ip_p->strAddrOffs), 0));
+		}
+	}
+	HandleDeferredRearm(inst_p);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Str_MarkWinsAsFreeAndArm(	PsiMsDaq_StrHandle strHndl,
+														const uint32_t winMask)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* inst_p = (PsiMsDaq_StrInst_t*) strHndl;
+	//Implementation
+	SAFE_CALL(PsiMsDaq_Str_MarkWinsAsFree(strHndl, winMask));
+	SAFE_CALL(WriteArm(inst_p));
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
 PsiMsDaq_RetCode_t PsiMsDaq_Str_GetMaxLvl(	PsiMsDaq_StrHandle strHndl,
 											uint32_t* const maxLvl_p)
 {
@@ -428,7 +1577,7 @@ PsiMsDaq_RetCode_t PsiMsDaq_Str_GetFreeWindows(	PsiMsDaq_StrHandle strHndl,
 	const uint8_t strNr = inst_p->nr;
 	//Implementation (looping is not very efficient but safe and simple)
 	uint8_t freeWin = 0;
-	for (int win = inst_p->windows-1; win > 0; win--) {
+	for (int win = inst_p->windows-1; win >= 0; win--) {
 		uint32_t cnt;
 		SAFE_CALL(PsiMsDaq_RegGetField(	ipHandle,
 										PSI_MS_DAQ_WIN_WINCNT(strNr, win, ip_p->strAddrOffs),
@@ -490,6 +1639,41 @@ PsiMsDaq_RetCode_t PsiMsDaq_Str_GetStrNr(	PsiMsDaq_StrHandle strHndl,
 	return PsiMsDaq_RetCode_Success;
 }
 
+PsiMsDaq_RetCode_t PsiMsDaq_Str_GetBufferLayout(	PsiMsDaq_StrHandle strHndl,
+													uint32_t* const bufStartAddr_p,
+													uint32_t* const winSize_p)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* inst_p = (PsiMsDaq_StrInst_t*) strHndl;
+	//Implementation
+	*bufStartAddr_p = inst_p->bufStart;
+	*winSize_p = inst_p->winSize;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Str_GetPostTrigSamples(	PsiMsDaq_StrHandle strHndl,
+													uint32_t* const postTrigSamples_p)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* inst_p = (PsiMsDaq_StrInst_t*) strHndl;
+	//Implementation
+	*postTrigSamples_p = inst_p->postTrig;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Str_GetSampleBytes(	PsiMsDaq_StrHandle strHndl,
+												uint8_t* const sampleBytes_p)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* inst_p = (PsiMsDaq_StrInst_t*) strHndl;
+	//Implementation
+	*sampleBytes_p = inst_p->widthBytes;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
 //*******************************************************************************
 // Window Related Functions
 //*******************************************************************************
@@ -586,54 +1770,212 @@ PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetDataUnwrapped(	PsiMsDaq_WinInfo_t winInfo,
 	PsiMsDaq_StrInst_t* str_p = (PsiMsDaq_StrInst_t*) winInfo.strHandle;
 	PsiMsDaq_Inst_t* ip_p = (PsiMsDaq_Inst_t*) winInfo.ipHandle;
 
-	//Setup
-	const uint32_t samples = preTrigSamples+postTrigSamples;
-	const uint32_t bytes = samples*str_p->widthBytes;
-	uint32_t preTrig;
-	SAFE_CALL(PsiMsDaq_StrWin_GetPreTrigSamples(winInfo, &preTrig));
-
 	//Checks
+	const uint32_t bytes = (preTrigSamples+postTrigSamples)*str_p->widthBytes;
 	if (bufferSize < bytes) {
 		return PsiMsDaq_RetCode_BufferTooSmall;
 	}
-	if (postTrigSamples > str_p->postTrig) {
-		return PsiMsDaq_RetCode_MorePostTrigThanConfigured;
+
+	DataSpan_t spans[2];
+	SAFE_CALL(GetDataSpans(winInfo, preTrigSamples, postTrigSamples, spans));
+
+	//Copy data (one chunk if the data is not wrapped, two chunks otherwise)
+	if (NULL == str_p->statsFct) {
+		ip_p->memcpyFct(buffer_p, PsiMsDaq_AddrToPtr(ip_p, spans[0].addr), spans[0].bytes);
+		if (0 != spans[1].bytes) {
+			ip_p->memcpyFct((uint8_t*)buffer_p+spans[0].bytes, PsiMsDaq_AddrToPtr(ip_p, spans[1].addr), spans[1].bytes);
+		}
 	}
-	if (preTrigSamples > preTrig) {
-		return PsiMsDaq_RetCode_MorePreTrigThanAvailable;
+	//If statistics are enabled, copy in small chunks and calculate statistics on each chunk while it is in the cache
+	else {
+		const uint32_t chunkBytes = (PSI_MS_DAQ_CHUNK_BYTES/str_p->widthBytes)*str_p->widthBytes;
+		uint8_t* dst_p = (uint8_t*) buffer_p;
+		uint32_t firstSpl = 0;
+		StatsState_t stats;
+		StatsStart(&stats, str_p);
+		for (int i = 0; i < 2; i++) {
+			uint32_t addr = spans[i].addr;
+			uint32_t left = spans[i].bytes;
+			while (left > 0) {
+				const uint32_t thisBytes = (left > chunkBytes) ? chunkBytes : left;
+				const uint32_t thisSpls = thisBytes/str_p->widthBytes;
+				ip_p->memcpyFct(dst_p, PsiMsDaq_AddrToPtr(ip_p, addr), thisBytes);
+				str_p->statsFct(dst_p, thisSpls, firstSpl, &stats);
+				dst_p += thisBytes;
+				addr += thisBytes;
+				left -= thisBytes;
+				firstSpl += thisSpls;
+			}
+		}
+		StatsFinish(&stats, str_p, winInfo.winNr);
 	}
+	atomic_fetch_add_explicit(&str_p->metBytes, bytes, memory_order_relaxed);
 
-	//Calculate window addresses
-	const uint32_t winStart = str_p->bufStart + str_p->winSize*winInfo.winNr;
-	const uint32_t winLast = winStart + str_p->winSize - 1;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
 
-	//Calculate address of last byte and trigger byte (with regard to wrapping)
-	uint32_t lastSplAddr;
-	SAFE_CALL(PsiMsDaq_StrWin_GetLastSplAddr(winInfo, &lastSplAddr));
-	uint32_t trigByteAddr = lastSplAddr - str_p->postTrig*str_p->widthBytes;
-	if (trigByteAddr < winStart) {
-		trigByteAddr += str_p->winSize;
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetDataChunked(	PsiMsDaq_WinInfo_t winInfo,
+													const uint32_t preTrigSamples,
+													const uint32_t postTrigSamples,	//including trigger
+													PsiMsDaq_DataChunk_f* chunkFct,
+													void* arg_p)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* str_p = (PsiMsDaq_StrInst_t*) winInfo.strHandle;
+	PsiMsDaq_Inst_t* ip_p = (PsiMsDaq_Inst_t*) winInfo.ipHandle;
+
+	//Setup
+	uint64_t bounce[PSI_MS_DAQ_CHUNK_BYTES/sizeof(uint64_t)];
+	const uint32_t chunkBytes = (sizeof(bounce)/str_p->widthBytes)*str_p->widthBytes;
+	DataSpan_t spans[2];
+	SAFE_CALL(GetDataSpans(winInfo, preTrigSamples, postTrigSamples, spans));
+
+	//Stream the data through the bounce buffer (spans always contain complete samples)
+	uint32_t firstSpl = 0;
+	for (int i = 0; i < 2; i++) {
+		uint32_t addr = spans[i].addr;
+		uint32_t left = spans[i].bytes;
+		while (left > 0) {
+			const uint32_t thisBytes = (left > chunkBytes) ? chunkBytes : left;
+			const uint32_t thisSpls = thisBytes/str_p->widthBytes;
+			ip_p->memcpyFct(bounce, PsiMsDaq_AddrToPtr(ip_p, addr), thisBytes);
+			chunkFct(bounce, thisSpls, firstSpl, arg_p);
+			addr += thisBytes;
+			left -= thisBytes;
+			firstSpl += thisSpls;
+		}
 	}
-	uint32_t lastByteAddr = trigByteAddr + postTrigSamples*str_p->widthBytes + str_p->widthBytes-1;
-	if (lastByteAddr > winLast) {
-		lastByteAddr -= str_p->winSize;
+	atomic_fetch_add_explicit(&str_p->metBytes, spans[0].bytes + spans[1].bytes, memory_order_relaxed);
+
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetDataDecimated(	PsiMsDaq_WinInfo_t winInfo,
+														const uint32_t preTrigSamples,
+														const uint32_t postTrigSamples,	//including trigger
+														const PsiMsDaq_DecimMode_t mode,
+														const uint32_t ratio,
+														const bool isSigned,
+														void* const buffer_p,
+														const size_t bufferSize,
+														uint32_t* const outSamples_p)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* str_p = (PsiMsDaq_StrInst_t*) winInfo.strHandle;
+
+	//Checks
+	PsiMsDaq_DataChunk_f* chunkFct;
+	switch (str_p->widthBytes) {
+		case 1: chunkFct = isSigned ? DecimChunk_S8 : DecimChunk_U8; break;
+		case 2: chunkFct = isSigned ? DecimChunk_S16 : DecimChunk_U16; break;
+		case 4: chunkFct = isSigned ? DecimChunk_S32 : DecimChunk_U32; break;
+		case 8: chunkFct = isSigned ? DecimChunk_S64 : DecimChunk_U64; break;
+		default: return PsiMsDaq_RetCode_IllegalStrWidth;
+	}
+	if (0 == ratio) {
+		return PsiMsDaq_RetCode_IllegalDecimRatio;
+	}
+	const uint32_t samples = preTrigSamples+postTrigSamples;
+	const uint32_t bins = (samples+ratio-1)/ratio;
+	const uint32_t outSpls = (PsiMsDaq_DecimMode_MinMax == mode) ? 2*bins : bins;
+	if (bufferSize < (size_t)outSpls*str_p->widthBytes) {
+		return PsiMsDaq_RetCode_BufferTooSmall;
 	}
 
+	//Implementation
+	DecimState_t state;
+	state.mode = mode;
+	state.ratio = ratio;
+	state.out_p = buffer_p;
+	state.outIdx = 0;
+	state.binCnt = 0;
+	SAFE_CALL(PsiMsDaq_StrWin_GetDataChunked(winInfo, preTrigSamples, postTrigSamples, chunkFct, &state));
+	//..Flush incomplete last bin
+	if (0 != state.binCnt) {
+		state.ratio = state.binCnt;
+		chunkFct(NULL, 0, 0, &state);
+	}
+	*outSamples_p = state.outIdx;
 
-	//If all bytes are written without wrap, copy directly
-	const int64_t firstByteLinear = (int64_t)lastByteAddr - bytes + 1;
-	if (firstByteLinear >= winStart) {
-		ip_p->memcpyFct(buffer_p, (void*)(size_t)firstByteLinear, bytes);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetDataDeinterleaved(	PsiMsDaq_WinInfo_t winInfo,
+															const uint32_t preTrigSamples,
+															const uint32_t postTrigSamples,	//including trigger
+															const PsiMsDaq_ChLayout_t* const layout_p,
+															const PsiMsDaq_ChFormat_t format,
+															void* const* const buffers_p,
+															const size_t bufferSize)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* str_p = (PsiMsDaq_StrInst_t*) winInfo.strHandle;
+
+	//Checks
+	PsiMsDaq_DataChunk_f* chunkFct;
+	const bool toFloat = (PsiMsDaq_ChFormat_Float == format);
+	const bool isSigned = layout_p->isSigned;
+	switch (layout_p->widthBits) {
+		case 8: chunkFct = toFloat ? (isSigned ? DeintChunk_S8_F : DeintChunk_U8_F) : (isSigned ? DeintChunk_S8 : DeintChunk_U8); break;
+		case 16: chunkFct = toFloat ? (isSigned ? DeintChunk_S16_F : DeintChunk_U16_F) : (isSigned ? DeintChunk_S16 : DeintChunk_U16); break;
+		case 32: chunkFct = toFloat ? (isSigned ? DeintChunk_S32_F : DeintChunk_U32_F) : (isSigned ? DeintChunk_S32 : DeintChunk_U32); break;
+		default: return PsiMsDaq_RetCode_IllegalChLayout;
 	}
-	//Do unwrapping else
-	else {
-		const uint32_t secondChunkSize = lastByteAddr - winStart + 1;
-		const uint32_t firstChunkSize = bytes-secondChunkSize;
-		const int64_t firstChunkStartAddr = winLast-firstChunkSize+1;
-		ip_p->memcpyFct(buffer_p, (void*)(size_t)firstChunkStartAddr, firstChunkSize);	
-		ip_p->memcpyFct((void*)((uint32_t)buffer_p+firstChunkSize), (void*)(size_t)winStart, secondChunkSize);
+	const uint32_t chBytes = layout_p->widthBits/8;
+	if ((0 == layout_p->channels) || ((uint32_t)layout_p->channels*chBytes > str_p->widthBytes) ||
+		(0 != (str_p->widthBytes % chBytes))) {
+		return PsiMsDaq_RetCode_IllegalChLayout;
+	}
+	const uint32_t outBytes = toFloat ? sizeof(float) : chBytes;
+	if (bufferSize < (size_t)(preTrigSamples+postTrigSamples)*outBytes) {
+		return PsiMsDaq_RetCode_BufferTooSmall;
 	}
 
+	//Implementation
+	DeintState_t state;
+	state.stride = str_p->widthBytes/chBytes;
+	state.channels = layout_p->channels;
+	state.out_p = buffers_p;
+	SAFE_CALL(PsiMsDaq_StrWin_GetDataChunked(winInfo, preTrigSamples, postTrigSamples, chunkFct, &state));
+
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_ComputeStats(	PsiMsDaq_WinInfo_t winInfo,
+													const uint32_t preTrigSamples,
+													const uint32_t postTrigSamples)	//including trigger
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* str_p = (PsiMsDaq_StrInst_t*) winInfo.strHandle;
+	//Checks
+	if (NULL == str_p->statsFct) {
+		return PsiMsDaq_RetCode_StatsNotEnabled;
+	}
+	//Implementation
+	StatsState_t stats;
+	StatsStart(&stats, str_p);
+	SAFE_CALL(PsiMsDaq_StrWin_GetDataChunked(winInfo, preTrigSamples, postTrigSamples, str_p->statsFct, &stats));
+	StatsFinish(&stats, str_p, winInfo.winNr);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetStats(	PsiMsDaq_WinInfo_t winInfo,
+												PsiMsDaq_WinStats_t* const stats_p)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* str_p = (PsiMsDaq_StrInst_t*) winInfo.strHandle;
+	//Checks
+	SAFE_CALL(CheckWinNr(winInfo.strHandle, winInfo.winNr))
+	if (0 == (atomic_load(&str_p->statsValid) & (1 << winInfo.winNr))) {
+		return PsiMsDaq_RetCode_NoStatsAvailable;
+	}
+	//Implementation
+	*stats_p = str_p->winStats[winInfo.winNr];
 	//Done
 	return PsiMsDaq_RetCode_Success;
 }
@@ -646,12 +1988,45 @@ PsiMsDaq_RetCode_t PsiMsDaq_StrWin_MarkAsFree(	PsiMsDaq_WinInfo_t winInfo)
 	PsiMsDaq_Inst_t* ip_p = (PsiMsDaq_Inst_t*) winInfo.ipHandle;
 	PsiMsDaq_StrInst_t* str_p = (PsiMsDaq_StrInst_t*) winInfo.strHandle;
 	//Implementation
-	str_p->irqCalledWin &= ~(1 << winInfo.winNr);
+	atomic_fetch_and(&str_p->statsValid, ~(1 << winInfo.winNr));
+	atomic_fetch_and(&str_p->irqCalledWin, ~(1 << winInfo.winNr));
 	SAFE_CALL(PsiMsDaq_RegWrite(winInfo.ipHandle, PSI_MS_DAQ_WIN_WINCNT(strNr, winInfo.winNr, ip_p->strAddrOffs), 0));
+	HandleDeferredRearm(str_p);
 	//Done
 	return PsiMsDaq_RetCode_Success;
 }
 
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_Retain(	PsiMsDaq_WinInfo_t winInfo)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* str_p = (PsiMsDaq_StrInst_t*) winInfo.strHandle;
+	//Checks
+	SAFE_CALL(CheckWinNr(winInfo.strHandle, winInfo.winNr))
+	//Implementation
+	atomic_fetch_add(&str_p->winRefCnt[winInfo.winNr], 1);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_Release(	PsiMsDaq_WinInfo_t winInfo)
+{
+	//Pointer Cast
+	PsiMsDaq_StrInst_t* str_p = (PsiMsDaq_StrInst_t*) winInfo.strHandle;
+	//Checks
+	SAFE_CALL(CheckWinNr(winInfo.strHandle, winInfo.winNr))
+	//Implementation (only the holder that drops the last reference frees the window)
+	uint_fast16_t cnt = atomic_load(&str_p->winRefCnt[winInfo.winNr]);
+	do {
+		if (0 == cnt) {
+			return PsiMsDaq_RetCode_WinNotRetained;
+		}
+	} while (!atomic_compare_exchange_weak(&str_p->winRefCnt[winInfo.winNr], &cnt, cnt-1));
+	if (1 == cnt) {
+		SAFE_CALL(PsiMsDaq_StrWin_MarkAsFree(winInfo));
+	}
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
 
 PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetLastSplAddr(	PsiMsDaq_WinInfo_t winInfo,
 													uint32_t* const lastSplAddr_p)
@@ -666,6 +2041,21 @@ PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetLastSplAddr(	PsiMsDaq_WinInfo_t winInfo,
 	return PsiMsDaq_RetCode_Success;
 }
 
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetDataRange(	PsiMsDaq_WinInfo_t winInfo,
+													const uint32_t preTrigSamples,
+													const uint32_t postTrigSamples,	//including trigger
+													uint32_t* const firstByteAddr_p,
+													uint32_t* const bytes_p)
+{
+	//Implementation
+	DataSpan_t spans[2];
+	SAFE_CALL(GetDataSpans(winInfo, preTrigSamples, postTrigSamples, spans));
+	*firstByteAddr_p = spans[0].addr;
+	*bytes_p = spans[0].bytes + spans[1].bytes;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
 
 
 //*******************************************************************************
@@ -733,6 +2123,12 @@ PsiMsDaq_RetCode_t PsiMsDaq_RegWrite(	PsiMsDaq_IpHandle ipHandle,
 {
 	//Cast pointer
 	PsiMsDaq_Inst_t* inst_p = (PsiMsDaq_Inst_t*)ipHandle;
+	//Track the configuration bits of the MODE registers (also if written by the user)
+	if ((addr >= PSI_MS_DAQ_REG_MODE(0)) && (addr < (uint32_t)PSI_MS_DAQ_REG_MODE(inst_p->maxStreams)) &&
+		(0 == ((addr-PSI_MS_DAQ_REG_MODE(0)) & 0xF))) {
+		atomic_store_explicit(	&inst_p->streams[(addr-PSI_MS_DAQ_REG_MODE(0))/0x10].modeShadow,
+								value & MODE_CFG_MSK, memory_order_relaxed);
+	}
 	//Execute access
 	inst_p->regWrFct(inst_p->baseAddr+addr, value);
 	//Done
@@ -751,6 +2147,26 @@ PsiMsDaq_RetCode_t PsiMsDaq_RegRead(	PsiMsDaq_IpHandle ipHandle,
 	return PsiMsDaq_RetCode_Success;
 }
 
+PsiMsDaq_RetCode_t PsiMsDaq_RegReadBlock(	PsiMsDaq_IpHandle ipHandle,
+											const uint32_t addr,
+											uint32_t* const values_p,
+											const uint32_t count)
+{
+	//Cast pointer
+	PsiMsDaq_Inst_t* inst_p = (PsiMsDaq_Inst_t*)ipHandle;
+	//Execute access (single reads if no block read function is available)
+	if (NULL != inst_p->regRdBlkFct) {
+		inst_p->regRdBlkFct(inst_p->baseAddr+addr, values_p, count);
+	}
+	else {
+		for (uint32_t i = 0; i < count; i++) {
+			values_p[i] = inst_p->regRdFct(inst_p->baseAddr+addr+4*i);
+		}
+	}
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
 PsiMsDaq_RetCode_t PsiMsDaq_RegSetField(	PsiMsDaq_IpHandle ipHandle,
 											const uint32_t addr,
 											const uint8_t lsb,
@@ -35,6 +35,9 @@ extern "C" {
 * on what IRQs the driver API is used from. There may also other protection schemes be used (e.g. mutexes of a RTOS).
 * As a result there is not single true protection mechanism that can be implemented within the driver.
 *
+* The only exception are PsiMsDaq_StrWin_Retain(), PsiMsDaq_StrWin_Release(), PsiMsDaq_StrWin_MarkAsFree() and PsiMsDaq_Str_MarkWinsAsFree(). They
+* can be called from any thread without protection, so windows can be passed to worker threads and freed there.
+*
 * @section irq_handling IRQ Handling
 *
 * The driver supports two ways of handling IRQs. One of them (<i>Window based IRQ</i>) is a bit more elaborate and easy to use
@@ -69,6 +72,14 @@ extern "C" {
 * of the IRQ he wants. This allows fine grained control over the IP core in special cases but it also means that the user
 * is fully on his own. Therefore this option should only be used if there are good reasons for not using Window based IRQ.
 *
+* @subsection batch_irq Batch IRQ
+*
+* This handling scheme is a variant of the <i>Window based IRQ</i> for high trigger rates. Instead of calling the user callback
+* once per window, all windows that became ready are passed in one call as an array, together with their metadata (sample count,
+* trigger flag, timestamp, last sample address) that is read from the IP before the callback. Optionally windows can be accumulated
+* until a minimum batch size or a maximum delay is reached (see PsiMsDaq_BatchConfig_t). The same rules as for the
+* <i>Window based IRQ</i> apply regarding window overwriting and freeing windows.
+*
 * @section example_code Example Code
 *
 * This section contains a little code example to show how the driver is used.
@@ -159,6 +170,8 @@ extern "C" {
 #define PSI_MS_DAQ_REG_MODE_MSB_RECM		1
 #define PSI_MS_DAQ_REG_MODE_BIT_ARM			(1 << 8)
 #define PSI_MS_DAQ_REG_MODE_BIT_REC			(1 << 16)
+#define PSI_MS_DAQ_REG_MODE_BIT_TODISABLE	(1 << 24)
+#define PSI_MS_DAQ_REG_MODE_BIT_FRAMETO		(1 << 25)
 #define PSI_MS_DAQ_REG_LASTWIN(n)			(0x20C+0x10*(n))
 //CTXMEM for Stream n
 #define PSI_MS_DAQ_CTX_SCFG(n)				(0x1000+0x20*(n))
@@ -182,6 +195,20 @@ extern "C" {
 #define PSI_MS_DAQ_WIN_TSHI(n, w, so)			(0x400C+(so)*(n)+0x10*(w))
 /// @endcond
 
+/**
+ * @brief	Size of the bounce buffer (on the stack) used by PsiMsDaq_StrWin_GetDataChunked() and all
+ * 			functions based on it. Can be overridden at compile time.
+ */
+#ifndef PSI_MS_DAQ_CHUNK_BYTES
+#define PSI_MS_DAQ_CHUNK_BYTES				1024
+#endif
+
+/**
+ * @brief	Number of bins of the metrics histograms. Bin 0 counts the value 0, bin N counts values from 2^(N-1) to 2^N-1,
+ * 			the last bin also counts all larger values.
+ */
+#define PSI_MS_DAQ_HIST_BINS				32
+
 //*******************************************************************************
 // Types
 //*******************************************************************************
@@ -194,12 +221,23 @@ typedef void* PsiMsDaq_StrHandle;	///< Handle to a specific stream of the driver
 /**
  * @brief	Copy used to copy data recorded to other memory locations in PsiMsDaq_StrWin_GetDataUnwrapped()
  *
- * @param	src		Source memory address (exactly the way the IP sees the address space)
+ * @param	src		Source memory address (exactly the way the IP sees the address space or, if an address translation function
+ * 					is used, the translated CPU address)
  * @param	dst		Desitnation memory address (as the CPU sees it)
  * @param	n		Number of bytes to copy
  */
 typedef void PsiMsDaq_DataCopy_f(void* dst, void* src, size_t n);
 
+/**
+ * @brief	Translate an address on the IP bus (as used for PsiMsDaq_StrConfig_t.bufStartAddr) into a CPU pointer.
+ * 			This is required whenever the CPU does not see the memory at the same address as the IP, for example on Linux
+ * 			where the DMA memory is mmapped to an arbitrary virtual address (possibly above 4 GB on 64-bit hosts).
+ *
+ * @param	addr	Address on the IP bus
+ * @return	CPU pointer to the same memory
+ */
+typedef void* PsiMsDaq_AddrTranslate_f(const uint32_t addr);
+
 /**
  * @brief	Write an IP-register
  *
@@ -216,10 +254,21 @@ typedef void PsiMsDaq_RegWrite_f(const uint32_t addr, const uint32_t value);
  */
 typedef uint32_t PsiMsDaq_RegRead_f(const uint32_t addr);
 
+/**
+ * @brief	Read a block of consecutive IP-registers (e.g. in one bus burst)
+ *
+ * @param	addr		Address of the first register to read (byte address)
+ * @param	values_p	Buffer to write the read values into
+ * @param	count		Number of registers to read
+ */
+typedef void PsiMsDaq_RegReadBlock_f(const uint32_t addr, uint32_t* const values_p, const uint32_t count);
+
 /**
  * @brief	Window definition struct, used for more compact passing of common parameters
  * @note	This is not a handle and this struct is allocated on the stack, so it is only valid
- * 			until the function returns!
+ * 			until the function returns! Copies of the struct stay valid as long as the window
+ * 			is not freed, so to keep a window beyond the callback, copy the struct and retain the
+ * 			window using PsiMsDaq_StrWin_Retain().
  */
 typedef struct {
 	uint8_t	winNr;					///< Window number
@@ -249,6 +298,100 @@ typedef void PsiMsDaqn_WinIrq_f(PsiMsDaq_WinInfo_t winInfo, void* arg);
  */
 typedef void PsiMsDaqn_StrIrq_f(PsiMsDaq_StrHandle strHandle, void* arg);
 
+/**
+ * @brief	Metadata of a window, read from the IP before the window is passed to the user
+ */
+typedef struct {
+	PsiMsDaq_WinInfo_t winInfo;		///< Window information
+	uint64_t timestamp;				///< Trigger timestamp (only valid if isTrig is set)
+	uint32_t samples;				///< Number of samples in the window
+	uint32_t lastSplAddr;			///< Address of the last sample written into the window
+	bool isTrig;					///< true if the window contains a trigger
+} PsiMsDaq_WinMeta_t;
+
+/**
+ * @brief	Interrupt callback function for the batch IRQ scheme.
+ * 			In this IRQ scheme, all windows that became ready are passed to the user in one call. This allows
+ * 			amortizing per-window work (e.g. cache invalidation, I/O submission or queue operations) over a batch.
+ * 			As for the window based scheme, each window must be freed by calling PsiMsDaq_StrWin_MarkAsFree() after
+ * 			processing (PsiMsDaq_Str_MarkWinsAsFree() can be used to free the whole batch).
+ *
+ * @param	wins_p	Array of window metadata in recording order (only valid until the function returns)
+ * @param	count	Number of windows in the array
+ * @param	arg		User argument list
+ */
+typedef void PsiMsDaqn_BatchIrq_f(const PsiMsDaq_WinMeta_t* const wins_p, const uint32_t count, void* arg);
+
+/**
+ * @brief	Window metadata kept in the history of a stream (see PsiMsDaq_Str_SetHistory())
+ */
+typedef struct {
+	uint64_t timestamp;				///< Trigger timestamp
+	uint32_t samples;				///< Number of samples in the window
+	uint32_t lastSplAddr;			///< Address of the last sample written into the window
+	uint8_t strNr;					///< Stream number
+	uint8_t winNr;					///< Window number (the window may be reused already)
+} PsiMsDaq_HistoryEntry_t;
+
+/**
+ * @brief	Configuration of the batch IRQ scheme
+ */
+typedef struct {
+	uint32_t maxWindows;	///< Maximum number of windows passed per callback (0 = no limit)
+	uint32_t minWindows;	///< Number of windows to accumulate before the callback is called (0 or 1 = call immediately)
+	uint64_t maxDelay;		///< Maximum time to hold back windows when accumulating (in units of the time source, 0 = no limit)
+} PsiMsDaq_BatchConfig_t;
+
+/**
+ * @brief	Function called for every chunk of data read by PsiMsDaq_StrWin_GetDataChunked()
+ *
+ * @param	data_p		Chunk data (only valid until the function returns)
+ * @param	samples		Number of samples in the chunk
+ * @param	firstSpl	Index of the first sample of the chunk (relative to the first sample read)
+ * @param	arg_p		User argument
+ */
+typedef void PsiMsDaq_DataChunk_f(const void* data_p, const uint32_t samples, const uint32_t firstSpl, void* arg_p);
+
+/**
+ * @brief	Decimation mode for PsiMsDaq_StrWin_GetDataDecimated()
+ */
+typedef enum {
+	PsiMsDaq_DecimMode_Stride		= 0,	///< Output the first sample of each bin
+	PsiMsDaq_DecimMode_Average		= 1,	///< Output the average of each bin (boxcar, rounded towards zero)
+	PsiMsDaq_DecimMode_MinMax		= 2		///< Output minimum and maximum of each bin (two samples per bin)
+} PsiMsDaq_DecimMode_t;
+
+/**
+ * @brief	Layout of several channels packed into one stream sample (channel 0 in the least significant bits)
+ */
+typedef struct {
+	uint8_t channels;		///< Number of channels (channels*widthBits must not exceed the stream width)
+	uint8_t widthBits;		///< Width of each channel in bits (8, 16 or 32)
+	bool isSigned;			///< true if the channels are signed (two's complement)
+} PsiMsDaq_ChLayout_t;
+
+/**
+ * @brief	Output format for PsiMsDaq_StrWin_GetDataDeinterleaved()
+ */
+typedef enum {
+	PsiMsDaq_ChFormat_Native		= 0,	///< Same type as the channel (e.g. int16_t for signed 16-bit channels)
+	PsiMsDaq_ChFormat_Float			= 1		///< float
+} PsiMsDaq_ChFormat_t;
+
+/**
+ * @brief	Statistics of the data read from a window (see PsiMsDaq_Str_ConfigureStats())
+ */
+typedef struct {
+	uint32_t samples;				///< Number of samples the statistics are calculated over
+	double mean;					///< Mean value
+	double rms;						///< RMS value
+	int64_t min;					///< Minimum value (for unsigned 64-bit streams, cast to uint64_t)
+	int64_t max;					///< Maximum value (for unsigned 64-bit streams, cast to uint64_t)
+	uint32_t minIdx;				///< Index of the first occurence of the minimum (relative to the first sample read)
+	uint32_t maxIdx;				///< Index of the first occurence of the maximum (relative to the first sample read)
+	uint32_t thresholdCrossings;	///< Number of threshold crossings (in both directions)
+} PsiMsDaq_WinStats_t;
+
 /**
  * @brief	Recorder mode (see documentation)
  */
@@ -273,6 +416,70 @@ typedef struct {
 	uint16_t streamWidthBits;	///< Width od the stream in bits (must be a multiple of 8)
 } PsiMsDaq_StrConfig_t;
 
+/**
+ * @brief	Time source for dead time measurement. Must return the current time in the same units and time base as the
+ * 			window timestamps (i.e. the value of the timestamp counter connected to the IP).
+ *
+ * @param	arg		User argument
+ * @return	Current time
+ */
+typedef uint64_t PsiMsDaq_TimeSource_f(void* arg);
+
+/**
+ * @brief	External trigger counter for counting missed triggers. Must return the total number of triggers that
+ * 			occurred on the stream (e.g. read from a trigger counter in the user logic). May wrap around.
+ *
+ * @param	arg		User argument
+ * @return	Number of triggers
+ */
+typedef uint32_t PsiMsDaq_TrigCounter_f(void* arg);
+
+/**
+ * @brief	Automatic re-arm configuration (see PsiMsDaq_Str_SetAutoRearm())
+ */
+typedef struct {
+	bool enable;							///< Enable automatic re-arm
+	PsiMsDaq_TimeSource_f* timeFct;			///< Time source for dead time measurement (NULL = do not measure dead time)
+	PsiMsDaq_TrigCounter_f* trigCntFct;		///< External trigger counter (NULL = do not count missed triggers)
+	void* arg;								///< User argument passed to timeFct and trigCntFct
+} PsiMsDaq_AutoRearmConfig_t;
+
+/**
+ * @brief	Automatic re-arm statistics
+ * @note	On targets without lock-free 64-bit atomics, the 64-bit fields are counted in 32 bits and wrap at 2^32.
+ */
+typedef struct {
+	uint32_t rearms;				///< Number of automatic re-arms
+	uint32_t deferredRearms;		///< Number of re-arms that were deferred because no free window was available
+	uint32_t missedTriggers;		///< Number of triggers that occurred while the recorder was disarmed (0 without trigCntFct)
+	uint64_t lastDeadTime;			///< Time from the last trigger to the re-arm (0 without timeFct)
+	uint64_t maxDeadTime;			///< Maximum dead time
+	uint64_t totalDeadTime;			///< Sum of all dead times
+} PsiMsDaq_RearmStats_t;
+
+/**
+ * @brief	Performance counters of a stream (see PsiMsDaq_Str_GetMetrics())
+ * @note	On targets without lock-free 64-bit atomics, the 64-bit fields are counted in 32 bits and wrap at 2^32.
+ */
+typedef struct {
+	uint64_t windows;							///< Number of windows delivered to the window callback
+	uint64_t bytesRead;							///< Number of bytes copied from windows by the data access functions (not counted by PsiMsDaq_StrWin_GetDataRange())
+	uint64_t spuriousIrqs;						///< Number of IRQs without new windows (suppressed)
+	uint64_t skippedCallbacks;					///< Number of times windows could not be delivered because a window was not yet freed
+	uint32_t latencyHist[PSI_MS_DAQ_HIST_BINS];	///< Histogram of the latency from the trigger timestamp to the window callback (only with time source)
+	uint64_t latencySum;						///< Sum of all latencies in latencyHist
+} PsiMsDaq_StrMetrics_t;
+
+/**
+ * @brief	Performance counters of the IRQ handling (see PsiMsDaq_GetIrqMetrics())
+ * @note	On targets without lock-free 64-bit atomics, the 64-bit fields are counted in 32 bits and wrap at 2^32.
+ */
+typedef struct {
+	uint64_t irqs;								///< Number of calls to PsiMsDaq_HandleIrq()
+	uint32_t durationHist[PSI_MS_DAQ_HIST_BINS];///< Histogram of the duration of PsiMsDaq_HandleIrq() (only with time source)
+	uint64_t durationSum;						///< Sum of all durations in durationHist
+} PsiMsDaq_IrqMetrics_t;
+
 /**
  * @brief	Memory access functions struct
  */
@@ -297,7 +504,21 @@ typedef enum {
 	PsiMsDaq_RetCode_MorePostTrigThanConfigured = -8,			///< More post trigger data requested than configured to be recorded
 	PsiMsDaq_RetCode_MorePreTrigThanAvailable = -9,				///< More pre-trigger data requested than available
 	PsiMsDaq_RetCode_WinSizeMustBeMultipleOfSamples = -10,		///< Window size must be a multiple of the sample size
-	PsiMsDaq_RetCode_IrqSchemesWinAndStrAreExclusive = -11		///< Only one IRQ scheme (...Str or ...Win) can be used
+	PsiMsDaq_RetCode_IrqSchemesWinAndStrAreExclusive = -11,		///< Only one IRQ scheme (...Str, ...Win or ...Batch) can be used
+	PsiMsDaq_RetCode_WinNotRetained = -12,						///< The window was released more often than it was retained
+	PsiMsDaq_RetCode_IllegalDecimRatio = -13,					///< Illegal decimation ratio passed
+	PsiMsDaq_RetCode_StatsNotEnabled = -14,						///< Statistics are not enabled for this stream
+	PsiMsDaq_RetCode_NoStatsAvailable = -15,					///< No statistics were calculated for this window yet
+	PsiMsDaq_RetCode_CorruptData = -16,							///< Encoded data is corrupt or truncated
+	PsiMsDaq_RetCode_IllegalAlignment = -17,					///< Alignment must be a power of two and at least 8 bytes
+	PsiMsDaq_RetCode_QueueFull = -18,							///< No space in the queue, try again later
+	PsiMsDaq_RetCode_ConsumerDropped = -19,						///< The consumer was dropped because it did not keep up
+	PsiMsDaq_RetCode_PoolEmpty = -20,							///< No free buffer in the pool, release a buffer first
+	PsiMsDaq_RetCode_IllegalBuffer = -21,						///< The buffer does not belong to this pool
+	PsiMsDaq_RetCode_IllegalChLayout = -22,						///< The channel layout does not fit the stream
+	PsiMsDaq_RetCode_IllegalRegion = -23,						///< The memory region exceeds the 32-bit address space of the IP
+	PsiMsDaq_RetCode_IllegalBufferDepth = -24,					///< Illegal input buffer depth passed (must be non-zero)
+	PsiMsDaq_RetCode_NoMemory = -25								///< Memory allocation failed
 } PsiMsDaq_RetCode_t;
 
 //*******************************************************************************
@@ -311,7 +532,7 @@ typedef enum {
 * @param 	maxStreams	Maximum number of streams supported by this IP (must match setting in Vivado IPI)
 * @param 	maxWindows	Maximum number of windows per stream supported by this IP (must match setting in Vivado IPI)
 * @param	accessFct_p	Memory access functions to use (pass NULL to use the default functions)
-* @return	Driver Handle
+* @return	Driver Handle (NULL if the memory allocation failed)
 */
 PsiMsDaq_IpHandle PsiMsDaq_Init(	const uint32_t baseAddr,
 									const uint8_t maxStreams,
@@ -334,6 +555,152 @@ PsiMsDaq_RetCode_t PsiMsDaq_GetStrHandle(	PsiMsDaq_IpHandle ipHandle,
 
 void PsiMsDaq_HandleIrq(PsiMsDaq_IpHandle inst_p);
 
+/**
+ * @brief 	Set the time source used for the latency and duration histograms of the performance counters. The time
+ * 			source must return the time in the same units and time base as the window timestamps.
+ *
+ * Without a time source, only the counters are updated and the histograms stay empty.
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	timeFct		Time source (NULL to disable time measurements)
+ * @param	arg			User argument passed to the time source
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_SetTimeSource(	PsiMsDaq_IpHandle ipHandle,
+											PsiMsDaq_TimeSource_f* timeFct,
+											void* arg);
+
+/**
+ * @brief 	Set the function used to read blocks of consecutive registers (see PsiMsDaq_RegReadBlock()), e.g. in one
+ * 			bus burst. With the standard access functions (PsiMsDaq_Init() called with NULL), a standard block read
+ * 			function is used by default. With user access functions, blocks are read with single register reads
+ * 			unless a block read function is set.
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	regRdBlkFct	Block read function (NULL to use single register reads)
+ * @return	Return Code
+ *
+ * @note	This function must be called before any stream is configured.
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_SetRegReadBlock(	PsiMsDaq_IpHandle ipHandle,
+												PsiMsDaq_RegReadBlock_f* regRdBlkFct);
+
+/**
+ * @brief 	Set the function used to translate addresses on the IP bus into CPU pointers for data access. This is
+ * 			required if the CPU does not see the memory at the addresses the IP writes to. By default, no translation
+ * 			is done.
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	addrFct		Address translation function (NULL if the CPU sees the memory at the IP addresses)
+ * @return	Return Code
+ *
+ * @note	This function must be called before any stream is configured.
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_SetAddrTranslate(	PsiMsDaq_IpHandle ipHandle,
+												PsiMsDaq_AddrTranslate_f* addrFct);
+
+/**
+ * @brief 	Get the performance counters of the IRQ handling. Counters are lock-free and can be read from any thread
+ * 			while the acquisition is running.
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	metrics_p	Pointer to write the counters into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_GetIrqMetrics(	PsiMsDaq_IpHandle ipHandle,
+											PsiMsDaq_IrqMetrics_t* const metrics_p);
+
+/**
+ * @brief 	Get all windows in the history of several streams with a trigger timestamp within a range. The entries of all
+ * 			streams are returned sorted by timestamp.
+ *
+ * The history of each stream is searched by binary search, so the query takes O(log n) plus the number of entries
+ * found. The histories are merged by timestamp, so if the buffer is too small it contains the earliest entries of the
+ * range. The function can be called from any thread while the IRQ adds entries.
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	strMask		Bitmask of the streams to search (bit N = stream N)
+ * @param	tsFrom		First timestamp of the range (inclusive)
+ * @param	tsTo		Last timestamp of the range (inclusive)
+ * @param	entries_p	Buffer to write the entries into
+ * @param	maxEntries	Number of entries entries_p can hold
+ * @param	count_p		Pointer to write the number of entries returned into
+ * @return	Return Code (PsiMsDaq_RetCode_BufferTooSmall if more entries were found than entries_p can hold)
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_GetHistory(	PsiMsDaq_IpHandle ipHandle,
+										const uint32_t strMask,
+										const uint64_t tsFrom,
+										const uint64_t tsTo,
+										PsiMsDaq_HistoryEntry_t* const entries_p,
+										const uint32_t maxEntries,
+										uint32_t* const count_p);
+
+/**
+ * @brief 	Convert an address on the IP bus into a CPU pointer, using the address translation function set with
+ * 			PsiMsDaq_SetAddrTranslate() (if any). This allows direct access to recorded data (e.g. combined with
+ * 			PsiMsDaq_StrWin_GetDataRange()).
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	addr		Address on the IP bus
+ * @return	CPU pointer
+ */
+void* PsiMsDaq_AddrToPtr(	PsiMsDaq_IpHandle ipHandle,
+							const uint32_t addr);
+
+/**
+ * @brief 	Pass windows held back by the batch IRQ scheme to the user if their maximum delay expired (or all held
+ * 			back windows if no time source is set). Call this function periodically if windows are accumulated
+ * 			(PsiMsDaq_BatchConfig_t.minWindows > 1), otherwise windows may be held back until the next IRQ.
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ *
+ * @note	This function must not be called concurrently with PsiMsDaq_HandleIrq() (call it from the same thread).
+ */
+void PsiMsDaq_PollBatches(PsiMsDaq_IpHandle ipHandle);
+
+//*******************************************************************************
+// Stream Group Functions
+//*******************************************************************************
+
+/**
+ * @brief	Enable/Disable several streams at once. All streams are enabled/disabled with a single write to the
+ * 			stream enable register, so they start/stop recording in the same clock cycle.
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	strMask		Bitmask of the streams (bit N = stream N), streams not in the mask are not changed
+ * @param 	enable		true for enable, false for disable
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Grp_SetEnable(	PsiMsDaq_IpHandle ipHandle,
+											const uint32_t strMask,
+											const bool enable);
+
+/**
+ * @brief	Enable/Disable IRQ for several streams at once (single write to the IRQ enable register)
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	strMask		Bitmask of the streams (bit N = stream N), streams not in the mask are not changed
+ * @param 	irqEna		true for enable, false for disable
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Grp_SetIrqEnable(	PsiMsDaq_IpHandle ipHandle,
+												const uint32_t strMask,
+												const bool irqEna);
+
+/**
+ * @brief	Arm the recorders of several streams
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	strMask		Bitmask of the streams (bit N = stream N)
+ * @return	Return Code
+ *
+ * @note	The arm bits are located in a separate mode register per stream, so one write per stream is required.
+ * 			The writes are done back-to-back without reading any register in between, so the streams are armed
+ * 			within a few bus cycles.
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Grp_Arm(	PsiMsDaq_IpHandle ipHandle,
+										const uint32_t strMask);
+
 
 
 //*******************************************************************************
@@ -352,6 +719,71 @@ void PsiMsDaq_HandleIrq(PsiMsDaq_IpHandle inst_p);
 PsiMsDaq_RetCode_t PsiMsDaq_Str_Configure(	PsiMsDaq_StrHandle strHndl,
 											PsiMsDaq_StrConfig_t* const config_p);
 
+/**
+ * @brief	Configure the statistics engine of a stream.
+ *
+ * If enabled, PsiMsDaq_StrWin_GetDataUnwrapped() calculates statistics (mean, RMS, min/max and their positions, threshold
+ * crossings) of the data it reads in the same pass as the copy. The statistics are attached to the window and can be
+ * read with PsiMsDaq_StrWin_GetStats() until the window is freed. PsiMsDaq_StrWin_ComputeStats() calculates the
+ * statistics without copying the data to a user buffer.
+ *
+ * @param	strHndl		Driver handle for the stream
+ * @param	enable		true for enable, false for disable
+ * @param	isSigned	true if the samples are signed (two's complement)
+ * @param	threshold	Threshold for counting threshold crossings
+ * @return	Return Code
+ *
+ * @note	Only stream widths of 8, 16, 32 and 64 bits are supported. This function must be called after
+ * 			PsiMsDaq_Str_Configure().
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Str_ConfigureStats(	PsiMsDaq_StrHandle strHndl,
+												const bool enable,
+												const bool isSigned,
+												const int64_t threshold);
+
+/**
+ * @brief	Configure automatic re-arming of a stream.
+ *
+ * In PsiMsDaqn_RecMode_SingleShot and PsiMsDaqn_RecMode_TriggerMask, the recorder must be re-armed after every trigger.
+ * If automatic re-arm is enabled, PsiMsDaq_HandleIrq() re-arms the recorder as soon as it detects that a window is
+ * complete and the next window is free, before any user callback is called. So the processing time of the callbacks
+ * does not add to the dead time. If the next window is not free, re-arming is deferred until the window is
+ * freed (PsiMsDaq_StrWin_MarkAsFree(), PsiMsDaq_Str_MarkWinsAsFree() or PsiMsDaq_StrWin_Release()).
+ *
+ * The dead time (from the trigger to the re-arm) and the number of triggers missed while the recorder was disarmed
+ * can be measured (see PsiMsDaq_Str_GetRearmStats()). The IP does not count triggers while it is disarmed, so
+ * missed triggers are only counted if an external trigger counter is provided.
+ *
+ * @param	strHndl		Driver handle for the stream
+ * @param	config_p	Configuration (statistics are cleared)
+ * @return	Return Code
+ *
+ * @note	This function must be called after PsiMsDaq_Str_Configure() and before the recorder is armed the first time.
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Str_SetAutoRearm(	PsiMsDaq_StrHandle strHndl,
+												const PsiMsDaq_AutoRearmConfig_t* const config_p);
+
+/**
+ * @brief	Get the automatic re-arm statistics of a stream
+ *
+ * @param	strHndl		Driver handle for the stream
+ * @param	stats_p		Pointer to write the statistics into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Str_GetRearmStats(	PsiMsDaq_StrHandle strHndl,
+												PsiMsDaq_RearmStats_t* const stats_p);
+
+/**
+ * @brief	Get the performance counters of a stream. Counters are lock-free and can be read from any thread
+ * 			while the acquisition is running. Counters are never cleared, calculate differences to get rates.
+ *
+ * @param	strHndl		Driver handle for the stream
+ * @param	metrics_p	Pointer to write the counters into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Str_GetMetrics(	PsiMsDaq_StrHandle strHndl,
+											PsiMsDaq_StrMetrics_t* const metrics_p);
+
 /**
  * @brief	Enable/Disable a stream
  *
@@ -397,6 +829,47 @@ PsiMsDaq_RetCode_t PsiMsDaq_Str_SetIrqCallbackStr(	PsiMsDaq_StrHandle strHndl,
 													PsiMsDaqn_StrIrq_f* irqCb,
 													void* arg_p);
 
+/**
+ * @brief	Enable the history of a stream. The metadata of every window with trigger is stored in a ring of
+ * 			<i>entries</i> entries when the window is passed to the user (window and batch IRQ schemes), so it is still
+ * 			available after the window was freed. See PsiMsDaq_GetHistory() for queries.
+ *
+ * The metadata is taken from the window registers the batch IRQ scheme reads anyway. The window based IRQ scheme reads
+ * the window registers in one block access per window if the history or a time source (for latency metrics) is enabled.
+ * Queries assume trigger timestamps are increasing (as they are for one stream).
+ *
+ * @param	strHndl		Driver handle for the stream
+ * @param	entries		Number of entries in the history (0 to disable the history)
+ * @return	Return Code (PsiMsDaq_RetCode_NoMemory if the history could not be allocated, the old history is kept then)
+ *
+ * @note	The stream must be disabled (see PsiMsDaq_Str_SetEnable()) and no IRQ of the stream may be pending, since
+ * 			the history is replaced without synchronization. For the same reason, PsiMsDaq_GetHistory() must not be
+ * 			called concurrently.
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Str_SetHistory(	PsiMsDaq_StrHandle strHndl,
+											const uint32_t entries);
+
+/**
+ * @brief	Set batch interrupt callback function for a stream. Instead of one call per window, all windows that
+ * 			became ready are passed in one call, together with their metadata (read from the IP in one block
+ * 			access per window). The last written window is only re-read once per batch instead of once per window.
+ *
+ * @param	strHndl		Driver handle for the stream
+ * @param	irqCb		Callback function. Pass NULL to unregister the callback.
+ * @param	config_p	Batch configuration (NULL to pass all ready windows immediately in one call)
+ * @param 	arg_p		Arguments passed to the user callback function
+ * @return	Return Code
+ *
+ * @note	Only one IRQ scheme (...Win, ...Str or ...Batch) can be used. Like the ...Win scheme, this scheme is only
+ * 			usable if window overwriting is disabled.
+ * @note	Accumulating windows (minWindows > 1) requires PsiMsDaq_PollBatches() to be called periodically.
+ * 			The maximum delay is only applied if a time source is set (see PsiMsDaq_SetTimeSource()).
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Str_SetIrqCallbackBatch(	PsiMsDaq_StrHandle strHndl,
+														PsiMsDaqn_BatchIrq_f* irqCb,
+														const PsiMsDaq_BatchConfig_t* const config_p,
+														void* arg_p);
+
 /**
  * @brief	Enable/Disable IRQ for a stream
  *
@@ -415,6 +888,30 @@ PsiMsDaq_RetCode_t PsiMsDaq_Str_SetIrqEnable(	PsiMsDaq_StrHandle strHndl,
  */
 PsiMsDaq_RetCode_t PsiMsDaq_Str_Arm(PsiMsDaq_StrHandle strHndl);
 
+/**
+ * @brief	Mark several windows of a stream as free in one call. This is equivalent to calling
+ * 			PsiMsDaq_StrWin_MarkAsFree() for each window but cheaper (one call, no stream number lookup per window,
+ * 			registers written in address order).
+ *
+ * @param	strHndl		Driver handle for the stream
+ * @param	winMask		Bitmask of the windows to free (bit N = window N)
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Str_MarkWinsAsFree(	PsiMsDaq_StrHandle strHndl,
+												const uint32_t winMask);
+
+/**
+ * @brief	Mark several windows of a stream as free and immediately re-arm the recorder. The arm command is a single
+ * 			register write (no read-modify-write), so the dead time between freeing the windows and re-arming
+ * 			is as short as possible. This is mainly useful for PsiMsDaqn_RecMode_SingleShot.
+ *
+ * @param	strHndl		Driver handle for the stream
+ * @param	winMask		Bitmask of the windows to free (bit N = window N, may be 0 to only arm)
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Str_MarkWinsAsFreeAndArm(	PsiMsDaq_StrHandle strHndl,
+														const uint32_t winMask);
+
 
 /**
  * @brief	Get maximum input buffer fill level
@@ -492,6 +989,38 @@ PsiMsDaq_RetCode_t PsiMsDaq_Str_GetIpHandle(	PsiMsDaq_StrHandle strHndl,
 PsiMsDaq_RetCode_t PsiMsDaq_Str_GetStrNr(	PsiMsDaq_StrHandle strHndl,
 											uint8_t* strNr_p);
 
+/**
+ * @brief	Get the buffer layout of a stream (as configured by PsiMsDaq_Str_Configure())
+ *
+ * @param	strHndl			Driver handle for the stream
+ * @param 	bufStartAddr_p	Pointer to write the start address of the buffer into
+ * @param	winSize_p		Pointer to write the window size in bytes into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Str_GetBufferLayout(	PsiMsDaq_StrHandle strHndl,
+													uint32_t* const bufStartAddr_p,
+													uint32_t* const winSize_p);
+
+/**
+ * @brief	Get the number of post trigger samples of a stream (as configured by PsiMsDaq_Str_Configure())
+ *
+ * @param	strHndl				Driver handle for the stream
+ * @param 	postTrigSamples_p	Pointer to write the number of post trigger samples (including the trigger) into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Str_GetPostTrigSamples(	PsiMsDaq_StrHandle strHndl,
+													uint32_t* const postTrigSamples_p);
+
+/**
+ * @brief	Get the size of one sample of a stream in bytes (as configured by PsiMsDaq_Str_Configure())
+ *
+ * @param	strHndl			Driver handle for the stream
+ * @param 	sampleBytes_p	Pointer to write the sample size into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Str_GetSampleBytes(	PsiMsDaq_StrHandle strHndl,
+												uint8_t* const sampleBytes_p);
+
 
 //*******************************************************************************
 // Window Related Functions
@@ -555,6 +1084,108 @@ PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetDataUnwrapped(	PsiMsDaq_WinInfo_t winInfo,
 														void* const buffer_p,
 														const size_t bufferSize);
 
+/**
+ * @brief	Read the data in a window unwrapped but in chunks, without the need for a buffer that holds the whole window.
+ * 			Data is copied chunk by chunk into a small bounce buffer (PSI_MS_DAQ_CHUNK_BYTES) and passed to the
+ * 			chunk function. This allows processing data on the fly in one pass.
+ *
+ * @param	winInfo			Window information
+ * @param 	preTrigSamples	Number of pre trigger samples to read
+ * @param 	postTrigSamples	Number of post trigger samples to read (including the trigger sample)
+ * @param	chunkFct		Function called for each chunk (in order)
+ * @param	arg_p			Argument passed to the chunk function
+ * @return	Return Code
+ *
+ * @note	This function does not acknowledge the reading of the data. To do so, use PsiMsDaq_StrWin_MarkAsFree()
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetDataChunked(	PsiMsDaq_WinInfo_t winInfo,
+													const uint32_t preTrigSamples,
+													const uint32_t postTrigSamples,	//including trigger
+													PsiMsDaq_DataChunk_f* chunkFct,
+													void* arg_p);
+
+/**
+ * @brief	Get a decimated copy of the data in a window. The data is decimated while it is read from the window, so
+ * 			no buffer for the full window is required.
+ *
+ * Samples are grouped into bins of <i>ratio</i> samples (the last bin may be incomplete) and one output sample
+ * (two for PsiMsDaq_DecimMode_MinMax, minimum first) is produced per bin. Output samples have the same width as the
+ * stream. Only stream widths of 8, 16, 32 and 64 bits are supported.
+ *
+ * @param	winInfo			Window information
+ * @param 	preTrigSamples	Number of pre trigger samples to read
+ * @param 	postTrigSamples	Number of post trigger samples to read (including the trigger sample)
+ * @param	mode			Decimation mode
+ * @param	ratio			Decimation ratio (number of input samples per bin)
+ * @param	isSigned		true if the samples are signed (two's complement)
+ * @param	buffer_p		Buffer to write the decimated data into
+ * @param	bufferSize		Size of buffer_p in bytes
+ * @param	outSamples_p	Pointer to write the number of output samples into
+ * @return	Return Code
+ *
+ * @note	For 64-bit streams, the sum in PsiMsDaq_DecimMode_Average may overflow for large samples.
+ * @note	This function does not acknowledge the reading of the data. To do so, use PsiMsDaq_StrWin_MarkAsFree()
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetDataDecimated(	PsiMsDaq_WinInfo_t winInfo,
+														const uint32_t preTrigSamples,
+														const uint32_t postTrigSamples,	//including trigger
+														const PsiMsDaq_DecimMode_t mode,
+														const uint32_t ratio,
+														const bool isSigned,
+														void* const buffer_p,
+														const size_t bufferSize,
+														uint32_t* const outSamples_p);
+
+/**
+ * @brief	Get the data of a window with several channels packed into each sample as one buffer per channel (planar).
+ * 			The data is deinterleaved while it is read from the window (in chunks, see PsiMsDaq_StrWin_GetDataChunked()),
+ * 			so no extra pass over the data is required.
+ *
+ * The layout 4 x 16 bits (e.g. four ADC channels in a 64-bit stream) is deinterleaved with vector shuffles on x86-64
+ * (SSE2) and ARM (NEON), all other layouts are deinterleaved by scalar code.
+ *
+ * @param	winInfo			Window information
+ * @param 	preTrigSamples	Number of pre trigger samples to read
+ * @param 	postTrigSamples	Number of post trigger samples to read (including the trigger sample)
+ * @param	layout_p		Channel layout
+ * @param	format			Output format
+ * @param	buffers_p		Array of layout_p->channels output buffers (NULL entries skip the channel)
+ * @param	bufferSize		Size of each output buffer in bytes
+ * @return	Return Code
+ *
+ * @note	This function does not acknowledge the reading of the data. To do so, use PsiMsDaq_StrWin_MarkAsFree()
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetDataDeinterleaved(	PsiMsDaq_WinInfo_t winInfo,
+															const uint32_t preTrigSamples,
+															const uint32_t postTrigSamples,	//including trigger
+															const PsiMsDaq_ChLayout_t* const layout_p,
+															const PsiMsDaq_ChFormat_t format,
+															void* const* const buffers_p,
+															const size_t bufferSize);
+
+/**
+ * @brief	Calculate the statistics of the data in a window without copying it to a user buffer. The data is read
+ * 			in chunks (see PsiMsDaq_StrWin_GetDataChunked()). The results are attached to the window.
+ *
+ * @param	winInfo			Window information
+ * @param 	preTrigSamples	Number of pre trigger samples to include
+ * @param 	postTrigSamples	Number of post trigger samples to include (including the trigger sample)
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_ComputeStats(	PsiMsDaq_WinInfo_t winInfo,
+													const uint32_t preTrigSamples,
+													const uint32_t postTrigSamples);	//including trigger
+
+/**
+ * @brief	Get the statistics attached to a window by the last read (see PsiMsDaq_Str_ConfigureStats())
+ *
+ * @param	winInfo			Window information
+ * @param	stats_p			Pointer to write the statistics into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetStats(	PsiMsDaq_WinInfo_t winInfo,
+												PsiMsDaq_WinStats_t* const stats_p);
+
 /**
  * @brief	Mark a window as free so it can receive new data. This function must be called after the window data is read
  *
@@ -563,6 +1194,28 @@ PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetDataUnwrapped(	PsiMsDaq_WinInfo_t winInfo,
  */
 PsiMsDaq_RetCode_t PsiMsDaq_StrWin_MarkAsFree(	PsiMsDaq_WinInfo_t winInfo);
 
+/**
+ * @brief	Take a reference (lease) on a window. The window is kept recorded until all references are released
+ * 			using PsiMsDaq_StrWin_Release(). This allows passing windows to other threads and processing them
+ * 			out of order without copying the data.
+ *
+ * Reference counting is thread-safe. Usually the window callback retains the window once for every holder
+ * it passes the window to. Windows that are retained must not be freed using PsiMsDaq_StrWin_MarkAsFree().
+ *
+ * @param	winInfo			Window information
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_Retain(	PsiMsDaq_WinInfo_t winInfo);
+
+/**
+ * @brief	Release a reference taken by PsiMsDaq_StrWin_Retain(). When the last reference is released, the window
+ * 			is marked as free (exactly once).
+ *
+ * @param	winInfo			Window information
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_Release(	PsiMsDaq_WinInfo_t winInfo);
+
 /**
  * @brief	Get the address of the last sample (not byte) written into a window
  *
@@ -573,6 +1226,23 @@ PsiMsDaq_RetCode_t PsiMsDaq_StrWin_MarkAsFree(	PsiMsDaq_WinInfo_t winInfo);
 PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetLastSplAddr(	PsiMsDaq_WinInfo_t winInfo,
 													uint32_t* const lastSplAddr_p);
 
+/**
+ * @brief	Get the location of the data in a window without reading it. In ring-buffer mode, the data may wrap
+ * 			(continue at the window start after the window end). This function is required for zero-copy access to the data.
+ *
+ * @param	winInfo			Window information
+ * @param 	preTrigSamples	Number of pre trigger samples
+ * @param 	postTrigSamples	Number of post trigger samples (including the trigger sample)
+ * @param	firstByteAddr_p	Pointer to write the address of the first byte into
+ * @param	bytes_p			Pointer to write the number of bytes into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_StrWin_GetDataRange(	PsiMsDaq_WinInfo_t winInfo,
+													const uint32_t preTrigSamples,
+													const uint32_t postTrigSamples,	//including trigger
+													uint32_t* const firstByteAddr_p,
+													uint32_t* const bytes_p);
+
 //*******************************************************************************
 // Advanced Functions (only required for close control)
 //*******************************************************************************
@@ -644,6 +1314,20 @@ PsiMsDaq_RetCode_t PsiMsDaq_RegRead(	PsiMsDaq_IpHandle ipHandle,
 										const uint32_t addr,
 										uint32_t* const value_p);
 
+/**
+ * @brief	Read a block of consecutive registers
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	addr		Address of the first register
+ * @param	values_p	Buffer to write the read values into
+ * @param	count		Number of registers to read
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_RegReadBlock(	PsiMsDaq_IpHandle ipHandle,
+											const uint32_t addr,
+											uint32_t* const values_p,
+											const uint32_t count);
+
 /**
  * @brief	Set a field in a register (RMW)
  *
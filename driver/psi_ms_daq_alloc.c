@@ -0,0 +1,92 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#include "psi_ms_daq_alloc.h"
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define IP_MAX_WINDOWS		32		//Maximum number of windows per stream supported by the IP
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+static bool IsPowerOfTwo(const uint32_t x)
+{
+	return (0 != x) && (0 == (x & (x-1)));
+}
+
+static uint64_t Gcd(uint64_t a, uint64_t b)
+{
+	while (0 != b) {
+		const uint64_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+static uint64_t AlignUp(const uint64_t x, const uint64_t alignment)
+{
+	return (x + alignment - 1) / alignment * alignment;
+}
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+PsiMsDaq_RetCode_t PsiMsDaq_Alloc_Layout(	const uint32_t regionStart,
+											const uint32_t regionSize,
+											const uint32_t burstBytes,
+											const uint32_t cacheLineBytes,
+											const PsiMsDaq_AllocReq_t* const reqs_p,
+											const uint8_t streams,
+											PsiMsDaq_StrConfig_t* const configs_p,
+											uint32_t* const usedBytes_p)
+{
+	//Checks
+	if (!IsPowerOfTwo(burstBytes) || !IsPowerOfTwo(cacheLineBytes)) {
+		return PsiMsDaq_RetCode_IllegalAlignment;
+	}
+	const uint64_t align = (burstBytes > cacheLineBytes) ? burstBytes : cacheLineBytes;
+	if (align < 8) {
+		return PsiMsDaq_RetCode_IllegalAlignment;
+	}
+	if ((uint64_t)regionStart + regionSize > ((uint64_t)1 << 32)) {
+		return PsiMsDaq_RetCode_IllegalRegion;
+	}
+	for (uint8_t i = 0; i < streams; i++) {
+		if ((0 == reqs_p[i].streamWidthBits) || (0 != (reqs_p[i].streamWidthBits % 8))) {
+			return PsiMsDaq_RetCode_IllegalStrWidth;
+		}
+		if ((0 == reqs_p[i].winCnt) || (reqs_p[i].winCnt > IP_MAX_WINDOWS)) {
+			return PsiMsDaq_RetCode_IllegalWinCnt;
+		}
+	}
+	//Implementation
+	const uint64_t start = AlignUp(regionStart, align);
+	const uint64_t end = (uint64_t)regionStart + regionSize;
+	uint64_t addr = start;
+	for (uint8_t i = 0; i < streams; i++) {
+		//Window size granularity is the least common multiple of the alignment and the sample size
+		const uint64_t widthBytes = reqs_p[i].streamWidthBits/8;
+		const uint64_t granule = align / Gcd(align, widthBytes) * widthBytes;
+		const uint64_t winSize = AlignUp((uint64_t)reqs_p[i].windowSamples*widthBytes, granule);
+		const uint64_t bufSize = winSize*reqs_p[i].winCnt;
+		if ((winSize > UINT32_MAX) || (addr + bufSize > end)) {
+			return PsiMsDaq_RetCode_BufferTooSmall;
+		}
+		configs_p[i].bufStartAddr = (uint32_t)addr;
+		configs_p[i].winSize = (uint32_t)winSize;
+		configs_p[i].winCnt = reqs_p[i].winCnt;
+		configs_p[i].streamWidthBits = reqs_p[i].streamWidthBits;
+		addr += bufSize;
+	}
+	if (NULL != usedBytes_p) {
+		*usedBytes_p = (uint32_t)(addr - regionStart);
+	}
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
@@ -0,0 +1,91 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Automatic DMA buffer layout
+*
+* The allocator lays out the buffers of several streams in one DMA memory region and fills the buffer related
+* fields of PsiMsDaq_StrConfig_t (bufStartAddr, winSize, winCnt, streamWidthBits). All other fields
+* (postTrigSamples, recMode, ...) are left untouched, so they can be set before or after the layout is calculated.
+*
+* Every window starts at an address aligned to the larger of the AXI burst size and the cache line size. Windows
+* that are not aligned to the burst size require the IP to split bursts at 4k boundaries, which reduces the memory
+* bandwidth. Aligned windows also allow invalidating caches per window without affecting neighbouring windows.
+*
+* The window size is rounded up to the smallest multiple of the alignment that contains a whole number of samples
+* and is at least as large as requested. Since all windows are multiples of the alignment, the buffers of all
+* streams can be packed back-to-back without any gaps, so the only memory wasted is the rounding of the window size.
+*
+* Example:
+*
+*    PsiMsDaq_AllocReq_t reqs[2] = {{.windowSamples = 1000, .winCnt = 8, .streamWidthBits = 16},
+*                                   {.windowSamples = 300,  .winCnt = 4, .streamWidthBits = 24}};
+*    PsiMsDaq_StrConfig_t cfg[2];
+*    uint32_t used;
+*    PsiMsDaq_Alloc_Layout(0x10000000, 0x100000, 4096, 64, reqs, 2, cfg, &used);
+*    cfg[0].postTrigSamples = 100;
+*    ...
+*    PsiMsDaq_Str_Configure(str0, &cfg[0]);
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq.h"
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+/**
+ * @brief	Buffer requirements of one stream
+ */
+typedef struct {
+	uint32_t windowSamples;		///< Minimum number of samples per window
+	uint8_t winCnt;				///< Number of windows (1 ... 32)
+	uint16_t streamWidthBits;	///< Width of the stream in bits (must be a multiple of 8)
+} PsiMsDaq_AllocReq_t;
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+
+/**
+ * @brief	Calculate the buffer layout for several streams
+ *
+ * @param	regionStart		Start address of the DMA region (as seen by the IP)
+ * @param	regionSize		Size of the DMA region in bytes
+ * @param	burstBytes		AXI burst size in bytes (usually MaxBurstSize_g*8, power of two)
+ * @param	cacheLineBytes	Cache line size of the CPU in bytes (power of two)
+ * @param	reqs_p			Array of stream requirements
+ * @param	streams			Number of entries in reqs_p and configs_p
+ * @param	configs_p		Array of stream configurations to fill
+ * @param	usedBytes_p		Pointer to write the number of bytes used in the region into (may be NULL)
+ * @return	Return Code (PsiMsDaq_RetCode_BufferTooSmall if the region is too small, PsiMsDaq_RetCode_IllegalRegion if
+ * 			it exceeds the 32-bit address space)
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Alloc_Layout(	const uint32_t regionStart,
+											const uint32_t regionSize,
+											const uint32_t burstBytes,
+											const uint32_t cacheLineBytes,
+											const PsiMsDaq_AllocReq_t* const reqs_p,
+											const uint8_t streams,
+											PsiMsDaq_StrConfig_t* const configs_p,
+											uint32_t* const usedBytes_p);
+
+#ifdef __cplusplus
+}
+#endif
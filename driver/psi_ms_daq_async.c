@@ -0,0 +1,175 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#include "psi_ms_daq_async.h"
+#include "psi_ms_daq_atomic.h"
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef struct {
+	PsiMsDaq_IpHandle ipHandle;
+	int evtFd;
+	pthread_mutex_t irqLock;
+	uint32_t queueSize;
+	uint32_t queueMsk;
+	uint32_t windowsAttached;
+	PsiMsDaq_WinInfo_t* queue;
+	atomic_uint_fast32_t head;	//written by IRQ thread only
+	atomic_uint_fast32_t tail;	//written by event loop only
+} PsiMsDaq_AsyncInst_t;
+
+//*******************************************************************************
+// Macros
+//*******************************************************************************
+#define SAFE_CALL(fctCall) { \
+		PsiMsDaq_RetCode_t r = fctCall; \
+		if (PsiMsDaq_RetCode_Success != r) {return r;}}
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+static void AsyncWinIrq(PsiMsDaq_WinInfo_t winInfo, void* arg)
+{
+	//Pointer Cast
+	PsiMsDaq_AsyncInst_t* inst_p = (PsiMsDaq_AsyncInst_t*) arg;
+	//Enqueue (cannot overflow since the queue is larger than the number of windows attached)
+	const uint_fast32_t head = atomic_load_explicit(&inst_p->head, memory_order_relaxed);
+	inst_p->queue[head & inst_p->queueMsk] = winInfo;
+	atomic_store_explicit(&inst_p->head, head+1, memory_order_release);
+	//Wake up event loop
+	const uint64_t one = 1;
+	ssize_t r = write(inst_p->evtFd, &one, sizeof(one));
+	(void)r;
+}
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+PsiMsDaq_AsyncHandle PsiMsDaq_Async_Create(	PsiMsDaq_IpHandle ipHandle,
+											const uint32_t queueSize)
+{
+	//Queue size is rounded up to a power of two to allow cheap masking
+	uint32_t size = 1;
+	while (size < queueSize) {
+		size *= 2;
+	}
+	//Initialization and allocation
+	PsiMsDaq_AsyncInst_t* inst_p = (PsiMsDaq_AsyncInst_t*) malloc(sizeof(PsiMsDaq_AsyncInst_t));
+	if (NULL == inst_p) {
+		return NULL;
+	}
+	inst_p->queue = (PsiMsDaq_WinInfo_t*) malloc(sizeof(PsiMsDaq_WinInfo_t)*size);
+	inst_p->evtFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if ((NULL == inst_p->queue) || (inst_p->evtFd < 0)) {
+		if (inst_p->evtFd >= 0) {
+			close(inst_p->evtFd);
+		}
+		free(inst_p->queue);
+		free(inst_p);
+		return NULL;
+	}
+	pthread_mutex_init(&inst_p->irqLock, NULL);
+	inst_p->ipHandle = ipHandle;
+	inst_p->queueSize = queueSize;
+	inst_p->queueMsk = size-1;
+	inst_p->windowsAttached = 0;
+	atomic_init(&inst_p->head, 0);
+	atomic_init(&inst_p->tail, 0);
+	return (PsiMsDaq_AsyncHandle) inst_p;
+}
+
+void PsiMsDaq_Async_Destroy(PsiMsDaq_AsyncHandle asyncHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_AsyncInst_t* inst_p = (PsiMsDaq_AsyncInst_t*) asyncHandle;
+	//Implementation
+	close(inst_p->evtFd);
+	pthread_mutex_destroy(&inst_p->irqLock);
+	free(inst_p->queue);
+	free(inst_p);
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Async_AttachStream(	PsiMsDaq_AsyncHandle asyncHandle,
+												PsiMsDaq_StrHandle strHndl)
+{
+	//Pointer Cast
+	PsiMsDaq_AsyncInst_t* inst_p = (PsiMsDaq_AsyncInst_t*) asyncHandle;
+	//Checks
+	uint8_t windows;
+	SAFE_CALL(PsiMsDaq_Str_GetTotalWindows(strHndl, &windows));
+	if (inst_p->windowsAttached + windows > inst_p->queueSize) {
+		return PsiMsDaq_RetCode_BufferTooSmall;
+	}
+	//Implementation
+	SAFE_CALL(PsiMsDaq_Str_SetIrqCallbackWin(strHndl, AsyncWinIrq, inst_p));
+	inst_p->windowsAttached += windows;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+int PsiMsDaq_Async_GetFd(PsiMsDaq_AsyncHandle asyncHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_AsyncInst_t* inst_p = (PsiMsDaq_AsyncInst_t*) asyncHandle;
+	//Implementation
+	return inst_p->evtFd;
+}
+
+void PsiMsDaq_Async_HandleIrq(PsiMsDaq_AsyncHandle asyncHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_AsyncInst_t* inst_p = (PsiMsDaq_AsyncInst_t*) asyncHandle;
+	//Implementation
+	pthread_mutex_lock(&inst_p->irqLock);
+	PsiMsDaq_HandleIrq(inst_p->ipHandle);
+	pthread_mutex_unlock(&inst_p->irqLock);
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Async_Pop(	PsiMsDaq_AsyncHandle asyncHandle,
+										PsiMsDaq_WinInfo_t* const winInfo_p,
+										bool* const available_p)
+{
+	//Pointer Cast
+	PsiMsDaq_AsyncInst_t* inst_p = (PsiMsDaq_AsyncInst_t*) asyncHandle;
+	//Implementation
+	const uint_fast32_t tail = atomic_load_explicit(&inst_p->tail, memory_order_relaxed);
+	uint_fast32_t head = atomic_load_explicit(&inst_p->head, memory_order_acquire);
+	//If the queue is empty, clear the eventfd and check again. Windows enqueued after the clear
+	//make the eventfd readable again, so no wakeup can be lost.
+	if (head == tail) {
+		uint64_t cnt;
+		ssize_t r = read(inst_p->evtFd, &cnt, sizeof(cnt));
+		(void)r;
+		head = atomic_load_explicit(&inst_p->head, memory_order_acquire);
+		if (head == tail) {
+			*available_p = false;
+			return PsiMsDaq_RetCode_Success;
+		}
+	}
+	*winInfo_p = inst_p->queue[tail & inst_p->queueMsk];
+	atomic_store_explicit(&inst_p->tail, tail+1, memory_order_release);
+	*available_p = true;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Async_MarkAsFree(	PsiMsDaq_AsyncHandle asyncHandle,
+												PsiMsDaq_WinInfo_t winInfo)
+{
+	//Pointer Cast
+	PsiMsDaq_AsyncInst_t* inst_p = (PsiMsDaq_AsyncInst_t*) asyncHandle;
+	//Implementation
+	pthread_mutex_lock(&inst_p->irqLock);
+	const PsiMsDaq_RetCode_t r = PsiMsDaq_StrWin_MarkAsFree(winInfo);
+	pthread_mutex_unlock(&inst_p->irqLock);
+	//Done
+	return r;
+}
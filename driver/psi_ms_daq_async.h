@@ -0,0 +1,130 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Event-loop integration of the window based IRQ scheme (Linux only)
+*
+* This module bridges the window based IRQ scheme into an event loop (e.g. epoll). The thread that
+* waits for the IP interrupt (e.g. a blocking read on a UIO device) calls PsiMsDaq_Async_HandleIrq()
+* instead of PsiMsDaq_HandleIrq(). Completed windows are put into a lock-free queue and the event loop is
+* woken up through an eventfd (see PsiMsDaq_Async_GetFd()). The event loop then fetches the windows
+* by calling PsiMsDaq_Async_Pop() until no more windows are available and frees them with
+* PsiMsDaq_Async_MarkAsFree() once they are processed. Windows can be processed in any order.
+*
+* The queue only transports PsiMsDaq_WinInfo_t structs (no data is copied). Since every window is in the
+* queue at most once until it is freed, no windows can be lost as long as the queue is large enough to hold
+* all windows of all attached streams (this is checked by PsiMsDaq_Async_AttachStream()).
+*
+* PsiMsDaq_Async_HandleIrq() and PsiMsDaq_Async_MarkAsFree() are protected against each other by a mutex,
+* so they can be called from different threads. All other driver functions are not protected
+* (see @ref thread_safety).
+*
+* For C++20 users, psi_ms_daq_async.hpp provides an awaitable wrapper on top of this module.
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq.h"
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef void* PsiMsDaq_AsyncHandle;	///< Handle to an event-loop bridge instance
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+
+/**
+ * @brief	Create an event-loop bridge for an IP
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	queueSize	Number of windows the queue can hold (must be at least the total number of windows of all
+ * 						streams attached)
+ * @return	Handle of the bridge or NULL if the creation failed
+ */
+PsiMsDaq_AsyncHandle PsiMsDaq_Async_Create(	PsiMsDaq_IpHandle ipHandle,
+											const uint32_t queueSize);
+
+/**
+ * @brief	Destroy an event-loop bridge
+ *
+ * @param	asyncHandle	Handle of the bridge
+ *
+ * @note	The window callbacks of all attached streams must be unregistered (or the IRQs disabled) before
+ * 			this function is called.
+ */
+void PsiMsDaq_Async_Destroy(PsiMsDaq_AsyncHandle asyncHandle);
+
+/**
+ * @brief	Route all windows of a stream through the bridge. This registers a window based IRQ callback for
+ * 			the stream, so the stream must not use any other callback.
+ *
+ * @param	asyncHandle	Handle of the bridge
+ * @param	strHndl		Driver handle for the stream (must be configured already)
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Async_AttachStream(	PsiMsDaq_AsyncHandle asyncHandle,
+												PsiMsDaq_StrHandle strHndl);
+
+/**
+ * @brief	Get the eventfd that becomes readable whenever new windows are available. This file descriptor
+ * 			is meant to be registered in the event loop (EPOLLIN). It must not be read by the user.
+ *
+ * @param	asyncHandle	Handle of the bridge
+ * @return	File descriptor
+ */
+int PsiMsDaq_Async_GetFd(PsiMsDaq_AsyncHandle asyncHandle);
+
+/**
+ * @brief	IRQ handling function to be called instead of PsiMsDaq_HandleIrq() whenever the IP
+ * 			asserts its interrupt. This function is usually called from a separate IRQ thread.
+ *
+ * @param	asyncHandle	Handle of the bridge
+ */
+void PsiMsDaq_Async_HandleIrq(PsiMsDaq_AsyncHandle asyncHandle);
+
+/**
+ * @brief	Fetch the next completed window (non-blocking). Must be called from the event loop only.
+ *
+ * @param	asyncHandle	Handle of the bridge
+ * @param	winInfo_p	Pointer to write the window information into
+ * @param	available_p	Pointer to write to whether a window was available
+ * @return	Return Code
+ *
+ * @note	If no window is available, the eventfd is cleared. So this function should be called until it
+ * 			reports that no window is available whenever the eventfd becomes readable.
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Async_Pop(	PsiMsDaq_AsyncHandle asyncHandle,
+										PsiMsDaq_WinInfo_t* const winInfo_p,
+										bool* const available_p);
+
+/**
+ * @brief	Mark a window fetched by PsiMsDaq_Async_Pop() as free (thread-safe replacement of
+ * 			PsiMsDaq_StrWin_MarkAsFree()).
+ *
+ * @param	asyncHandle	Handle of the bridge
+ * @param	winInfo		Window information
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Async_MarkAsFree(	PsiMsDaq_AsyncHandle asyncHandle,
+												PsiMsDaq_WinInfo_t winInfo);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,164 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/*
+* C++20 coroutine wrapper of psi_ms_daq_async.h (Linux only).
+*
+* Usage:
+*
+*    psi_ms_daq::AsyncBridge bridge(ipHandle, 64);
+*    psi_ms_daq::AsyncStream& str = bridge.attach(strHandle);
+*    //Register bridge.fd() in epoll and call bridge.dispatch() whenever it is readable.
+*    //Call bridge.handle_irq() from the IRQ thread.
+*
+*    Task process(psi_ms_daq::AsyncStream& str) {
+*       while (true) {
+*          psi_ms_daq::Window win = co_await str.next_window();
+*          ...                   //window is freed when win is destroyed
+*       }
+*    }
+*
+* Only one coroutine may await a given stream at a time. All members except handle_irq() must be
+* called from the event loop thread.
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq_async.h"
+#include <coroutine>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace psi_ms_daq {
+
+//*******************************************************************************
+// Window (movable handle, frees the window on destruction)
+//*******************************************************************************
+class Window {
+public:
+	Window() = default;
+	Window(PsiMsDaq_AsyncHandle async, PsiMsDaq_WinInfo_t info) : async_(async), info_(info) {}
+	Window(const Window&) = delete;
+	Window& operator=(const Window&) = delete;
+	Window(Window&& other) noexcept : async_(std::exchange(other.async_, nullptr)), info_(other.info_) {}
+	Window& operator=(Window&& other) noexcept {
+		if (this != &other) {
+			release();
+			async_ = std::exchange(other.async_, nullptr);
+			info_ = other.info_;
+		}
+		return *this;
+	}
+	~Window() { release(); }
+
+	const PsiMsDaq_WinInfo_t& info() const { return info_; }
+	explicit operator bool() const { return nullptr != async_; }
+
+	void release() {
+		if (nullptr != async_) {
+			PsiMsDaq_Async_MarkAsFree(async_, info_);
+			async_ = nullptr;
+		}
+	}
+
+private:
+	PsiMsDaq_AsyncHandle async_ = nullptr;
+	PsiMsDaq_WinInfo_t info_ = {};
+};
+
+//*******************************************************************************
+// Stream (awaitable source of windows)
+//*******************************************************************************
+class AsyncStream {
+public:
+	explicit AsyncStream(PsiMsDaq_AsyncHandle async) : async_(async) {}
+	AsyncStream(const AsyncStream&) = delete;
+	AsyncStream& operator=(const AsyncStream&) = delete;
+
+	struct Awaiter {
+		AsyncStream& str;
+		bool await_ready() const noexcept { return !str.ready_.empty(); }
+		void await_suspend(std::coroutine_handle<> h) noexcept { str.waiter_ = h; }
+		Window await_resume() {
+			PsiMsDaq_WinInfo_t info = str.ready_.front();
+			str.ready_.pop_front();
+			return Window(str.async_, info);
+		}
+	};
+
+	Awaiter next_window() { return Awaiter{*this}; }
+
+private:
+	friend class AsyncBridge;
+	PsiMsDaq_AsyncHandle async_;
+	std::deque<PsiMsDaq_WinInfo_t> ready_;
+	std::coroutine_handle<> waiter_;
+};
+
+//*******************************************************************************
+// Bridge (owns the C bridge and routes windows to the streams)
+//*******************************************************************************
+class AsyncBridge {
+public:
+	AsyncBridge(PsiMsDaq_IpHandle ipHandle, uint32_t queueSize)
+		: async_(PsiMsDaq_Async_Create(ipHandle, queueSize)) {
+		if (nullptr == async_) {
+			throw std::runtime_error("PsiMsDaq_Async_Create() failed");
+		}
+	}
+	AsyncBridge(const AsyncBridge&) = delete;
+	AsyncBridge& operator=(const AsyncBridge&) = delete;
+	~AsyncBridge() { PsiMsDaq_Async_Destroy(async_); }
+
+	AsyncStream& attach(PsiMsDaq_StrHandle strHndl) {
+		if (PsiMsDaq_RetCode_Success != PsiMsDaq_Async_AttachStream(async_, strHndl)) {
+			throw std::runtime_error("PsiMsDaq_Async_AttachStream() failed");
+		}
+		auto& str = streams_[strHndl];
+		str = std::make_unique<AsyncStream>(async_);
+		return *str;
+	}
+
+	int fd() const { return PsiMsDaq_Async_GetFd(async_); }
+
+	void handle_irq() { PsiMsDaq_Async_HandleIrq(async_); }
+
+	//Call whenever fd() is readable
+	void dispatch() {
+		PsiMsDaq_WinInfo_t info;
+		bool available;
+		while ((PsiMsDaq_RetCode_Success == PsiMsDaq_Async_Pop(async_, &info, &available)) && available) {
+			streams_.at(info.strHandle)->ready_.push_back(info);
+		}
+		//Resume after routing all windows, so resumed coroutines see a consistent state
+		std::vector<std::coroutine_handle<>> resume;
+		for (auto& entry : streams_) {
+			AsyncStream& str = *entry.second;
+			if (str.waiter_ && !str.ready_.empty()) {
+				resume.push_back(std::exchange(str.waiter_, nullptr));
+			}
+		}
+		for (auto h : resume) {
+			h.resume();
+		}
+	}
+
+private:
+	PsiMsDaq_AsyncHandle async_;
+	std::unordered_map<PsiMsDaq_StrHandle, std::unique_ptr<AsyncStream>> streams_;
+};
+
+} //namespace psi_ms_daq
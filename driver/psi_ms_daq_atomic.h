@@ -0,0 +1,86 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Atomics used internally by the driver (not part of the API)
+*
+* C11 atomics (<stdatomic.h>) cannot be included by C++ compilers before C++23, but the driver sources must stay
+* compilable as C++. When compiled as C++, the C11 names used by the driver (atomic_uint_fast32_t, atomic_load_explicit(),
+* memory_order_relaxed, ...) are mapped to their std::atomic equivalents from <atomic>, which are layout compatible.
+*
+* Statistics counters use PsiMsDaq_AtomicCnt_t. It is 64 bits wide where 64-bit atomics are lock-free and 32 bits wide
+* otherwise (e.g. on Cortex-M or 32-bit targets without 64-bit exclusive accesses), so counters updated from the IRQ
+* never take a lock. On such targets the counters wrap at 2^32.
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#ifdef __cplusplus
+	#include <atomic>
+	#include <cstdint>
+#else
+	#include <stdatomic.h>
+	#include <stdint.h>
+#endif
+
+//*******************************************************************************
+// C11 names in C++
+//*******************************************************************************
+#ifdef __cplusplus
+	using std::atomic_bool;
+	using std::atomic_int;
+	using std::atomic_uint;
+	using std::atomic_uchar;
+	using std::atomic_uint_fast16_t;
+	using std::atomic_uint_fast32_t;
+	using std::atomic_uint_least32_t;
+	using std::atomic_uint_least64_t;
+	using std::memory_order_relaxed;
+	using std::memory_order_acquire;
+	using std::memory_order_release;
+	using std::memory_order_acq_rel;
+	using std::memory_order_seq_cst;
+	using std::atomic_init;
+	using std::atomic_load;
+	using std::atomic_load_explicit;
+	using std::atomic_store;
+	using std::atomic_store_explicit;
+	using std::atomic_exchange;
+	using std::atomic_exchange_explicit;
+	using std::atomic_compare_exchange_strong;
+	using std::atomic_compare_exchange_weak;
+	using std::atomic_compare_exchange_weak_explicit;
+	using std::atomic_fetch_add;
+	using std::atomic_fetch_add_explicit;
+	using std::atomic_fetch_and;
+	using std::atomic_fetch_or;
+	using std::atomic_thread_fence;
+#endif
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+#if (2 == ATOMIC_LLONG_LOCK_FREE)
+	typedef atomic_uint_least64_t PsiMsDaq_AtomicCnt_t;		///< Statistics counter (64 bits)
+	typedef uint_least64_t PsiMsDaq_Cnt_t;					///< Value of a statistics counter
+#else
+	typedef atomic_uint_least32_t PsiMsDaq_AtomicCnt_t;		///< Statistics counter (32 bits, 64-bit atomics are not lock-free)
+	typedef uint_least32_t PsiMsDaq_Cnt_t;					///< Value of a statistics counter
+#endif
+
+#ifdef __cplusplus
+	typedef std::atomic<float> PsiMsDaq_AtomicFloat_t;		///< Atomic float (C11 has no typedef for it)
+#else
+	typedef _Atomic float PsiMsDaq_AtomicFloat_t;			///< Atomic float (C11 has no typedef for it)
+#endif
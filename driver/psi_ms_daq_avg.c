@@ -0,0 +1,272 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#include "psi_ms_daq_avg.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+//Unsigned 128 bit integer (portable, __int128 is not available on 32 bit targets)
+typedef struct {
+	uint64_t lo;
+	uint64_t hi;
+} Uint128_t;
+
+typedef struct {
+	int64_t* sum_p;
+	void* sumSq_p;				//int64_t for 8 and 16 bit samples, Uint128_t for 32 bit samples (both exact)
+} AvgState_t;
+
+typedef struct {
+	PsiMsDaq_StrHandle strHndl;
+	PsiMsDaq_DataChunk_f* chunkFct;
+	pthread_mutex_t lock;
+	uint32_t preTrig;
+	uint32_t samples;
+	int64_t* sum_p;
+	void* sumSq_p;
+	bool sqIsInt;
+	uint32_t* startHist_p;		//Number of windows per first sample position (pre-trigger shorter than configured)
+	uint64_t windows;
+	uint64_t skipped;
+} PsiMsDaq_AvgInst_t;
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+
+//Accumulation kernels, one per sample type. The loops run over contiguous samples and are auto-vectorized.
+#define AVG_CHUNK_FCT(name, T) \
+static void name(const void* data_p, const uint32_t samples, const uint32_t firstSpl, void* arg_p) \
+{ \
+	AvgState_t* s = (AvgState_t*) arg_p; \
+	const T* in = (const T*) data_p; \
+	int64_t* const sum = s->sum_p+firstSpl; \
+	int64_t* const sumSq = (int64_t*)s->sumSq_p+firstSpl; \
+	for (uint32_t k = 0; k < samples; k++) { \
+		sum[k] += in[k]; \
+		sumSq[k] += (int64_t)in[k]*(int64_t)in[k]; \
+	} \
+}
+
+//32 bit samples: squares are up to 64 bits, so the sum of squares is accumulated in 128 bits. SQ_T is the type the
+//square is calculated in (uint64_t for unsigned samples, int64_t for signed samples, so neither overflows).
+#define AVG_CHUNK_FCT_WIDE(name, T, SQ_T) \
+static void name(const void* data_p, const uint32_t samples, const uint32_t firstSpl, void* arg_p) \
+{ \
+	AvgState_t* s = (AvgState_t*) arg_p; \
+	const T* in = (const T*) data_p; \
+	int64_t* const sum = s->sum_p+firstSpl; \
+	Uint128_t* const sumSq = (Uint128_t*)s->sumSq_p+firstSpl; \
+	for (uint32_t k = 0; k < samples; k++) { \
+		const uint64_t sq = (uint64_t)((SQ_T)in[k]*(SQ_T)in[k]); \
+		sum[k] += in[k]; \
+		sumSq[k].lo += sq; \
+		sumSq[k].hi += (sumSq[k].lo < sq); \
+	} \
+}
+
+AVG_CHUNK_FCT(AvgChunk_U8, uint8_t)
+AVG_CHUNK_FCT(AvgChunk_S8, int8_t)
+AVG_CHUNK_FCT(AvgChunk_U16, uint16_t)
+AVG_CHUNK_FCT(AvgChunk_S16, int16_t)
+AVG_CHUNK_FCT_WIDE(AvgChunk_U32, uint32_t, uint64_t)
+AVG_CHUNK_FCT_WIDE(AvgChunk_S32, int32_t, int64_t)
+
+static Uint128_t Mul64(const uint64_t a, const uint64_t b)
+{
+	const uint64_t ll = (a & 0xFFFFFFFF)*(b & 0xFFFFFFFF);
+	const uint64_t lh = (a & 0xFFFFFFFF)*(b >> 32);
+	const uint64_t hl = (a >> 32)*(b & 0xFFFFFFFF);
+	const uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+	Uint128_t r;
+	r.lo = (mid << 32) | (ll & 0xFFFFFFFF);
+	r.hi = (a >> 32)*(b >> 32) + (lh >> 32) + (hl >> 32) + (mid >> 32);
+	return r;
+}
+
+//Variance from exact sums: (count*sumSq - sum^2) / count^2. The numerator is calculated exactly in 128 bits
+//(count*sumSq < 2^128), so there is no cancellation for signals with a large offset.
+static double Variance(const int64_t sum, const Uint128_t sumSq, const uint32_t count)
+{
+	Uint128_t a = Mul64(sumSq.lo, count);
+	a.hi += sumSq.hi*count;
+	const uint64_t absSum = (sum < 0) ? -(uint64_t)sum : (uint64_t)sum;
+	const Uint128_t b = Mul64(absSum, absSum);
+	Uint128_t num;
+	num.lo = a.lo - b.lo;
+	num.hi = a.hi - b.hi - (a.lo < b.lo);
+	return ((double)num.hi*18446744073709551616.0 + (double)num.lo) / ((double)count*count);
+}
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+PsiMsDaq_AvgHandle PsiMsDaq_Avg_Create(	PsiMsDaq_StrHandle strHndl,
+										const uint32_t preTrigSamples,
+										const bool isSigned)
+{
+	//Checks
+	uint32_t postTrig;
+	uint8_t sampleBytes;
+	if ((PsiMsDaq_RetCode_Success != PsiMsDaq_Str_GetPostTrigSamples(strHndl, &postTrig)) ||
+		(PsiMsDaq_RetCode_Success != PsiMsDaq_Str_GetSampleBytes(strHndl, &sampleBytes))) {
+		return NULL;
+	}
+	PsiMsDaq_DataChunk_f* chunkFct;
+	switch (sampleBytes) {
+		case 1: chunkFct = isSigned ? AvgChunk_S8 : AvgChunk_U8; break;
+		case 2: chunkFct = isSigned ? AvgChunk_S16 : AvgChunk_U16; break;
+		case 4: chunkFct = isSigned ? AvgChunk_S32 : AvgChunk_U32; break;
+		default: return NULL;
+	}
+	if (0 == preTrigSamples+postTrig) {
+		return NULL;
+	}
+	//Initialization and allocation
+	PsiMsDaq_AvgInst_t* inst_p = (PsiMsDaq_AvgInst_t*) malloc(sizeof(PsiMsDaq_AvgInst_t));
+	if (NULL == inst_p) {
+		return NULL;
+	}
+	inst_p->strHndl = strHndl;
+	inst_p->chunkFct = chunkFct;
+	inst_p->preTrig = preTrigSamples;
+	inst_p->samples = preTrigSamples+postTrig;
+	inst_p->sum_p = (int64_t*) malloc(sizeof(int64_t)*inst_p->samples);
+	inst_p->sqIsInt = (sampleBytes < 4);
+	inst_p->sumSq_p = malloc((inst_p->sqIsInt ? sizeof(int64_t) : sizeof(Uint128_t))*inst_p->samples);
+	inst_p->startHist_p = (uint32_t*) malloc(sizeof(uint32_t)*(preTrigSamples+1));
+	if ((NULL == inst_p->sum_p) || (NULL == inst_p->sumSq_p) || (NULL == inst_p->startHist_p)) {
+		free(inst_p->sum_p);
+		free(inst_p->sumSq_p);
+		free(inst_p->startHist_p);
+		free(inst_p);
+		return NULL;
+	}
+	pthread_mutex_init(&inst_p->lock, NULL);
+	PsiMsDaq_Avg_Reset(inst_p);
+	return (PsiMsDaq_AvgHandle) inst_p;
+}
+
+void PsiMsDaq_Avg_Destroy(PsiMsDaq_AvgHandle avgHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_AvgInst_t* inst_p = (PsiMsDaq_AvgInst_t*) avgHandle;
+	//Implementation
+	pthread_mutex_destroy(&inst_p->lock);
+	free(inst_p->sum_p);
+	free(inst_p->sumSq_p);
+	free(inst_p->startHist_p);
+	free(inst_p);
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Avg_AddWindow(	PsiMsDaq_AvgHandle avgHandle,
+											PsiMsDaq_WinInfo_t winInfo)
+{
+	//Pointer Cast
+	PsiMsDaq_AvgInst_t* inst_p = (PsiMsDaq_AvgInst_t*) avgHandle;
+	//Checks
+	uint32_t preTrig;
+	const PsiMsDaq_RetCode_t r = PsiMsDaq_StrWin_GetPreTrigSamples(winInfo, &preTrig);
+	if (PsiMsDaq_RetCode_Success != r) {
+		pthread_mutex_lock(&inst_p->lock);
+		inst_p->skipped++;
+		pthread_mutex_unlock(&inst_p->lock);
+		return r;
+	}
+	//Implementation (windows with less pre-trigger data start at a later sample position)
+	preTrig = (preTrig > inst_p->preTrig) ? inst_p->preTrig : preTrig;
+	const uint32_t start = inst_p->preTrig-preTrig;
+	pthread_mutex_lock(&inst_p->lock);
+	AvgState_t state;
+	state.sum_p = inst_p->sum_p+start;
+	state.sumSq_p = inst_p->sqIsInt ? (void*)((int64_t*)inst_p->sumSq_p+start) : (void*)((Uint128_t*)inst_p->sumSq_p+start);
+	const PsiMsDaq_RetCode_t rd = PsiMsDaq_StrWin_GetDataChunked(winInfo, preTrig, inst_p->samples-inst_p->preTrig, inst_p->chunkFct, &state);
+	if (PsiMsDaq_RetCode_Success == rd) {
+		inst_p->startHist_p[start]++;
+		inst_p->windows++;
+	}
+	pthread_mutex_unlock(&inst_p->lock);
+	//Done
+	return rd;
+}
+
+void PsiMsDaq_Avg_WinCallback(	PsiMsDaq_WinInfo_t winInfo,
+								void* arg)
+{
+	PsiMsDaq_Avg_AddWindow((PsiMsDaq_AvgHandle) arg, winInfo);
+	PsiMsDaq_StrWin_MarkAsFree(winInfo);
+}
+
+void PsiMsDaq_Avg_Reset(PsiMsDaq_AvgHandle avgHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_AvgInst_t* inst_p = (PsiMsDaq_AvgInst_t*) avgHandle;
+	//Implementation
+	pthread_mutex_lock(&inst_p->lock);
+	memset(inst_p->sum_p, 0, sizeof(int64_t)*inst_p->samples);
+	memset(inst_p->sumSq_p, 0, (inst_p->sqIsInt ? sizeof(int64_t) : sizeof(Uint128_t))*inst_p->samples);
+	memset(inst_p->startHist_p, 0, sizeof(uint32_t)*(inst_p->preTrig+1));
+	inst_p->windows = 0;
+	inst_p->skipped = 0;
+	pthread_mutex_unlock(&inst_p->lock);
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Avg_GetResult(	PsiMsDaq_AvgHandle avgHandle,
+											double* const mean_p,
+											double* const variance_p,
+											uint32_t* const counts_p,
+											const uint32_t samples)
+{
+	//Pointer Cast
+	PsiMsDaq_AvgInst_t* inst_p = (PsiMsDaq_AvgInst_t*) avgHandle;
+	//Checks
+	if (samples < inst_p->samples) {
+		return PsiMsDaq_RetCode_BufferTooSmall;
+	}
+	//Implementation (a window contributes to all positions from its first sample on)
+	pthread_mutex_lock(&inst_p->lock);
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < inst_p->samples; i++) {
+		if (i <= inst_p->preTrig) {
+			count += inst_p->startHist_p[i];
+		}
+		const double mean = (0 == count) ? NAN : (double)inst_p->sum_p[i]/count;
+		if (NULL != mean_p) {
+			mean_p[i] = mean;
+		}
+		if (NULL != variance_p) {
+			const Uint128_t sumSq = inst_p->sqIsInt ? (Uint128_t){(uint64_t)((int64_t*)inst_p->sumSq_p)[i], 0} : ((Uint128_t*)inst_p->sumSq_p)[i];
+			variance_p[i] = (0 == count) ? NAN : Variance(inst_p->sum_p[i], sumSq, count);
+		}
+		if (NULL != counts_p) {
+			counts_p[i] = count;
+		}
+	}
+	pthread_mutex_unlock(&inst_p->lock);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Avg_GetInfo(	PsiMsDaq_AvgHandle avgHandle,
+											PsiMsDaq_AvgInfo_t* const info_p)
+{
+	//Pointer Cast
+	PsiMsDaq_AvgInst_t* inst_p = (PsiMsDaq_AvgInst_t*) avgHandle;
+	//Implementation
+	pthread_mutex_lock(&inst_p->lock);
+	info_p->samples = inst_p->samples;
+	info_p->trigIdx = inst_p->preTrig;
+	info_p->windows = inst_p->windows;
+	info_p->skipped = inst_p->skipped;
+	pthread_mutex_unlock(&inst_p->lock);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
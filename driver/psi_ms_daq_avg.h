@@ -0,0 +1,142 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Trigger-aligned averaging of windows
+*
+* The accumulator adds the samples around the trigger of every window of a stream, aligned at the trigger sample.
+* Mean and variance of every sample position can be read at any time, e.g. to extract a repetitive signal from noise.
+*
+* The averaged region consists of a fixed number of pre-trigger samples (chosen on creation) and the post-trigger
+* samples configured for the stream. Windows with fewer pre-trigger samples (e.g. the first windows after arming)
+* only contribute to the samples they contain, so the number of windows averaged is tracked per sample position.
+*
+* Windows are read in chunks (see PsiMsDaq_StrWin_GetDataChunked()) and added to a 64-bit integer sum and a sum of
+* squares in the same pass. The sum of squares is a 64-bit integer for 8 and 16 bit samples and a 128-bit integer for
+* 32 bit samples, so the variance is exact also for signals with a large offset. The loops over the chunks are
+* auto-vectorized by the compiler.
+* Usually PsiMsDaq_Avg_WinCallback() is registered as window callback, so every window is added and freed
+* immediately:
+* @code
+* PsiMsDaq_AvgHandle avg = PsiMsDaq_Avg_Create(strHndl, 1000, true);
+* PsiMsDaq_Str_SetIrqCallbackWin(strHndl, PsiMsDaq_Avg_WinCallback, avg);
+* @endcode
+*
+* Adding windows and reading the results are thread safe.
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq.h"
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef void* PsiMsDaq_AvgHandle;	///< Handle to an averaging accumulator
+
+/**
+ * @brief	Information about an averaging accumulator
+ */
+typedef struct {
+	uint32_t samples;			///< Number of sample positions averaged (pre-trigger + post-trigger)
+	uint32_t trigIdx;			///< Index of the trigger sample
+	uint64_t windows;			///< Number of windows added
+	uint64_t skipped;			///< Number of windows skipped because they did not contain a trigger
+} PsiMsDaq_AvgInfo_t;
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+
+/**
+ * @brief	Create an averaging accumulator for a stream. The stream must be configured before. Only stream widths of
+ * 			8, 16 and 32 bits are supported.
+ *
+ * @param	strHndl			Driver handle for the stream
+ * @param	preTrigSamples	Number of pre-trigger samples to average
+ * @param	isSigned		true if the samples are signed (two's complement)
+ * @return	Handle of the accumulator or NULL if the creation failed
+ */
+PsiMsDaq_AvgHandle PsiMsDaq_Avg_Create(	PsiMsDaq_StrHandle strHndl,
+										const uint32_t preTrigSamples,
+										const bool isSigned);
+
+/**
+ * @brief	Free all resources of an accumulator
+ *
+ * @param	avgHandle	Handle of the accumulator
+ */
+void PsiMsDaq_Avg_Destroy(PsiMsDaq_AvgHandle avgHandle);
+
+/**
+ * @brief	Add a window to the average
+ *
+ * @param	avgHandle	Handle of the accumulator
+ * @param	winInfo		Window information
+ * @return	Return Code (PsiMsDaq_RetCode_NoTrigInWin if the window does not contain a trigger)
+ *
+ * @note	This function does not acknowledge the reading of the data. To do so, use PsiMsDaq_StrWin_MarkAsFree()
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Avg_AddWindow(	PsiMsDaq_AvgHandle avgHandle,
+											PsiMsDaq_WinInfo_t winInfo);
+
+/**
+ * @brief	Window callback (see PsiMsDaq_Str_SetIrqCallbackWin()) that adds the window to the average and frees it.
+ *
+ * @param	winInfo		Window information
+ * @param	arg			Handle of the accumulator
+ */
+void PsiMsDaq_Avg_WinCallback(	PsiMsDaq_WinInfo_t winInfo,
+								void* arg);
+
+/**
+ * @brief	Clear the average
+ *
+ * @param	avgHandle	Handle of the accumulator
+ */
+void PsiMsDaq_Avg_Reset(PsiMsDaq_AvgHandle avgHandle);
+
+/**
+ * @brief	Get the current average. Sample positions no window contributed to yet are set to NAN.
+ *
+ * @param	avgHandle	Handle of the accumulator
+ * @param	mean_p		Buffer to write the mean of every sample position into (NULL if not required)
+ * @param	variance_p	Buffer to write the (population) variance of every sample position into (NULL if not required)
+ * @param	counts_p	Buffer to write the number of windows averaged per sample position into (NULL if not required)
+ * @param	samples		Size of the buffers in samples (at least PsiMsDaq_AvgInfo_t.samples)
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Avg_GetResult(	PsiMsDaq_AvgHandle avgHandle,
+											double* const mean_p,
+											double* const variance_p,
+											uint32_t* const counts_p,
+											const uint32_t samples);
+
+/**
+ * @brief	Get information about an accumulator
+ *
+ * @param	avgHandle	Handle of the accumulator
+ * @param	info_p		Pointer to write the information into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Avg_GetInfo(	PsiMsDaq_AvgHandle avgHandle,
+											PsiMsDaq_AvgInfo_t* const info_p);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,648 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#include "psi_ms_daq_codec.h"
+#if defined(__SSE2__)
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+	#include <arm_neon.h>
+#endif
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define GROUP			8		//8 values of b bits are packed into exactly b bytes, so groups are byte aligned
+#define GROUP_SLACK		16		//A group is stored/loaded with 16 byte vector accesses
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef struct {
+	uint8_t widthBytes;
+	uint64_t mask;
+	uint64_t prev;
+	uint64_t blk[PSI_MS_DAQ_CODEC_BLOCK];
+	uint8_t raw[PSI_MS_DAQ_CODEC_BLOCK*2+GROUP_SLACK];	//Samples of 8 and 16 bit blocks (vector path)
+	uint32_t blkCnt;
+	uint8_t* dst_p;
+	size_t dstLeft;
+	size_t written;
+	bool overflow;
+} EncState_t;
+
+//*******************************************************************************
+// Macros
+//*******************************************************************************
+#define SAFE_CALL(fctCall) { \
+		PsiMsDaq_RetCode_t r = fctCall; \
+		if (PsiMsDaq_RetCode_Success != r) {return r;}}
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+static bool IsWidthSupported(const uint8_t widthBytes)
+{
+	return (1 == widthBytes) || (2 == widthBytes) || (4 == widthBytes) || (8 == widthBytes);
+}
+
+static uint64_t WidthMask(const uint8_t widthBytes)
+{
+	return (8 == widthBytes) ? UINT64_MAX : (((uint64_t)1 << (8*widthBytes))-1);
+}
+
+//Encoded data is little endian, on little endian hosts words are stored directly
+static void Store32(uint8_t* const out_p, const uint32_t value)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	memcpy(out_p, &value, 4);
+#else
+	out_p[0] = (uint8_t)value;
+	out_p[1] = (uint8_t)(value >> 8);
+	out_p[2] = (uint8_t)(value >> 16);
+	out_p[3] = (uint8_t)(value >> 24);
+#endif
+}
+
+static uint64_t Load64(const uint8_t* const in_p)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	uint64_t value;
+	memcpy(&value, in_p, 8);
+	return value;
+#else
+	uint64_t value = 0;
+	for (int i = 7; i >= 0; i--) {
+		value = (value << 8) | in_p[i];
+	}
+	return value;
+#endif
+}
+
+//Load the next (up to) 32 bits, fewer at the end of the data
+static uint64_t Refill(	const uint8_t** const in_pp,
+						const uint8_t* const inEnd,
+						uint32_t* const loadedBits_p)
+{
+	const uint8_t* in = *in_pp;
+	uint64_t value = 0;
+	if (inEnd-in >= 4) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+		uint32_t word;
+		memcpy(&word, in, 4);
+		value = word;
+#else
+		value = (uint64_t)in[0] | ((uint64_t)in[1] << 8) | ((uint64_t)in[2] << 16) | ((uint64_t)in[3] << 24);
+#endif
+		*in_pp = in+4;
+		*loadedBits_p = 32;
+		return value;
+	}
+	uint32_t bits = 0;
+	while (in < inEnd) {
+		value |= (uint64_t)(*in++) << bits;
+		bits += 8;
+	}
+	*in_pp = in;
+	*loadedBits_p = bits;
+	return value;
+}
+
+//Vector path for 8 and 16 bit samples. The values are processed in 16 bit lanes, 8 per vector (one group). Packing
+//merges neighbouring values with shifts (16 -> 32 -> 64 -> 128 bits), so a group ends up as one 128 bit value of
+//8*bits bits that is stored at a byte boundary. Unpacking reverses the steps. The result is the same format as the
+//scalar path.
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define CODEC_VECTOR
+
+//Lane masks for an incomplete last group: &tailMask[GROUP-k] keeps the first k lanes
+static const uint16_t tailMask[2*GROUP] = {0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0xFFFF, 0, 0, 0, 0, 0, 0, 0, 0};
+
+//Predict, zig-zag encode and pack a block. The source must be readable up to the next complete group.
+static void EncBlock16(	EncState_t* const s,
+						const uint8_t* const src_p,
+						const uint32_t n)
+{
+	//Predict and zig-zag encode (values after n in the last group are cleared)
+	uint16_t zz[PSI_MS_DAQ_CODEC_BLOCK];
+	const uint32_t groups = (n+GROUP-1)/GROUP;
+	const bool is8 = (1 == s->widthBytes);
+	uint16_t prev = (uint16_t)s->prev;
+	#if defined(__SSE2__)
+		__m128i orVec = _mm_setzero_si128();
+		__m128i prevVec = _mm_cvtsi32_si128(prev);
+	#else
+		uint16x8_t orVec = vdupq_n_u16(0);
+	#endif
+	for (uint32_t g = 0; g < groups; g++) {
+		#if defined(__SSE2__)
+			const __m128i x = is8 ? _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)&src_p[GROUP*g]), _mm_setzero_si128()) :
+									_mm_loadu_si128((const __m128i*)&src_p[2*GROUP*g]);
+			const __m128i xp = _mm_or_si128(_mm_slli_si128(x, 2), prevVec);
+			prevVec = _mm_srli_si128(x, 14);
+			__m128i d = _mm_sub_epi16(x, xp);
+			if (is8) {
+				d = _mm_srai_epi16(_mm_slli_epi16(d, 8), 8);
+			}
+			__m128i z = _mm_xor_si128(_mm_slli_epi16(d, 1), _mm_srai_epi16(d, 15));
+			if (is8) {
+				z = _mm_and_si128(z, _mm_set1_epi16(0xFF));
+			}
+			if (GROUP*(g+1) > n) {
+				z = _mm_and_si128(z, _mm_loadu_si128((const __m128i*)&tailMask[GROUP-(n-GROUP*g)]));
+			}
+			orVec = _mm_or_si128(orVec, z);
+			_mm_storeu_si128((__m128i*)&zz[GROUP*g], z);
+		#else
+			const uint16x8_t x = is8 ? vmovl_u8(vld1_u8(&src_p[GROUP*g])) : vreinterpretq_u16_u8(vld1q_u8(&src_p[2*GROUP*g]));
+			const uint16x8_t xp = vextq_u16(vdupq_n_u16(prev), x, 7);
+			prev = vgetq_lane_u16(x, 7);
+			int16x8_t d = vreinterpretq_s16_u16(vsubq_u16(x, xp));
+			if (is8) {
+				d = vshrq_n_s16(vshlq_n_s16(d, 8), 8);
+			}
+			uint16x8_t z = vreinterpretq_u16_s16(veorq_s16(vshlq_n_s16(d, 1), vshrq_n_s16(d, 15)));
+			if (is8) {
+				z = vandq_u16(z, vdupq_n_u16(0xFF));
+			}
+			if (GROUP*(g+1) > n) {
+				z = vandq_u16(z, vld1q_u16(&tailMask[GROUP-(n-GROUP*g)]));
+			}
+			orVec = vorrq_u16(orVec, z);
+			vst1q_u16(&zz[GROUP*g], z);
+		#endif
+	}
+	uint16_t last = src_p[n-1];
+	if (!is8) {
+		memcpy(&last, &src_p[2*n-2], 2);
+	}
+	s->prev = last;
+	uint16_t orLanes[GROUP];
+	#if defined(__SSE2__)
+		_mm_storeu_si128((__m128i*)orLanes, orVec);
+	#else
+		vst1q_u16(orLanes, orVec);
+	#endif
+	uint16_t orAll = 0;
+	for (uint32_t i = 0; i < GROUP; i++) {
+		orAll |= orLanes[i];
+	}
+	uint8_t bits = 0;
+	while ((bits < 16) && (0 != (orAll >> bits))) {
+		bits++;
+	}
+	//Check space
+	const size_t bytes = 1 + ((size_t)n*bits+7)/8;
+	if (s->overflow || (bytes > s->dstLeft)) {
+		s->overflow = true;
+		return;
+	}
+	//Pack (directly into the destination if there is space for the vector stores of the last group)
+	uint8_t tmp[PSI_MS_DAQ_CODEC_BLOCK*2+GROUP_SLACK];
+	s->dst_p[0] = bits;
+	uint8_t* const out = (s->dstLeft >= 1+(size_t)groups*bits+GROUP_SLACK) ? s->dst_p+1 : tmp;
+	#if defined(__SSE2__)
+		const __m128i sh1 = _mm_cvtsi32_si128(bits);
+		const __m128i sh2 = _mm_cvtsi32_si128(2*bits);
+		const __m128i sh4 = _mm_cvtsi32_si128(4*bits);
+		const __m128i sh4r = _mm_cvtsi32_si128(64-4*bits);
+		const __m128i lo16 = _mm_set1_epi32(0xFFFF);
+		const __m128i lo32 = _mm_set_epi32(0, -1, 0, -1);
+		for (uint32_t g = 0; g < groups; g++) {
+			const __m128i z = _mm_loadu_si128((const __m128i*)&zz[GROUP*g]);
+			const __m128i p = _mm_or_si128(_mm_and_si128(z, lo16), _mm_sll_epi32(_mm_srli_epi32(z, 16), sh1));
+			const __m128i q = _mm_or_si128(_mm_and_si128(p, lo32), _mm_sll_epi64(_mm_srli_epi64(p, 32), sh2));
+			const __m128i t = _mm_unpackhi_epi64(q, q);
+			const __m128i r = _mm_unpacklo_epi64(_mm_or_si128(q, _mm_sll_epi64(t, sh4)), _mm_srl_epi64(t, sh4r));
+			_mm_storeu_si128((__m128i*)&out[(size_t)g*bits], r);
+		}
+	#else
+		const int32x4_t sh1 = vdupq_n_s32(bits);
+		const int64x2_t sh2 = vdupq_n_s64(2*bits);
+		const uint32_t sh4 = 4*bits;
+		for (uint32_t g = 0; g < groups; g++) {
+			const uint32x4_t z = vreinterpretq_u32_u16(vld1q_u16(&zz[GROUP*g]));
+			const uint32x4_t p = vorrq_u32(vandq_u32(z, vdupq_n_u32(0xFFFF)), vshlq_u32(vshrq_n_u32(z, 16), sh1));
+			const uint64x2_t q = vorrq_u64(	vandq_u64(vreinterpretq_u64_u32(p), vdupq_n_u64(0xFFFFFFFF)),
+											vshlq_u64(vshrq_n_u64(vreinterpretq_u64_u32(p), 32), sh2));
+			const uint64_t q0 = vgetq_lane_u64(q, 0);
+			const uint64_t q1 = vgetq_lane_u64(q, 1);
+			const uint64_t r[2] = {	q0 | ((sh4 < 64) ? q1 << sh4 : 0),
+									(0 == sh4) ? 0 : ((64 == sh4) ? q1 : q1 >> (64-sh4))};
+			vst1q_u8(&out[(size_t)g*bits], vreinterpretq_u8_u64(vld1q_u64(r)));
+		}
+	#endif
+	if (out == tmp) {
+		memcpy(s->dst_p+1, tmp, bytes-1);
+	}
+	s->dst_p += bytes;
+	s->dstLeft -= bytes;
+	s->written += bytes;
+}
+
+//Unpack, zig-zag decode and undo the prediction of complete groups as long as 16 bytes can be loaded. Returns the
+//number of samples decoded.
+static uint32_t DecBlock16(	const uint8_t* const in,
+							const uint8_t* const inEnd,
+							const uint8_t bits,
+							const uint32_t n,
+							const uint8_t widthBytes,
+							uint64_t* const prev_p,
+							uint8_t* const dst_p)
+{
+	uint32_t groups = n/GROUP;
+	const size_t avail = (size_t)(inEnd-in);
+	if ((size_t)groups*bits+GROUP_SLACK > avail) {
+		groups = (avail < GROUP_SLACK) ? 0 : (uint32_t)((avail-GROUP_SLACK)/((0 == bits) ? 1 : bits)+1);
+		groups = (groups > n/GROUP) ? n/GROUP : groups;
+	}
+	const bool is8 = (1 == widthBytes);
+	const uint32_t sh4 = 4*bits;
+	const uint64_t msk4 = (64 == sh4) ? UINT64_MAX : (((uint64_t)1 << sh4)-1);
+	#if defined(__SSE2__)
+		const __m128i sh1 = _mm_cvtsi32_si128(bits);
+		const __m128i sh2 = _mm_cvtsi32_si128(2*bits);
+		const __m128i sh4v = _mm_cvtsi32_si128(sh4);
+		const __m128i sh4r = _mm_cvtsi32_si128(64-sh4);
+		const __m128i m4 = _mm_set_epi32((int)(msk4 >> 32), (int)msk4, (int)(msk4 >> 32), (int)msk4);
+		const __m128i m2 = _mm_set1_epi64x((int64_t)((2*bits == 32) ? 0xFFFFFFFF : (((uint64_t)1 << (2*bits))-1)));
+		const __m128i m1 = _mm_set1_epi32((int)((1u << bits)-1));
+		const __m128i one = _mm_set1_epi16(1);
+		__m128i prev = _mm_set1_epi16((short)*prev_p);
+		for (uint32_t g = 0; g < groups; g++) {
+			//Unpack
+			const __m128i r = _mm_loadu_si128((const __m128i*)&in[(size_t)g*bits]);
+			const __m128i c = _mm_unpacklo_epi64(r, _mm_srl_epi64(r, sh4v));
+			const __m128i q = _mm_and_si128(_mm_or_si128(c, _mm_unpackhi_epi64(_mm_setzero_si128(), _mm_sll_epi64(r, sh4r))), m4);
+			const __m128i p = _mm_or_si128(_mm_and_si128(q, m2), _mm_slli_epi64(_mm_and_si128(_mm_srl_epi64(q, sh2), m2), 32));
+			const __m128i z = _mm_or_si128(_mm_and_si128(p, m1), _mm_slli_epi32(_mm_and_si128(_mm_srl_epi32(p, sh1), m1), 16));
+			//Zig-zag decode and prefix sum
+			__m128i x = _mm_xor_si128(_mm_srli_epi16(z, 1), _mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(z, one)));
+			x = _mm_add_epi16(x, _mm_slli_si128(x, 2));
+			x = _mm_add_epi16(x, _mm_slli_si128(x, 4));
+			x = _mm_add_epi16(x, _mm_slli_si128(x, 8));
+			x = _mm_add_epi16(x, prev);
+			prev = _mm_shufflehi_epi16(_mm_unpackhi_epi64(x, x), 0xFF);
+			prev = _mm_unpackhi_epi64(prev, prev);
+			if (is8) {
+				_mm_storel_epi64((__m128i*)&dst_p[GROUP*g], _mm_packus_epi16(_mm_and_si128(x, _mm_set1_epi16(0xFF)), _mm_setzero_si128()));
+			}
+			else {
+				_mm_storeu_si128((__m128i*)&dst_p[2*GROUP*g], x);
+			}
+		}
+		const uint16_t last = (uint16_t)_mm_extract_epi16(prev, 0);
+	#else
+		const int64x2_t sh2r = vdupq_n_s64(-2*(int64_t)bits);
+		const int32x4_t sh1r = vdupq_n_s32(-(int32_t)bits);
+		const uint64x2_t m2 = vdupq_n_u64((2*bits == 32) ? 0xFFFFFFFF : (((uint64_t)1 << (2*bits))-1));
+		const uint32x4_t m1 = vdupq_n_u32((1u << bits)-1);
+		uint16x8_t prev = vdupq_n_u16((uint16_t)*prev_p);
+		for (uint32_t g = 0; g < groups; g++) {
+			//Unpack
+			uint64_t r[2];
+			memcpy(r, &in[(size_t)g*bits], sizeof(r));
+			const uint64_t q0 = r[0] & msk4;
+			const uint64_t q1 = (((sh4 < 64) ? r[0] >> sh4 : 0) | ((0 == sh4) ? 0 : ((64 == sh4) ? r[1] : r[1] << (64-sh4)))) & msk4;
+			const uint64x2_t q = vcombine_u64(vcreate_u64(q0), vcreate_u64(q1));
+			const uint32x4_t p = vreinterpretq_u32_u64(vorrq_u64(vandq_u64(q, m2), vshlq_n_u64(vandq_u64(vshlq_u64(q, sh2r), m2), 32)));
+			const uint16x8_t z = vreinterpretq_u16_u32(vorrq_u32(vandq_u32(p, m1), vshlq_n_u32(vandq_u32(vshlq_u32(p, sh1r), m1), 16)));
+			//Zig-zag decode and prefix sum
+			uint16x8_t x = veorq_u16(vshrq_n_u16(z, 1), vreinterpretq_u16_s16(vnegq_s16(vreinterpretq_s16_u16(vandq_u16(z, vdupq_n_u16(1))))));
+			x = vaddq_u16(x, vextq_u16(vdupq_n_u16(0), x, 7));
+			x = vaddq_u16(x, vextq_u16(vdupq_n_u16(0), x, 6));
+			x = vaddq_u16(x, vextq_u16(vdupq_n_u16(0), x, 4));
+			x = vaddq_u16(x, prev);
+			prev = vdupq_n_u16(vgetq_lane_u16(x, 7));
+			if (is8) {
+				vst1_u8(&dst_p[GROUP*g], vmovn_u16(x));
+			}
+			else {
+				vst1q_u8(&dst_p[2*GROUP*g], vreinterpretq_u8_u16(x));
+			}
+		}
+		const uint16_t last = vgetq_lane_u16(prev, 0);
+	#endif
+	if (0 != groups) {
+		*prev_p = is8 ? (uint8_t)last : last;
+	}
+	return groups*GROUP;
+}
+#endif
+
+static void EncFlushBlock(EncState_t* const s)
+{
+#if defined(CODEC_VECTOR)
+	if (s->widthBytes <= 2) {
+		EncBlock16(s, s->raw, s->blkCnt);
+		s->blkCnt = 0;
+		return;
+	}
+#endif
+	//Predict from previous sample and zig-zag encode the error (both modulo the sample width)
+	const uint32_t n = s->blkCnt;
+	const uint32_t topBit = 8*s->widthBytes-1;
+	uint64_t orAll = 0;
+	for (uint32_t i = 0; i < n; i++) {
+		const uint64_t x = s->blk[i];
+		const uint64_t d = (x - s->prev) & s->mask;
+		s->prev = x;
+		const uint64_t zz = ((d << 1) ^ ((uint64_t)0 - (d >> topBit))) & s->mask;
+		s->blk[i] = zz;
+		orAll |= zz;
+	}
+	uint8_t bits = 0;
+	while ((bits < 64) && (0 != (orAll >> bits))) {
+		bits++;
+	}
+	s->blkCnt = 0;
+	//Check space
+	const size_t bytes = 1 + ((size_t)n*bits+7)/8;
+	if (s->overflow || (bytes > s->dstLeft)) {
+		s->overflow = true;
+		return;
+	}
+	//Pack (values wider than 32 bits are split in two parts, so the accumulator never overflows)
+	uint8_t* out = s->dst_p;
+	*out++ = bits;
+	uint64_t acc = 0;
+	uint32_t accBits = 0;
+	if (bits <= 32) {
+		for (uint32_t i = 0; i < n; i++) {
+			acc |= s->blk[i] << accBits;
+			accBits += bits;
+			if (accBits >= 32) {
+				Store32(out, (uint32_t)acc);
+				out += 4;
+				acc >>= 32;
+				accBits -= 32;
+			}
+		}
+	}
+	else {
+		const uint32_t hiBits = bits-32;
+		for (uint32_t i = 0; i < n; i++) {
+			acc |= (s->blk[i] & 0xFFFFFFFF) << accBits;
+			Store32(out, (uint32_t)acc);
+			out += 4;
+			acc >>= 32;
+			acc |= (s->blk[i] >> 32) << accBits;
+			accBits += hiBits;
+			if (accBits >= 32) {
+				Store32(out, (uint32_t)acc);
+				out += 4;
+				acc >>= 32;
+				accBits -= 32;
+			}
+		}
+	}
+	while (accBits > 0) {
+		*out++ = (uint8_t)acc;
+		acc >>= 8;
+		accBits = (accBits > 8) ? accBits-8 : 0;
+	}
+	s->dst_p += bytes;
+	s->dstLeft -= bytes;
+	s->written += bytes;
+}
+
+static void EncPush(	const void* data_p,
+						const uint32_t samples,
+						const uint32_t firstSpl,
+						void* arg_p)
+{
+	EncState_t* s = (EncState_t*) arg_p;
+	(void)firstSpl;
+	uint32_t i = 0;
+#if defined(CODEC_VECTOR)
+	//Vector path for 8 and 16 bit samples: complete blocks are encoded in place, the rest is collected first
+	if (s->widthBytes <= 2) {
+		const uint8_t* const in = (const uint8_t*) data_p;
+		while (i < samples) {
+			if ((0 == s->blkCnt) && (samples-i >= PSI_MS_DAQ_CODEC_BLOCK)) {
+				EncBlock16(s, &in[(size_t)i*s->widthBytes], PSI_MS_DAQ_CODEC_BLOCK);
+				i += PSI_MS_DAQ_CODEC_BLOCK;
+				continue;
+			}
+			uint32_t take = PSI_MS_DAQ_CODEC_BLOCK - s->blkCnt;
+			if (take > samples-i) {
+				take = samples-i;
+			}
+			memcpy(&s->raw[(size_t)s->blkCnt*s->widthBytes], &in[(size_t)i*s->widthBytes], (size_t)take*s->widthBytes);
+			s->blkCnt += take;
+			i += take;
+			if (PSI_MS_DAQ_CODEC_BLOCK == s->blkCnt) {
+				EncFlushBlock(s);
+			}
+		}
+		return;
+	}
+#endif
+	while (i < samples) {
+		uint32_t take = PSI_MS_DAQ_CODEC_BLOCK - s->blkCnt;
+		if (take > samples-i) {
+			take = samples-i;
+		}
+		uint64_t* blk = &s->blk[s->blkCnt];
+		switch (s->widthBytes) {
+			case 1: for (uint32_t k = 0; k < take; k++) { blk[k] = ((const uint8_t*)data_p)[i+k]; } break;
+			case 2: for (uint32_t k = 0; k < take; k++) { blk[k] = ((const uint16_t*)data_p)[i+k]; } break;
+			case 4: for (uint32_t k = 0; k < take; k++) { blk[k] = ((const uint32_t*)data_p)[i+k]; } break;
+			default: for (uint32_t k = 0; k < take; k++) { blk[k] = ((const uint64_t*)data_p)[i+k]; } break;
+		}
+		s->blkCnt += take;
+		i += take;
+		if (PSI_MS_DAQ_CODEC_BLOCK == s->blkCnt) {
+			EncFlushBlock(s);
+		}
+	}
+}
+
+static void EncStart(	EncState_t* const s,
+						const uint8_t widthBytes,
+						void* const dst_p,
+						const size_t dstSize)
+{
+	s->widthBytes = widthBytes;
+	s->mask = WidthMask(widthBytes);
+	s->prev = 0;
+	s->blkCnt = 0;
+	s->dst_p = (uint8_t*) dst_p;
+	s->dstLeft = dstSize;
+	s->written = 0;
+	s->overflow = false;
+}
+
+static PsiMsDaq_RetCode_t EncFinish(	EncState_t* const s,
+										size_t* const encodedBytes_p)
+{
+	if (0 != s->blkCnt) {
+		EncFlushBlock(s);
+	}
+	if (s->overflow) {
+		return PsiMsDaq_RetCode_BufferTooSmall;
+	}
+	*encodedBytes_p = s->written;
+	return PsiMsDaq_RetCode_Success;
+}
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+size_t PsiMsDaq_Codec_MaxEncodedSize(	const uint32_t samples,
+										const uint8_t widthBytes)
+{
+	const size_t blocks = ((size_t)samples+PSI_MS_DAQ_CODEC_BLOCK-1)/PSI_MS_DAQ_CODEC_BLOCK;
+	return blocks + (size_t)samples*widthBytes;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Codec_Encode(	const void* const src_p,
+											const uint32_t samples,
+											const uint8_t widthBytes,
+											void* const dst_p,
+											const size_t dstSize,
+											size_t* const encodedBytes_p)
+{
+	//Checks
+	if (!IsWidthSupported(widthBytes)) {
+		return PsiMsDaq_RetCode_IllegalStrWidth;
+	}
+	//Implementation
+	EncState_t state;
+	EncStart(&state, widthBytes, dst_p, dstSize);
+	EncPush(src_p, samples, 0, &state);
+	SAFE_CALL(EncFinish(&state, encodedBytes_p));
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Codec_EncodeWindow(	PsiMsDaq_WinInfo_t winInfo,
+												const uint32_t preTrigSamples,
+												const uint32_t postTrigSamples,	//including trigger
+												void* const dst_p,
+												const size_t dstSize,
+												size_t* const encodedBytes_p)
+{
+	//Setup
+	uint8_t widthBytes;
+	SAFE_CALL(PsiMsDaq_Str_GetSampleBytes(winInfo.strHandle, &widthBytes));
+	//Checks
+	if (!IsWidthSupported(widthBytes)) {
+		return PsiMsDaq_RetCode_IllegalStrWidth;
+	}
+	//Implementation
+	EncState_t state;
+	EncStart(&state, widthBytes, dst_p, dstSize);
+	SAFE_CALL(PsiMsDaq_StrWin_GetDataChunked(winInfo, preTrigSamples, postTrigSamples, EncPush, &state));
+	SAFE_CALL(EncFinish(&state, encodedBytes_p));
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Codec_Decode(	const void* const src_p,
+											const size_t srcSize,
+											const uint32_t samples,
+											const uint8_t widthBytes,
+											void* const dst_p,
+											const size_t dstSize)
+{
+	//Checks
+	if (!IsWidthSupported(widthBytes)) {
+		return PsiMsDaq_RetCode_IllegalStrWidth;
+	}
+	if (dstSize < (size_t)samples*widthBytes) {
+		return PsiMsDaq_RetCode_BufferTooSmall;
+	}
+	//Implementation
+	const uint8_t* in = (const uint8_t*) src_p;
+	const uint8_t* const inEnd = in + srcSize;
+	const uint64_t mask = WidthMask(widthBytes);
+	uint64_t prev = 0;
+	uint64_t blk[PSI_MS_DAQ_CODEC_BLOCK];
+	for (uint32_t done = 0; done < samples; ) {
+		//Block header
+		const uint32_t n = (samples-done > PSI_MS_DAQ_CODEC_BLOCK) ? PSI_MS_DAQ_CODEC_BLOCK : samples-done;
+		if (in >= inEnd) {
+			return PsiMsDaq_RetCode_CorruptData;
+		}
+		const uint8_t bits = *in++;
+		if ((bits > 8*widthBytes) || ((size_t)(inEnd-in) < ((size_t)n*bits+7)/8)) {
+			return PsiMsDaq_RetCode_CorruptData;
+		}
+		//Unpack
+		const uint8_t* const blkEnd = in + ((size_t)n*bits+7)/8;
+		uint32_t first = 0;
+#if defined(CODEC_VECTOR)
+		if (widthBytes <= 2) {
+			first = DecBlock16(in, inEnd, bits, n, widthBytes, &prev, (uint8_t*)dst_p + (size_t)done*widthBytes);
+		}
+#endif
+		uint32_t i = first;
+		//..Fast path: random access by bit position with 64-bit loads (as long as 8 bytes can be read)
+		if (bits <= 56) {
+			const uint64_t msk = ((uint64_t)1 << bits)-1;
+			const size_t avail = (size_t)(inEnd-in);
+			uint32_t nFast = n;
+			if (avail < ((size_t)n*bits)/8+8) {
+				nFast = (avail < 8) ? 0 : ((0 == bits) ? n : (uint32_t)(((avail-8)*8)/bits));
+				nFast = (nFast > n) ? n : nFast;
+			}
+			for (; i < nFast; i++) {
+				const size_t pos = (size_t)i*bits;
+				blk[i] = (Load64(in + pos/8) >> (pos%8)) & msk;
+			}
+		}
+		//..Slow path for the rest
+		const size_t startBit = (size_t)i*bits;
+		const uint8_t* rd = in + startBit/8;
+		uint64_t acc = 0;
+		uint32_t accBits = 0;
+		uint32_t loaded;
+		if (i < n) {
+			acc = Refill(&rd, inEnd, &loaded) >> (startBit%8);
+			accBits = loaded - (startBit%8);
+		}
+		const uint32_t loBits = (bits > 32) ? 32 : bits;
+		const uint32_t hiBits = bits-loBits;
+		const uint64_t loMsk = ((uint64_t)1 << loBits)-1;
+		const uint64_t hiMsk = ((uint64_t)1 << hiBits)-1;
+		for (; i < n; i++) {
+			if (accBits < loBits) {
+				acc |= Refill(&rd, inEnd, &loaded) << accBits;
+				accBits += loaded;
+			}
+			uint64_t v = acc & loMsk;
+			acc >>= loBits;
+			accBits -= loBits;
+			if (0 != hiBits) {
+				if (accBits < hiBits) {
+					acc |= Refill(&rd, inEnd, &loaded) << accBits;
+					accBits += loaded;
+				}
+				v |= (acc & hiMsk) << 32;
+				acc >>= hiBits;
+				accBits -= hiBits;
+			}
+			blk[i] = v;
+		}
+		in = blkEnd;
+		//Undo zig-zag and prediction
+		for (uint32_t i = first; i < n; i++) {
+			const uint64_t zz = blk[i];
+			const uint64_t d = ((zz >> 1) ^ ((uint64_t)0 - (zz & 1))) & mask;
+			prev = (prev + d) & mask;
+			blk[i] = prev;
+		}
+		switch (widthBytes) {
+			case 1: for (uint32_t i = first; i < n; i++) { ((uint8_t*)dst_p)[done+i] = (uint8_t)blk[i]; } break;
+			case 2: for (uint32_t i = first; i < n; i++) { ((uint16_t*)dst_p)[done+i] = (uint16_t)blk[i]; } break;
+			case 4: for (uint32_t i = first; i < n; i++) { ((uint32_t*)dst_p)[done+i] = (uint32_t)blk[i]; } break;
+			default: for (uint32_t i = first; i < n; i++) { ((uint64_t*)dst_p)[done+i] = blk[i]; } break;
+		}
+		done += n;
+	}
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
@@ -0,0 +1,121 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Lossless compression of recorded data
+*
+* The codec is tuned for ADC data: each sample is predicted from the previous one, the prediction
+* error is zig-zag encoded (small positive and negative errors become small numbers) and the errors
+* are bit-packed in blocks of PSI_MS_DAQ_CODEC_BLOCK samples. Each block uses the minimum number of bits
+* required for its largest error, so noisy and quiet parts of a window are compressed independently.
+*
+* Encoded format (all blocks consecutive, the last block may be incomplete):
+* - 1 byte: number of bits per sample in the block (0 ... stream width)
+* - Packed errors, LSB first, padded to the next byte
+*
+* Supported sample widths are 8, 16, 32 and 64 bits (PsiMsDaq_StrConfig_t.streamWidthBits). The number of samples is
+* not stored in the encoded data, it must be stored by the user (e.g. in a file header).
+*
+* For 8 and 16 bit samples, prediction, zig-zag coding and bit-packing are vectorized with SSE2 (x86) or NEON (ARM)
+* in groups of 8 samples (8 values of b bits occupy exactly b bytes). Other widths and targets without these
+* instruction sets use the scalar implementation, which produces identical output.
+*
+* All functions are reentrant, so windows can be compressed in parallel from several threads.
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq.h"
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define PSI_MS_DAQ_CODEC_BLOCK		128		///< Number of samples per block
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+
+/**
+ * @brief	Get the maximum size of encoded data (worst case, incompressible data)
+ *
+ * @param	samples		Number of samples
+ * @param	widthBytes	Width of a sample in bytes
+ * @return	Maximum size of the encoded data in bytes
+ */
+size_t PsiMsDaq_Codec_MaxEncodedSize(	const uint32_t samples,
+										const uint8_t widthBytes);
+
+/**
+ * @brief	Encode samples from a buffer
+ *
+ * @param	src_p			Samples to encode
+ * @param	samples			Number of samples
+ * @param	widthBytes		Width of a sample in bytes (1, 2, 4 or 8)
+ * @param	dst_p			Buffer to write the encoded data into
+ * @param	dstSize			Size of dst_p
+ * @param	encodedBytes_p	Pointer to write the number of encoded bytes into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Codec_Encode(	const void* const src_p,
+											const uint32_t samples,
+											const uint8_t widthBytes,
+											void* const dst_p,
+											const size_t dstSize,
+											size_t* const encodedBytes_p);
+
+/**
+ * @brief	Encode data directly from a window. The data is read in chunks (see PsiMsDaq_StrWin_GetDataChunked()),
+ * 			so no buffer for the uncompressed window is required.
+ *
+ * @param	winInfo			Window information
+ * @param 	preTrigSamples	Number of pre trigger samples to encode
+ * @param 	postTrigSamples	Number of post trigger samples to encode (including the trigger sample)
+ * @param	dst_p			Buffer to write the encoded data into
+ * @param	dstSize			Size of dst_p
+ * @param	encodedBytes_p	Pointer to write the number of encoded bytes into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Codec_EncodeWindow(	PsiMsDaq_WinInfo_t winInfo,
+												const uint32_t preTrigSamples,
+												const uint32_t postTrigSamples,	//including trigger
+												void* const dst_p,
+												const size_t dstSize,
+												size_t* const encodedBytes_p);
+
+/**
+ * @brief	Decode data
+ *
+ * @param	src_p			Encoded data
+ * @param	srcSize			Size of the encoded data in bytes
+ * @param	samples			Number of samples to decode
+ * @param	widthBytes		Width of a sample in bytes (1, 2, 4 or 8)
+ * @param	dst_p			Buffer to write the samples into
+ * @param	dstSize			Size of dst_p
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Codec_Decode(	const void* const src_p,
+											const size_t srcSize,
+											const uint32_t samples,
+											const uint8_t widthBytes,
+											void* const dst_p,
+											const size_t dstSize);
+
+#ifdef __cplusplus
+}
+#endif
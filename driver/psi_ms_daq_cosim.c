@@ -0,0 +1,182 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#include "psi_ms_daq_cosim.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef struct {
+	int sockFd;
+	uint8_t* mem_p;
+	size_t memSize;
+	uint64_t cycle;
+} CosimConn_t;
+
+//*******************************************************************************
+// Variables
+//*******************************************************************************
+static CosimConn_t conn = {-1, NULL, 0, 0};
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+static bool SendAll(const void* const data_p, const size_t bytes)
+{
+	size_t done = 0;
+	while (done < bytes) {
+		const ssize_t n = send(conn.sockFd, (const uint8_t*)data_p + done, bytes - done, MSG_NOSIGNAL);
+		if (n <= 0) {
+			return false;
+		}
+		done += n;
+	}
+	return true;
+}
+
+static bool RecvAll(void* const data_p, const size_t bytes)
+{
+	size_t done = 0;
+	while (done < bytes) {
+		const ssize_t n = recv(conn.sockFd, (uint8_t*)data_p + done, bytes - done, 0);
+		if (n <= 0) {
+			return false;
+		}
+		done += n;
+	}
+	return true;
+}
+
+static uint32_t Transfer(const PsiMsDaq_CosimCmd_t cmd, const uint32_t addr, const uint32_t data)
+{
+	const PsiMsDaq_CosimReq_t req = {cmd, addr, data};
+	PsiMsDaq_CosimRsp_t rsp;
+	if ((!SendAll(&req, sizeof(req))) || (!RecvAll(&rsp, sizeof(rsp)))) {
+		//The access functions cannot report errors, a lost simulation is fatal
+		fprintf(stderr, "psi_ms_daq_cosim: connection to simulation lost\n");
+		exit(EXIT_FAILURE);
+	}
+	conn.cycle = rsp.cycle;
+	return rsp.data;
+}
+
+static void CosimRegWrite(const uint32_t addr, const uint32_t value)
+{
+	Transfer(PsiMsDaq_CosimCmd_Write, addr, value);
+}
+
+static uint32_t CosimRegRead(const uint32_t addr)
+{
+	return Transfer(PsiMsDaq_CosimCmd_Read, addr, 0);
+}
+
+static void CosimDataCopy(void* dst, void* src, size_t n)
+{
+	memcpy(dst, src, n);
+}
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+bool PsiMsDaq_Cosim_Connect(	const char* const socketPath,
+								const char* const shmName,
+								PsiMsDaq_AccessFct_t* const accessFct_p)
+{
+	//Checks
+	const char* const path = (NULL != socketPath) ? socketPath : PSI_MS_DAQ_COSIM_SOCKET;
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if ((conn.sockFd >= 0) || (strlen(path) >= sizeof(addr.sun_path))) {
+		return false;
+	}
+	strcpy(addr.sun_path, path);
+	//Map memory model
+	const int fd = shm_open((NULL != shmName) ? shmName : PSI_MS_DAQ_COSIM_SHM, O_RDWR, 0);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat st;
+	void* mem_p = MAP_FAILED;
+	if (0 == fstat(fd, &st)) {
+		mem_p = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+	if (MAP_FAILED == mem_p) {
+		return false;
+	}
+	//Connect
+	conn.sockFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if ((conn.sockFd < 0) || (0 != connect(conn.sockFd, (struct sockaddr*)&addr, sizeof(addr)))) {
+		if (conn.sockFd >= 0) {
+			close(conn.sockFd);
+		}
+		conn.sockFd = -1;
+		munmap(mem_p, st.st_size);
+		return false;
+	}
+	conn.mem_p = (uint8_t*) mem_p;
+	conn.memSize = st.st_size;
+	conn.cycle = 0;
+	//Access functions (data is copied directly from shared memory)
+	memset(accessFct_p, 0, sizeof(PsiMsDaq_AccessFct_t));
+	accessFct_p->dataCopy = CosimDataCopy;
+	accessFct_p->regWrite = CosimRegWrite;
+	accessFct_p->regRead = CosimRegRead;
+	return true;
+}
+
+void PsiMsDaq_Cosim_Disconnect(const bool stopSim)
+{
+	//Checks
+	if (conn.sockFd < 0) {
+		return;
+	}
+	//Implementation
+	if (stopSim) {
+		const PsiMsDaq_CosimReq_t req = {PsiMsDaq_CosimCmd_Stop, 0, 0};
+		SendAll(&req, sizeof(req));
+	}
+	close(conn.sockFd);
+	munmap(conn.mem_p, conn.memSize);
+	conn.sockFd = -1;
+	conn.mem_p = NULL;
+	conn.memSize = 0;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Cosim_WaitIrq(	const uint32_t timeoutCycles,
+											bool* const irq_p)
+{
+	//Implementation
+	*irq_p = (0 != Transfer(PsiMsDaq_CosimCmd_WaitIrq, 0, timeoutCycles));
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+uint64_t PsiMsDaq_Cosim_GetCycle(void* arg)
+{
+	(void)arg;
+	return conn.cycle;
+}
+
+void* PsiMsDaq_Cosim_AddrTranslate(const uint32_t addr)
+{
+	return conn.mem_p + addr;
+}
+
+size_t PsiMsDaq_Cosim_GetMemSize(void)
+{
+	return conn.memSize;
+}
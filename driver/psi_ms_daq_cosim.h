@@ -0,0 +1,130 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Access backend for co-simulation of the driver against the RTL (Linux only)
+*
+* The co-simulation testbench (tb/psi_ms_daq_cosim) runs psi_ms_daq_axi in GHDL. A bridge linked into the simulation
+* executes register accesses requested by the driver on the AXI slave interface of the IP. The AXI master interface is
+* connected to a memory model whose content is kept in POSIX shared memory, so the driver reads recorded data directly
+* from there (AXI address 0 is the first byte of the shared memory).
+*
+* This backend implements the functions of PsiMsDaq_AccessFct_t (plus the address translation for
+* PsiMsDaq_SetAddrTranslate(), see PsiMsDaq_Cosim_AddrTranslate()): every register access is sent to the bridge over a
+* local socket and blocks until the simulation executed it. Every response contains the simulation cycle (register
+* clock) the access completed in. PsiMsDaq_Cosim_GetCycle() returns this value without further communication, so it can
+* be used as time source (see PsiMsDaq_SetTimeSource()) to measure latencies in clock cycles.
+*
+* Only one simulation can be connected per process (the access functions do not have a context argument).
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq.h"
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define PSI_MS_DAQ_COSIM_SOCKET			"/tmp/psi_ms_daq_cosim.sock"	///< Default socket path
+#define PSI_MS_DAQ_COSIM_SHM			"/psi_ms_daq_cosim_mem"			///< Default shared memory name
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+/// @cond
+//Protocol between the backend and the bridge (native byte order, both run on the same machine)
+typedef enum {
+	PsiMsDaq_CosimCmd_Read		= 1,	//Register read, response data is the value read
+	PsiMsDaq_CosimCmd_Write		= 2,	//Register write
+	PsiMsDaq_CosimCmd_WaitIrq	= 3,	//Wait until IRQ is asserted (data = timeout in cycles), response data is 1 if IRQ is asserted
+	PsiMsDaq_CosimCmd_Stop		= 4		//Stop the simulation (no response)
+} PsiMsDaq_CosimCmd_t;
+
+typedef struct {
+	uint32_t cmd;
+	uint32_t addr;
+	uint32_t data;
+} PsiMsDaq_CosimReq_t;
+
+typedef struct {
+	uint32_t data;
+	uint32_t reserved;
+	uint64_t cycle;
+} PsiMsDaq_CosimRsp_t;
+/// @endcond
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+
+/**
+ * @brief	Connect to a running co-simulation and fill an access function struct for PsiMsDaq_Init()
+ *
+ * @param	socketPath		Path of the bridge socket (PSI_MS_DAQ_COSIM_SOCKET if NULL)
+ * @param	shmName			Name of the shared memory of the memory model (PSI_MS_DAQ_COSIM_SHM if NULL)
+ * @param	accessFct_p		Pointer to write the access functions into
+ * @return	true if the connection was established
+ */
+bool PsiMsDaq_Cosim_Connect(	const char* const socketPath,
+								const char* const shmName,
+								PsiMsDaq_AccessFct_t* const accessFct_p);
+
+/**
+ * @brief	Disconnect from the co-simulation
+ *
+ * @param	stopSim		true to stop the simulation
+ */
+void PsiMsDaq_Cosim_Disconnect(const bool stopSim);
+
+/**
+ * @brief	Wait until the IRQ of the IP is asserted (the simulation runs meanwhile)
+ *
+ * @param	timeoutCycles	Timeout in register clock cycles
+ * @param	irq_p			Pointer to write whether the IRQ is asserted into (false on timeout)
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Cosim_WaitIrq(	const uint32_t timeoutCycles,
+											bool* const irq_p);
+
+/**
+ * @brief	Get the simulation cycle of the last access (register clock). The signature matches PsiMsDaq_TimeSource_f.
+ *
+ * @param	arg		Unused
+ * @return	Cycle count
+ */
+uint64_t PsiMsDaq_Cosim_GetCycle(void* arg);
+
+/**
+ * @brief	Get the size of the memory model
+ *
+ * @return	Size in bytes (0 if not connected)
+ */
+size_t PsiMsDaq_Cosim_GetMemSize(void);
+
+/**
+ * @brief	Translate an AXI address into a pointer to the shared memory of the memory model. The signature matches
+ * 			PsiMsDaq_AddrTranslate_f, pass it to PsiMsDaq_SetAddrTranslate().
+ *
+ * @param	addr	AXI address
+ * @return	Pointer into the shared memory
+ */
+void* PsiMsDaq_Cosim_AddrTranslate(const uint32_t addr);
+
+#ifdef __cplusplus
+}
+#endif
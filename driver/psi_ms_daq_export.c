@@ -0,0 +1,226 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#define _GNU_SOURCE
+#include "psi_ms_daq_export.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef struct {
+	PsiMsDaq_IpHandle ipHandle;
+	int sockFd;
+	char* buffer;
+	size_t bufferSize;
+	char path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+} PsiMsDaq_ExportInst_t;
+
+typedef struct {
+	char* buf_p;
+	size_t size;
+	size_t len;
+} TextBuf_t;
+
+typedef struct {
+	const char* name;
+	size_t offset;			//Offset of the uint64_t counter in PsiMsDaq_StrMetrics_t
+} StrCounter_t;
+
+//*******************************************************************************
+// Variables
+//*******************************************************************************
+static const StrCounter_t strCounters[] = {
+	{"psi_ms_daq_windows_total",			offsetof(PsiMsDaq_StrMetrics_t, windows)},
+	{"psi_ms_daq_bytes_read_total",			offsetof(PsiMsDaq_StrMetrics_t, bytesRead)},
+	{"psi_ms_daq_spurious_irqs_total",		offsetof(PsiMsDaq_StrMetrics_t, spuriousIrqs)},
+	{"psi_ms_daq_skipped_callbacks_total",	offsetof(PsiMsDaq_StrMetrics_t, skippedCallbacks)}
+};
+
+//*******************************************************************************
+// Macros
+//*******************************************************************************
+#define SAFE_CALL(fctCall) { \
+		PsiMsDaq_RetCode_t r = fctCall; \
+		if (PsiMsDaq_RetCode_Success != r) {return r;}}
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+static void Append(TextBuf_t* const txt_p, const char* const fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	const size_t left = (txt_p->len < txt_p->size) ? txt_p->size - txt_p->len : 0;
+	const int n = vsnprintf((0 == left) ? NULL : txt_p->buf_p + txt_p->len, left, fmt, args);
+	va_end(args);
+	//Keep counting on truncation, so the required size is known
+	if (n > 0) {
+		txt_p->len += n;
+	}
+}
+
+//Samples of one histogram (the TYPE line is written by the caller, labels may be empty)
+static void AppendHist(	TextBuf_t* const txt_p,
+						const char* const name,
+						const char* const labels,
+						const uint32_t* const bins_p,
+						const uint64_t sum)
+{
+	const char* const sep = (0 == labels[0]) ? "" : ",";
+	uint64_t cumulative = 0;
+	for (int i = 0; i < PSI_MS_DAQ_HIST_BINS-1; i++) {
+		cumulative += bins_p[i];
+		const uint64_t upper = (0 == i) ? 0 : (((uint64_t)1 << i) - 1);
+		Append(txt_p, "%s_bucket{%s%sle=\"%llu\"} %llu\n", name, labels, sep, (unsigned long long)upper, (unsigned long long)cumulative);
+	}
+	cumulative += bins_p[PSI_MS_DAQ_HIST_BINS-1];
+	Append(txt_p, "%s_bucket{%s%sle=\"+Inf\"} %llu\n", name, labels, sep, (unsigned long long)cumulative);
+	const char* const open = (0 == labels[0]) ? "" : "{";
+	const char* const close = (0 == labels[0]) ? "" : "}";
+	Append(txt_p, "%s_sum%s%s%s %llu\n", name, open, labels, close, (unsigned long long)sum);
+	Append(txt_p, "%s_count%s%s%s %llu\n", name, open, labels, close, (unsigned long long)cumulative);
+}
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+PsiMsDaq_RetCode_t PsiMsDaq_Export_Format(	PsiMsDaq_IpHandle ipHandle,
+											char* const buffer_p,
+											const size_t bufferSize,
+											size_t* const length_p)
+{
+	//Setup
+	TextBuf_t txt = {buffer_p, bufferSize, 0};
+	//IRQ metrics
+	PsiMsDaq_IrqMetrics_t irq;
+	SAFE_CALL(PsiMsDaq_GetIrqMetrics(ipHandle, &irq));
+	Append(&txt, "# TYPE psi_ms_daq_irqs_total counter\n");
+	Append(&txt, "psi_ms_daq_irqs_total %llu\n", (unsigned long long)irq.irqs);
+	Append(&txt, "# TYPE psi_ms_daq_irq_duration histogram\n");
+	AppendHist(&txt, "psi_ms_daq_irq_duration", "", irq.durationHist, irq.durationSum);
+	//Stream metrics (the text format requires all samples of a metric family to be grouped after its TYPE line)
+	PsiMsDaq_StrHandle strHndl;
+	for (size_t c = 0; c < sizeof(strCounters)/sizeof(strCounters[0]); c++) {
+		Append(&txt, "# TYPE %s counter\n", strCounters[c].name);
+		for (uint8_t str = 0; PsiMsDaq_RetCode_Success == PsiMsDaq_GetStrHandle(ipHandle, str, &strHndl); str++) {
+			PsiMsDaq_StrMetrics_t met;
+			SAFE_CALL(PsiMsDaq_Str_GetMetrics(strHndl, &met));
+			uint64_t value;
+			memcpy(&value, (const uint8_t*)&met + strCounters[c].offset, sizeof(value));
+			Append(&txt, "%s{stream=\"%u\"} %llu\n", strCounters[c].name, str, (unsigned long long)value);
+		}
+	}
+	Append(&txt, "# TYPE psi_ms_daq_trigger_latency histogram\n");
+	for (uint8_t str = 0; PsiMsDaq_RetCode_Success == PsiMsDaq_GetStrHandle(ipHandle, str, &strHndl); str++) {
+		PsiMsDaq_StrMetrics_t met;
+		SAFE_CALL(PsiMsDaq_Str_GetMetrics(strHndl, &met));
+		char labels[32];
+		snprintf(labels, sizeof(labels), "stream=\"%u\"", str);
+		AppendHist(&txt, "psi_ms_daq_trigger_latency", labels, met.latencyHist, met.latencySum);
+	}
+	//Done
+	if (NULL != length_p) {
+		*length_p = txt.len;
+	}
+	if (txt.len >= bufferSize) {
+		return PsiMsDaq_RetCode_BufferTooSmall;
+	}
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_ExportHandle PsiMsDaq_Export_Create(	PsiMsDaq_IpHandle ipHandle,
+												const char* const path)
+{
+	//Checks
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		return NULL;
+	}
+	strcpy(addr.sun_path, path);
+	//Initialization and allocation
+	PsiMsDaq_ExportInst_t* inst_p = (PsiMsDaq_ExportInst_t*) malloc(sizeof(PsiMsDaq_ExportInst_t));
+	if (NULL == inst_p) {
+		return NULL;
+	}
+	inst_p->ipHandle = ipHandle;
+	inst_p->bufferSize = 4096;
+	inst_p->buffer = (char*) malloc(inst_p->bufferSize);
+	strcpy(inst_p->path, path);
+	unlink(path);
+	inst_p->sockFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if ((NULL == inst_p->buffer) || (inst_p->sockFd < 0) ||
+		(0 != bind(inst_p->sockFd, (struct sockaddr*)&addr, sizeof(addr))) ||
+		(0 != listen(inst_p->sockFd, 8))) {
+		if (inst_p->sockFd >= 0) {
+			close(inst_p->sockFd);
+		}
+		free(inst_p->buffer);
+		free(inst_p);
+		return NULL;
+	}
+	return (PsiMsDaq_ExportHandle) inst_p;
+}
+
+void PsiMsDaq_Export_Destroy(PsiMsDaq_ExportHandle exportHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_ExportInst_t* inst_p = (PsiMsDaq_ExportInst_t*) exportHandle;
+	//Implementation
+	close(inst_p->sockFd);
+	unlink(inst_p->path);
+	free(inst_p->buffer);
+	free(inst_p);
+}
+
+int PsiMsDaq_Export_GetFd(PsiMsDaq_ExportHandle exportHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_ExportInst_t* inst_p = (PsiMsDaq_ExportInst_t*) exportHandle;
+	//Implementation
+	return inst_p->sockFd;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Export_Handle(PsiMsDaq_ExportHandle exportHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_ExportInst_t* inst_p = (PsiMsDaq_ExportInst_t*) exportHandle;
+	//Implementation
+	int clientFd;
+	while ((clientFd = accept4(inst_p->sockFd, NULL, NULL, SOCK_CLOEXEC)) >= 0) {
+		//Take snapshot, grow the buffer if required
+		size_t len;
+		while (PsiMsDaq_RetCode_BufferTooSmall == PsiMsDaq_Export_Format(inst_p->ipHandle, inst_p->buffer, inst_p->bufferSize, &len)) {
+			char* newBuf_p = (char*) realloc(inst_p->buffer, len+1);
+			if (NULL == newBuf_p) {
+				len = inst_p->bufferSize-1;
+				break;
+			}
+			inst_p->buffer = newBuf_p;
+			inst_p->bufferSize = len+1;
+		}
+		//Send snapshot (the client socket is blocking, snapshots are small)
+		size_t sent = 0;
+		while (sent < len) {
+			const ssize_t n = send(clientFd, inst_p->buffer + sent, len - sent, MSG_NOSIGNAL);
+			if (n <= 0) {
+				break;
+			}
+			sent += n;
+		}
+		close(clientFd);
+	}
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
@@ -0,0 +1,94 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Export of the performance counters over a Unix socket (Linux only)
+*
+* The exporter listens on a local Unix socket. Every client that connects receives a text snapshot of all
+* performance counters (see PsiMsDaq_Str_GetMetrics() and PsiMsDaq_GetIrqMetrics()) and the connection is closed.
+* The snapshot uses the Prometheus text format, so it can be read with e.g. "socat - UNIX-CONNECT:<path>" or
+* forwarded by a metrics agent. Histograms are exported as cumulative buckets with power of two bounds.
+*
+* The exporter does not create any threads. The user registers the file descriptor returned by
+* PsiMsDaq_Export_GetFd() in an event loop and calls PsiMsDaq_Export_Handle() whenever it is readable. Since the
+* counters are lock-free, this does not interfere with the acquisition.
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq.h"
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef void* PsiMsDaq_ExportHandle;	///< Handle to an exporter
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+
+/**
+ * @brief	Write a text snapshot of all performance counters of an IP into a buffer
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	buffer_p	Buffer to write the snapshot into (zero terminated)
+ * @param	bufferSize	Size of buffer_p
+ * @param	length_p	Pointer to write the length of the snapshot into (without termination, may be NULL)
+ * @return	Return Code (PsiMsDaq_RetCode_BufferTooSmall if the snapshot was truncated)
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Export_Format(	PsiMsDaq_IpHandle ipHandle,
+											char* const buffer_p,
+											const size_t bufferSize,
+											size_t* const length_p);
+
+/**
+ * @brief	Create an exporter listening on a Unix socket. An existing socket file at the path is replaced.
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	path		Path of the socket
+ * @return	Handle of the exporter or NULL if the creation failed
+ */
+PsiMsDaq_ExportHandle PsiMsDaq_Export_Create(	PsiMsDaq_IpHandle ipHandle,
+												const char* const path);
+
+/**
+ * @brief	Close the socket and free all resources of an exporter
+ *
+ * @param	exportHandle	Handle of the exporter
+ */
+void PsiMsDaq_Export_Destroy(PsiMsDaq_ExportHandle exportHandle);
+
+/**
+ * @brief	Get the listening socket (readable when a client connects)
+ *
+ * @param	exportHandle	Handle of the exporter
+ * @return	File descriptor
+ */
+int PsiMsDaq_Export_GetFd(PsiMsDaq_ExportHandle exportHandle);
+
+/**
+ * @brief	Serve all pending clients (non blocking)
+ *
+ * @param	exportHandle	Handle of the exporter
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Export_Handle(PsiMsDaq_ExportHandle exportHandle);
+
+#ifdef __cplusplus
+}
+#endif
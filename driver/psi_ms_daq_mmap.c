@@ -0,0 +1,104 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#define _GNU_SOURCE
+#include "psi_ms_daq_mmap.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef struct {
+	PsiMsDaq_StrHandle strHndl;
+	uint8_t* base_p;
+	size_t mapSize;
+	uint32_t bufStart;
+	uint32_t winSize;
+} PsiMsDaq_MmapInst_t;
+
+//*******************************************************************************
+// Macros
+//*******************************************************************************
+#define SAFE_CALL(fctCall) { \
+		PsiMsDaq_RetCode_t r = fctCall; \
+		if (PsiMsDaq_RetCode_Success != r) {return r;}}
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+PsiMsDaq_MmapHandle PsiMsDaq_Mmap_Create(	PsiMsDaq_StrHandle strHndl,
+											const int fd,
+											const off_t offset)
+{
+	//Checks
+	const long pageSize = sysconf(_SC_PAGESIZE);
+	uint32_t bufStart, winSize;
+	uint8_t windows;
+	if ((PsiMsDaq_RetCode_Success != PsiMsDaq_Str_GetBufferLayout(strHndl, &bufStart, &winSize)) ||
+		(PsiMsDaq_RetCode_Success != PsiMsDaq_Str_GetTotalWindows(strHndl, &windows))) {
+		return NULL;
+	}
+	if ((0 == winSize) || (0 != (winSize % pageSize)) || (0 != (offset % pageSize))) {
+		return NULL;
+	}
+	//Initialization and allocation
+	PsiMsDaq_MmapInst_t* inst_p = (PsiMsDaq_MmapInst_t*) malloc(sizeof(PsiMsDaq_MmapInst_t));
+	if (NULL == inst_p) {
+		return NULL;
+	}
+	inst_p->strHndl = strHndl;
+	inst_p->bufStart = bufStart;
+	inst_p->winSize = winSize;
+	//Reserve address space for two copies of each window, then map each window twice into it
+	inst_p->mapSize = (size_t)winSize*2*windows;
+	void* base_p = mmap(NULL, inst_p->mapSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (MAP_FAILED == base_p) {
+		free(inst_p);
+		return NULL;
+	}
+	inst_p->base_p = (uint8_t*) base_p;
+	for (uint8_t win = 0; win < windows; win++) {
+		uint8_t* const win_p = inst_p->base_p + (size_t)winSize*2*win;
+		const off_t winOffs = offset + (off_t)winSize*win;
+		if ((MAP_FAILED == mmap(win_p, winSize, PROT_READ, MAP_SHARED | MAP_FIXED, fd, winOffs)) ||
+			(MAP_FAILED == mmap(win_p + winSize, winSize, PROT_READ, MAP_SHARED | MAP_FIXED, fd, winOffs))) {
+			munmap(inst_p->base_p, inst_p->mapSize);
+			free(inst_p);
+			return NULL;
+		}
+	}
+	return (PsiMsDaq_MmapHandle) inst_p;
+}
+
+void PsiMsDaq_Mmap_Destroy(PsiMsDaq_MmapHandle mmapHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_MmapInst_t* inst_p = (PsiMsDaq_MmapInst_t*) mmapHandle;
+	//Implementation
+	munmap(inst_p->base_p, inst_p->mapSize);
+	free(inst_p);
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Mmap_GetData(	PsiMsDaq_MmapHandle mmapHandle,
+											PsiMsDaq_WinInfo_t winInfo,
+											const uint32_t preTrigSamples,
+											const uint32_t postTrigSamples,	//including trigger
+											const void** const data_p,
+											size_t* const bytes_p)
+{
+	//Pointer Cast
+	PsiMsDaq_MmapInst_t* inst_p = (PsiMsDaq_MmapInst_t*) mmapHandle;
+	//Implementation (the data starts within the first copy of the window and continues into the second one if it wraps)
+	uint32_t firstByteAddr, bytes;
+	SAFE_CALL(PsiMsDaq_StrWin_GetDataRange(winInfo, preTrigSamples, postTrigSamples, &firstByteAddr, &bytes));
+	const uint32_t winStart = inst_p->bufStart + inst_p->winSize*winInfo.winNr;
+	*data_p = inst_p->base_p + (size_t)inst_p->winSize*2*winInfo.winNr + (firstByteAddr - winStart);
+	*bytes_p = bytes;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
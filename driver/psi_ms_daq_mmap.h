@@ -0,0 +1,91 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Double-mapped windows for contiguous zero-copy access (Linux only)
+*
+* In ring-buffer mode (PsiMsDaq_StrConfig_t.winAsRingbuf = true), the data of a window usually wraps around the
+* window end, so PsiMsDaq_StrWin_GetDataUnwrapped() has to copy two chunks to get contiguous data. This module maps
+* the memory of every window twice, back to back in virtual memory. Any range of samples in a window is then
+* contiguous in the mapping and PsiMsDaq_Mmap_GetData() returns a pointer to it without copying any data.
+*
+* The buffer memory is mapped from a file descriptor, e.g. /dev/mem, a udmabuf/u-dma-buf device or a memfd
+* (for testing). The window size and the file offset of the buffer must be multiples of the page size
+* (see PsiMsDaq_Alloc_Layout() with an alignment of the page size).
+* bench/psi_ms_daq_mmap_check.c checks the contiguity of wrapped data on a memfd.
+*
+* The mapping is read-only. Cache coherency is not handled by this module, the file descriptor must provide a
+* coherent (or uncached) mapping or the user must invalidate the caches.
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq.h"
+#include <sys/types.h>
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef void* PsiMsDaq_MmapHandle;	///< Handle to the double-mapping of a stream
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+
+/**
+ * @brief	Map all windows of a stream twice. The stream must be configured before.
+ *
+ * @param	strHndl		Driver handle for the stream
+ * @param	fd			File descriptor to map the buffer memory from
+ * @param	offset		Offset of the stream buffer (PsiMsDaq_StrConfig_t.bufStartAddr) in the file
+ * @return	Handle of the mapping or NULL if the mapping failed (e.g. window size not a multiple of the page size)
+ */
+PsiMsDaq_MmapHandle PsiMsDaq_Mmap_Create(	PsiMsDaq_StrHandle strHndl,
+											const int fd,
+											const off_t offset);
+
+/**
+ * @brief	Unmap all windows
+ *
+ * @param	mmapHandle	Handle of the mapping
+ */
+void PsiMsDaq_Mmap_Destroy(PsiMsDaq_MmapHandle mmapHandle);
+
+/**
+ * @brief	Get a pointer to the data of a window
+ *
+ * @param	mmapHandle		Handle of the mapping
+ * @param	winInfo			Window information
+ * @param 	preTrigSamples	Number of pre trigger samples
+ * @param 	postTrigSamples	Number of post trigger samples (including the trigger sample)
+ * @param	data_p			Pointer to write the data pointer into (valid until the window is freed)
+ * @param	bytes_p			Pointer to write the number of bytes into
+ * @return	Return Code
+ *
+ * @note	This function does not acknowledge the reading of the data. To do so, use PsiMsDaq_StrWin_MarkAsFree()
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Mmap_GetData(	PsiMsDaq_MmapHandle mmapHandle,
+											PsiMsDaq_WinInfo_t winInfo,
+											const uint32_t preTrigSamples,
+											const uint32_t postTrigSamples,	//including trigger
+											const void** const data_p,
+											size_t* const bytes_p);
+
+#ifdef __cplusplus
+}
+#endif
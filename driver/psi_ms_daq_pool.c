@@ -0,0 +1,277 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#define _GNU_SOURCE
+#include "psi_ms_daq_pool.h"
+#include "psi_ms_daq_atomic.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define HUGE_PAGE_SIZE		(2*1024*1024)
+
+//C11 keywords are spelled differently in C++
+#ifdef __cplusplus
+	#define ALIGNAS(n)			alignas(n)
+	#define THREAD_LOCAL		thread_local
+#else
+	#define ALIGNAS(n)			_Alignas(n)
+	#define THREAD_LOCAL		_Thread_local
+#endif
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef struct {
+	ALIGNAS(PSI_MS_DAQ_POOL_ALIGN) pthread_mutex_t lock;
+	uint32_t* free_p;			//Stack of free buffer indexes (capacity = all buffers)
+	uint32_t freeCnt;
+} PsiMsDaq_PoolShard_t;
+
+typedef struct {
+	PsiMsDaq_PoolShard_t* shards;
+	atomic_bool* acquired;		//Ownership per buffer (detects buffers released twice)
+	uint8_t* base_p;
+	size_t mapSize;
+	uint32_t buffers;
+	uint32_t bufferSize;
+	uint32_t stride;
+	bool hugeTlb;
+} PsiMsDaq_PoolInst_t;
+
+//*******************************************************************************
+// Variables
+//*******************************************************************************
+static atomic_uint nextShard = 0;
+static THREAD_LOCAL int threadShard = -1;
+
+//*******************************************************************************
+// Macros
+//*******************************************************************************
+#define SAFE_CALL(fctCall) { \
+		PsiMsDaq_RetCode_t r = fctCall; \
+		if (PsiMsDaq_RetCode_Success != r) {return r;}}
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+static int GetShard(void)
+{
+	if (threadShard < 0) {
+		threadShard = atomic_fetch_add(&nextShard, 1) % PSI_MS_DAQ_POOL_SHARDS;
+	}
+	return threadShard;
+}
+
+static void* MapMemory(PsiMsDaq_PoolInst_t* const inst_p, const size_t bytes, const bool hugePages)
+{
+	void* mem_p = MAP_FAILED;
+	inst_p->hugeTlb = false;
+	//Explicit huge pages (fails if none are reserved)
+	if (hugePages) {
+		inst_p->mapSize = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+		mem_p = mmap(NULL, inst_p->mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+		inst_p->hugeTlb = (MAP_FAILED != mem_p);
+	}
+	//Normal pages, transparent huge pages on request
+	if (MAP_FAILED == mem_p) {
+		const size_t pageSize = sysconf(_SC_PAGESIZE);
+		inst_p->mapSize = (bytes + pageSize - 1) / pageSize * pageSize;
+		mem_p = mmap(NULL, inst_p->mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (MAP_FAILED == mem_p) {
+			return NULL;
+		}
+		if (hugePages) {
+			madvise(mem_p, inst_p->mapSize, MADV_HUGEPAGE);
+		}
+	}
+	//Pre-fault (MAP_POPULATE is only a hint)
+	memset(mem_p, 0, inst_p->mapSize);
+	return mem_p;
+}
+
+static void FreeInst(PsiMsDaq_PoolInst_t* const inst_p)
+{
+	if (NULL != inst_p->shards) {
+		for (int i = 0; i < PSI_MS_DAQ_POOL_SHARDS; i++) {
+			pthread_mutex_destroy(&inst_p->shards[i].lock);
+			free(inst_p->shards[i].free_p);
+		}
+	}
+	if (NULL != inst_p->base_p) {
+		munmap(inst_p->base_p, inst_p->mapSize);
+	}
+	free(inst_p->shards);
+	free(inst_p->acquired);
+	free(inst_p);
+}
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+PsiMsDaq_PoolHandle PsiMsDaq_Pool_Create(	PsiMsDaq_IpHandle ipHandle,
+											const uint32_t strMask,
+											const uint32_t buffersPerWin,
+											const bool hugePages)
+{
+	//Checks and sizing from the stream configurations
+	uint32_t maxWinSize = 0;
+	uint32_t windows = 0;
+	for (uint8_t str = 0; str < 32; str++) {
+		if (0 == (strMask & (1u << str))) {
+			continue;
+		}
+		PsiMsDaq_StrHandle strHndl;
+		uint32_t bufStart, winSize;
+		uint8_t winCnt;
+		if ((PsiMsDaq_RetCode_Success != PsiMsDaq_GetStrHandle(ipHandle, str, &strHndl)) ||
+			(PsiMsDaq_RetCode_Success != PsiMsDaq_Str_GetBufferLayout(strHndl, &bufStart, &winSize)) ||
+			(PsiMsDaq_RetCode_Success != PsiMsDaq_Str_GetTotalWindows(strHndl, &winCnt))) {
+			return NULL;
+		}
+		maxWinSize = (winSize > maxWinSize) ? winSize : maxWinSize;
+		windows += winCnt;
+	}
+	if ((0 == maxWinSize) || (0 == windows) || (0 == buffersPerWin)) {
+		return NULL;
+	}
+	//Initialization and allocation
+	PsiMsDaq_PoolInst_t* inst_p = (PsiMsDaq_PoolInst_t*) malloc(sizeof(PsiMsDaq_PoolInst_t));
+	if (NULL == inst_p) {
+		return NULL;
+	}
+	inst_p->buffers = windows*buffersPerWin;
+	inst_p->bufferSize = maxWinSize;
+	inst_p->stride = (maxWinSize + PSI_MS_DAQ_POOL_ALIGN - 1) / PSI_MS_DAQ_POOL_ALIGN * PSI_MS_DAQ_POOL_ALIGN;
+	inst_p->base_p = (uint8_t*) MapMemory(inst_p, (size_t)inst_p->stride*inst_p->buffers, hugePages);
+	inst_p->shards = (PsiMsDaq_PoolShard_t*) aligned_alloc(PSI_MS_DAQ_POOL_ALIGN, sizeof(PsiMsDaq_PoolShard_t)*PSI_MS_DAQ_POOL_SHARDS);
+	inst_p->acquired = (atomic_bool*) malloc(sizeof(atomic_bool)*inst_p->buffers);
+	bool ok = (NULL != inst_p->base_p) && (NULL != inst_p->shards) && (NULL != inst_p->acquired);
+	if (NULL != inst_p->shards) {
+		for (int i = 0; i < PSI_MS_DAQ_POOL_SHARDS; i++) {
+			pthread_mutex_init(&inst_p->shards[i].lock, NULL);
+			inst_p->shards[i].free_p = (uint32_t*) malloc(sizeof(uint32_t)*inst_p->buffers);
+			inst_p->shards[i].freeCnt = 0;
+			ok = ok && (NULL != inst_p->shards[i].free_p);
+		}
+	}
+	if (!ok) {
+		FreeInst(inst_p);
+		return NULL;
+	}
+	//Distribute the buffers over all free lists
+	for (uint32_t buf = 0; buf < inst_p->buffers; buf++) {
+		PsiMsDaq_PoolShard_t* const shard_p = &inst_p->shards[buf % PSI_MS_DAQ_POOL_SHARDS];
+		shard_p->free_p[shard_p->freeCnt++] = buf;
+		atomic_init(&inst_p->acquired[buf], false);
+	}
+	return (PsiMsDaq_PoolHandle) inst_p;
+}
+
+void PsiMsDaq_Pool_Destroy(PsiMsDaq_PoolHandle poolHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_PoolInst_t* inst_p = (PsiMsDaq_PoolInst_t*) poolHandle;
+	//Implementation
+	FreeInst(inst_p);
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Pool_Acquire(	PsiMsDaq_PoolHandle poolHandle,
+											void** const buffer_p)
+{
+	//Pointer Cast
+	PsiMsDaq_PoolInst_t* inst_p = (PsiMsDaq_PoolInst_t*) poolHandle;
+	//Implementation (own free list first, then the ones of other threads)
+	const int own = GetShard();
+	for (int i = 0; i < PSI_MS_DAQ_POOL_SHARDS; i++) {
+		PsiMsDaq_PoolShard_t* const shard_p = &inst_p->shards[(own + i) % PSI_MS_DAQ_POOL_SHARDS];
+		pthread_mutex_lock(&shard_p->lock);
+		if (shard_p->freeCnt > 0) {
+			const uint32_t buf = shard_p->free_p[--shard_p->freeCnt];
+			pthread_mutex_unlock(&shard_p->lock);
+			atomic_store_explicit(&inst_p->acquired[buf], true, memory_order_relaxed);
+			*buffer_p = inst_p->base_p + (size_t)inst_p->stride*buf;
+			return PsiMsDaq_RetCode_Success;
+		}
+		pthread_mutex_unlock(&shard_p->lock);
+	}
+	//Done
+	return PsiMsDaq_RetCode_PoolEmpty;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Pool_Release(	PsiMsDaq_PoolHandle poolHandle,
+											void* const buffer)
+{
+	//Pointer Cast
+	PsiMsDaq_PoolInst_t* inst_p = (PsiMsDaq_PoolInst_t*) poolHandle;
+	//Checks
+	const uint8_t* const buf_p = (const uint8_t*) buffer;
+	if ((buf_p < inst_p->base_p) || (buf_p >= inst_p->base_p + (size_t)inst_p->stride*inst_p->buffers) ||
+		(0 != (size_t)(buf_p - inst_p->base_p) % inst_p->stride)) {
+		return PsiMsDaq_RetCode_IllegalBuffer;
+	}
+	const uint32_t buf = (uint32_t)((size_t)(buf_p - inst_p->base_p) / inst_p->stride);
+	if (!atomic_exchange_explicit(&inst_p->acquired[buf], false, memory_order_relaxed)) {
+		return PsiMsDaq_RetCode_IllegalBuffer;
+	}
+	//Implementation
+	PsiMsDaq_PoolShard_t* const shard_p = &inst_p->shards[GetShard()];
+	pthread_mutex_lock(&shard_p->lock);
+	shard_p->free_p[shard_p->freeCnt++] = buf;
+	pthread_mutex_unlock(&shard_p->lock);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Pool_ReadWindow(	PsiMsDaq_PoolHandle poolHandle,
+												PsiMsDaq_WinInfo_t winInfo,
+												const uint32_t preTrigSamples,
+												const uint32_t postTrigSamples,	//including trigger
+												void** const buffer_p,
+												size_t* const bytes_p)
+{
+	//Pointer Cast
+	PsiMsDaq_PoolInst_t* inst_p = (PsiMsDaq_PoolInst_t*) poolHandle;
+	//Implementation
+	uint32_t firstByteAddr, bytes;
+	SAFE_CALL(PsiMsDaq_StrWin_GetDataRange(winInfo, preTrigSamples, postTrigSamples, &firstByteAddr, &bytes));
+	void* buf_p;
+	SAFE_CALL(PsiMsDaq_Pool_Acquire(poolHandle, &buf_p));
+	const PsiMsDaq_RetCode_t r = PsiMsDaq_StrWin_GetDataUnwrapped(winInfo, preTrigSamples, postTrigSamples, buf_p, inst_p->bufferSize);
+	if (PsiMsDaq_RetCode_Success != r) {
+		PsiMsDaq_Pool_Release(poolHandle, buf_p);
+		return r;
+	}
+	*buffer_p = buf_p;
+	*bytes_p = bytes;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Pool_GetInfo(	PsiMsDaq_PoolHandle poolHandle,
+											PsiMsDaq_PoolInfo_t* const info_p)
+{
+	//Pointer Cast
+	PsiMsDaq_PoolInst_t* inst_p = (PsiMsDaq_PoolInst_t*) poolHandle;
+	//Implementation
+	info_p->buffers = inst_p->buffers;
+	info_p->bufferSize = inst_p->bufferSize;
+	info_p->mapSize = inst_p->mapSize;
+	info_p->hugeTlb = inst_p->hugeTlb;
+	info_p->freeBuffers = 0;
+	for (int i = 0; i < PSI_MS_DAQ_POOL_SHARDS; i++) {
+		pthread_mutex_lock(&inst_p->shards[i].lock);
+		info_p->freeBuffers += inst_p->shards[i].freeCnt;
+		pthread_mutex_unlock(&inst_p->shards[i].lock);
+	}
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
@@ -0,0 +1,156 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Pool of pre-faulted destination buffers for window data (Linux only)
+*
+* Allocating a destination buffer for every window read (malloc/new) costs page faults, TLB misses and allocator
+* contention at high window rates. This pool allocates all buffers at once when it is created and hands them out
+* and takes them back afterwards, so the steady state does not allocate or fault any memory.
+*
+* The pool is sized from the configuration of the streams it serves: every buffer can hold a complete window of
+* any of the streams (largest PsiMsDaq_StrConfig_t.winSize) and by default there is one buffer per window
+* (sum of PsiMsDaq_StrConfig_t.winCnt), so every window can be read while all others are still in use.
+*
+* All buffers are in one contiguous mapping that is touched on creation (pre-faulted). Buffers start at a multiple
+* of PSI_MS_DAQ_POOL_ALIGN bytes, which is suitable for cache lines and SIMD loads. Optionally, the mapping is
+* backed by huge pages: explicit huge pages (hugetlbfs) are used if available, otherwise transparent huge pages are
+* requested.
+*
+* The free buffers are kept in PSI_MS_DAQ_POOL_SHARDS free lists. Every thread uses its own free list (assigned on
+* first use), a buffer is returned to the free list of the thread releasing it. Only if the own list is empty,
+* the lists of other threads are searched. So usually threads do not contend for the same lock.
+*
+* Typical usage in the window IRQ callback:
+* @code
+* void* data_p;
+* size_t bytes;
+* if (PsiMsDaq_RetCode_Success == PsiMsDaq_Pool_ReadWindow(pool, winInfo, pre, post, &data_p, &bytes)) {
+*     PsiMsDaq_StrWin_MarkAsFree(winInfo);
+*     ProcessData(data_p, bytes);	//maybe in another thread
+*     PsiMsDaq_Pool_Release(pool, data_p);
+* }
+* @endcode
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq.h"
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define PSI_MS_DAQ_POOL_ALIGN		64		///< Alignment of the buffers in bytes
+#define PSI_MS_DAQ_POOL_SHARDS		8		///< Number of free lists (threads beyond this number share free lists)
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef void* PsiMsDaq_PoolHandle;	///< Handle to a buffer pool
+
+/**
+ * @brief	Information about a buffer pool
+ */
+typedef struct {
+	uint32_t buffers;		///< Number of buffers
+	uint32_t bufferSize;	///< Size of each buffer in bytes
+	uint32_t freeBuffers;	///< Number of buffers currently not in use
+	size_t mapSize;			///< Size of the mapping in bytes
+	bool hugeTlb;			///< true if the mapping is backed by explicit huge pages
+} PsiMsDaq_PoolInfo_t;
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+
+/**
+ * @brief	Create a buffer pool for a set of streams. The streams must be configured before.
+ *
+ * @param	ipHandle		Driver handle for the whole IP
+ * @param	strMask			Streams to serve (bit N = stream N)
+ * @param	buffersPerWin	Number of buffers per window of the streams (usually 1)
+ * @param	hugePages		true to back the pool by huge pages
+ * @return	Handle of the pool or NULL if the creation failed
+ */
+PsiMsDaq_PoolHandle PsiMsDaq_Pool_Create(	PsiMsDaq_IpHandle ipHandle,
+											const uint32_t strMask,
+											const uint32_t buffersPerWin,
+											const bool hugePages);
+
+/**
+ * @brief	Free all resources of a pool. All buffers become invalid.
+ *
+ * @param	poolHandle	Handle of the pool
+ */
+void PsiMsDaq_Pool_Destroy(PsiMsDaq_PoolHandle poolHandle);
+
+/**
+ * @brief	Get a buffer from the pool (thread safe)
+ *
+ * @param	poolHandle	Handle of the pool
+ * @param	buffer_p	Pointer to write the buffer pointer into
+ * @return	Return Code (PsiMsDaq_RetCode_PoolEmpty if all buffers are in use)
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Pool_Acquire(	PsiMsDaq_PoolHandle poolHandle,
+											void** const buffer_p);
+
+/**
+ * @brief	Return a buffer to the pool (thread safe)
+ *
+ * @param	poolHandle	Handle of the pool
+ * @param	buffer		Buffer to return (as returned by PsiMsDaq_Pool_Acquire() or PsiMsDaq_Pool_ReadWindow())
+ * @return	Return Code (PsiMsDaq_RetCode_IllegalBuffer if the buffer does not belong to the pool or is not acquired,
+ * 			e.g. released twice)
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Pool_Release(	PsiMsDaq_PoolHandle poolHandle,
+											void* const buffer);
+
+/**
+ * @brief	Get a buffer from the pool and read the unwrapped data of a window into it (see
+ * 			PsiMsDaq_StrWin_GetDataUnwrapped()). If reading fails, the buffer is returned to the pool.
+ *
+ * @param	poolHandle		Handle of the pool
+ * @param	winInfo			Window information
+ * @param 	preTrigSamples	Number of pre trigger samples to read
+ * @param 	postTrigSamples	Number of post trigger samples to read (including the trigger sample)
+ * @param	buffer_p		Pointer to write the buffer pointer into (return it using PsiMsDaq_Pool_Release())
+ * @param	bytes_p			Pointer to write the number of bytes read into
+ * @return	Return Code
+ *
+ * @note	This function does not acknowledge the reading of the data. To do so, use PsiMsDaq_StrWin_MarkAsFree()
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Pool_ReadWindow(	PsiMsDaq_PoolHandle poolHandle,
+												PsiMsDaq_WinInfo_t winInfo,
+												const uint32_t preTrigSamples,
+												const uint32_t postTrigSamples,	//including trigger
+												void** const buffer_p,
+												size_t* const bytes_p);
+
+/**
+ * @brief	Get information about a pool
+ *
+ * @param	poolHandle	Handle of the pool
+ * @param	info_p		Pointer to write the information into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Pool_GetInfo(	PsiMsDaq_PoolHandle poolHandle,
+											PsiMsDaq_PoolInfo_t* const info_p);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,208 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#include "psi_ms_daq_shed.h"
+#include "psi_ms_daq_atomic.h"
+#include <stdlib.h>
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define MAX_STREAMS		32
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef struct {
+	atomic_uchar priority;
+	PsiMsDaq_AtomicCnt_t windows[PSI_MS_DAQ_SHED_LEVELS];
+} PsiMsDaq_ShedStr_t;
+
+typedef struct {
+	PsiMsDaq_IpHandle ipHandle;
+	PsiMsDaq_ShedConfig_t config;
+	PsiMsDaq_ShedStr_t streams[MAX_STREAMS];
+	float occupancy;
+	uint32_t evalCnt;
+	PsiMsDaq_AtomicFloat_t queueLoad;
+	PsiMsDaq_AtomicFloat_t pressure;
+	atomic_int level;
+	PsiMsDaq_AtomicCnt_t escalations;
+	PsiMsDaq_AtomicCnt_t deescalations;
+} PsiMsDaq_ShedInst_t;
+
+//*******************************************************************************
+// Macros
+//*******************************************************************************
+#define SAFE_CALL(fctCall) { \
+		PsiMsDaq_RetCode_t r = fctCall; \
+		if (PsiMsDaq_RetCode_Success != r) {return r;}}
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+static PsiMsDaq_RetCode_t ReadOccupancy(	PsiMsDaq_ShedInst_t* const inst_p,
+											float* const occupancy_p)
+{
+	//All streams are read, so a stream that stopped does not keep its last occupancy
+	float occupancy = 0.0f;
+	for (int str = 0; str < MAX_STREAMS; str++) {
+		PsiMsDaq_StrHandle strHndl;
+		if (PsiMsDaq_RetCode_Success != PsiMsDaq_GetStrHandle(inst_p->ipHandle, str, &strHndl)) {
+			break;
+		}
+		uint8_t used, total;
+		SAFE_CALL(PsiMsDaq_Str_GetTotalWindows(strHndl, &total));
+		if (0 == total) {
+			continue;
+		}
+		SAFE_CALL(PsiMsDaq_Str_GetUsedWindows(strHndl, &used));
+		occupancy = ((float)used/total > occupancy) ? (float)used/total : occupancy;
+	}
+	*occupancy_p = occupancy;
+	return PsiMsDaq_RetCode_Success;
+}
+
+static int UpdateLevel(PsiMsDaq_ShedInst_t* const inst_p)
+{
+	//Pressure
+	float pressure = atomic_load_explicit(&inst_p->queueLoad, memory_order_relaxed);
+	pressure = (inst_p->occupancy > pressure) ? inst_p->occupancy : pressure;
+	atomic_store_explicit(&inst_p->pressure, pressure, memory_order_relaxed);
+	//Level (with hysteresis)
+	int level = atomic_load_explicit(&inst_p->level, memory_order_relaxed);
+	while ((level < PSI_MS_DAQ_SHED_LEVELS-1) && (pressure >= inst_p->config.threshold[level])) {
+		level++;
+		atomic_fetch_add_explicit(&inst_p->escalations, 1, memory_order_relaxed);
+	}
+	while ((level > 0) && (pressure < inst_p->config.threshold[level-1]-inst_p->config.hysteresis)) {
+		level--;
+		atomic_fetch_add_explicit(&inst_p->deescalations, 1, memory_order_relaxed);
+	}
+	atomic_store_explicit(&inst_p->level, level, memory_order_relaxed);
+	return level;
+}
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+PsiMsDaq_ShedHandle PsiMsDaq_Shed_Create(	PsiMsDaq_IpHandle ipHandle,
+											const PsiMsDaq_ShedConfig_t* const config_p)
+{
+	//Checks
+	if (NULL == ipHandle) {
+		return NULL;
+	}
+	for (int i = 1; i < PSI_MS_DAQ_SHED_LEVELS-1; i++) {
+		if (config_p->threshold[i] < config_p->threshold[i-1]) {
+			return NULL;
+		}
+	}
+	if (config_p->hysteresis < 0.0f) {
+		return NULL;
+	}
+	//Initialization and allocation
+	PsiMsDaq_ShedInst_t* inst_p = (PsiMsDaq_ShedInst_t*) malloc(sizeof(PsiMsDaq_ShedInst_t));
+	if (NULL == inst_p) {
+		return NULL;
+	}
+	inst_p->ipHandle = ipHandle;
+	inst_p->config = *config_p;
+	inst_p->occupancy = 0.0f;
+	inst_p->evalCnt = 0;
+	for (int str = 0; str < MAX_STREAMS; str++) {
+		atomic_init(&inst_p->streams[str].priority, 0);
+		for (int i = 0; i < PSI_MS_DAQ_SHED_LEVELS; i++) {
+			atomic_init(&inst_p->streams[str].windows[i], 0);
+		}
+	}
+	atomic_init(&inst_p->queueLoad, 0.0f);
+	atomic_init(&inst_p->pressure, 0.0f);
+	atomic_init(&inst_p->level, 0);
+	atomic_init(&inst_p->escalations, 0);
+	atomic_init(&inst_p->deescalations, 0);
+	return (PsiMsDaq_ShedHandle) inst_p;
+}
+
+void PsiMsDaq_Shed_Destroy(PsiMsDaq_ShedHandle shedHandle)
+{
+	free(shedHandle);
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Shed_SetPriority(	PsiMsDaq_ShedHandle shedHandle,
+												const uint8_t strNr,
+												const uint8_t priority)
+{
+	//Pointer Cast
+	PsiMsDaq_ShedInst_t* inst_p = (PsiMsDaq_ShedInst_t*) shedHandle;
+	//Checks
+	if (strNr >= MAX_STREAMS) {
+		return PsiMsDaq_RetCode_IllegalStrNr;
+	}
+	//Implementation
+	atomic_store_explicit(&inst_p->streams[strNr].priority, priority, memory_order_relaxed);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+void PsiMsDaq_Shed_SetQueueLoad(	PsiMsDaq_ShedHandle shedHandle,
+									const float load)
+{
+	//Pointer Cast
+	PsiMsDaq_ShedInst_t* inst_p = (PsiMsDaq_ShedInst_t*) shedHandle;
+	//Implementation
+	atomic_store_explicit(&inst_p->queueLoad, load, memory_order_relaxed);
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Shed_Admit(	PsiMsDaq_ShedHandle shedHandle,
+										PsiMsDaq_WinInfo_t winInfo,
+										PsiMsDaq_ShedAction_t* const action_p)
+{
+	//Pointer Cast
+	PsiMsDaq_ShedInst_t* inst_p = (PsiMsDaq_ShedInst_t*) shedHandle;
+	//Setup
+	uint8_t strNr;
+	SAFE_CALL(PsiMsDaq_Str_GetStrNr(winInfo.strHandle, &strNr));
+	PsiMsDaq_ShedStr_t* const str_p = &inst_p->streams[strNr];
+	//Update the occupancy of all streams (the current window is still occupied)
+	if (0 == inst_p->evalCnt) {
+		SAFE_CALL(ReadOccupancy(inst_p, &inst_p->occupancy));
+	}
+	inst_p->evalCnt = (inst_p->evalCnt+1 >= inst_p->config.evalInterval) ? 0 : inst_p->evalCnt+1;
+	//Decide (the priority delays degradation of a stream by as many levels)
+	const int level = UpdateLevel(inst_p);
+	const int priority = atomic_load_explicit(&str_p->priority, memory_order_relaxed);
+	const PsiMsDaq_ShedAction_t action = (level > priority) ? (PsiMsDaq_ShedAction_t)(level-priority) : PsiMsDaq_ShedAction_Full;
+	atomic_fetch_add_explicit(&str_p->windows[action], 1, memory_order_relaxed);
+	if (PsiMsDaq_ShedAction_Drop == action) {
+		SAFE_CALL(PsiMsDaq_StrWin_MarkAsFree(winInfo));
+	}
+	*action_p = action;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Shed_GetStats(	PsiMsDaq_ShedHandle shedHandle,
+											const uint8_t strNr,
+											PsiMsDaq_ShedStats_t* const stats_p)
+{
+	//Pointer Cast
+	PsiMsDaq_ShedInst_t* inst_p = (PsiMsDaq_ShedInst_t*) shedHandle;
+	//Checks
+	if (strNr >= MAX_STREAMS) {
+		return PsiMsDaq_RetCode_IllegalStrNr;
+	}
+	//Implementation
+	stats_p->level = (PsiMsDaq_ShedAction_t) atomic_load_explicit(&inst_p->level, memory_order_relaxed);
+	stats_p->pressure = atomic_load_explicit(&inst_p->pressure, memory_order_relaxed);
+	stats_p->escalations = atomic_load_explicit(&inst_p->escalations, memory_order_relaxed);
+	stats_p->deescalations = atomic_load_explicit(&inst_p->deescalations, memory_order_relaxed);
+	for (int i = 0; i < PSI_MS_DAQ_SHED_LEVELS; i++) {
+		stats_p->windows[i] = atomic_load_explicit(&inst_p->streams[strNr].windows[i], memory_order_relaxed);
+	}
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
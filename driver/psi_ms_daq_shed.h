@@ -0,0 +1,174 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Adaptive load shedding when consumers fall behind the acquisition
+*
+* If the consumers of the windows do not keep up, windows stay occupied. Without window overwriting, the IP stops
+* recording and the input FIFOs overflow. With window overwriting, data is lost without any choice of which. This
+* module degrades the processing progressively and per stream priority instead.
+*
+* The pressure is the highest window occupancy (used windows / total windows) of all streams of the IP or the load of
+* the downstream queues reported by the user (PsiMsDaq_Shed_SetQueueLoad(), e.g. the fill level of a TCP or shared
+* memory queue), whichever is higher. The pressure selects a shedding level by the thresholds in the configuration
+* (with hysteresis, so the level does not toggle at a threshold):
+* - Level 0: All windows are processed completely
+* - Level 1: Optional processing stages are skipped
+* - Level 2: Windows are decimated
+* - Level 3: Windows are freed without being read
+*
+* The action for a window is the level minus the priority of its stream. Streams with priority 0 are degraded first,
+* streams with priority 3 or higher are never degraded. So the most important streams keep full fidelity as long as
+* possible.
+*
+* The user calls PsiMsDaq_Shed_Admit() at the beginning of the window callback and implements the actions
+* returned (except PsiMsDaq_ShedAction_Drop, where the window is freed already). Every action is counted per stream.
+* Occupancy is read from the IP for all configured streams (one register read per window), so it is only updated every
+* PsiMsDaq_ShedConfig_t.evalInterval windows admitted (of any stream).
+* @code
+* void WinCallback(PsiMsDaq_WinInfo_t winInfo, void* arg) {
+*     PsiMsDaq_ShedAction_t action;
+*     PsiMsDaq_Shed_Admit(shed, winInfo, &action);
+*     switch (action) {
+*         case PsiMsDaq_ShedAction_Drop: return;
+*         case PsiMsDaq_ShedAction_Decimate: ...PsiMsDaq_StrWin_GetDataDecimated()...; break;
+*         default: ...full read, optional stages only for PsiMsDaq_ShedAction_Full...; break;
+*     }
+*     PsiMsDaq_StrWin_MarkAsFree(winInfo);
+* }
+* @endcode
+*
+* PsiMsDaq_Shed_Admit() must be called from one thread (usually the IRQ handling), all other functions are thread safe.
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq.h"
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define PSI_MS_DAQ_SHED_LEVELS			4		///< Number of shedding levels (see PsiMsDaq_ShedAction_t)
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef void* PsiMsDaq_ShedHandle;	///< Handle to a load shedding policy
+
+/**
+ * @brief	Action to take for a window (also used as shedding level)
+ */
+typedef enum {
+	PsiMsDaq_ShedAction_Full			= 0,	///< Process the window completely
+	PsiMsDaq_ShedAction_SkipOptional	= 1,	///< Skip optional processing stages
+	PsiMsDaq_ShedAction_Decimate		= 2,	///< Read the window decimated (see PsiMsDaq_ShedConfig_t.decimRatio)
+	PsiMsDaq_ShedAction_Drop			= 3		///< The window was freed without reading it
+} PsiMsDaq_ShedAction_t;
+
+/**
+ * @brief	Configuration of the load shedding
+ */
+typedef struct {
+	float threshold[PSI_MS_DAQ_SHED_LEVELS-1];	///< Pressure to enter level 1, 2 and 3 (0.0 ... 1.0, ascending)
+	float hysteresis;							///< A level is left when the pressure drops below its threshold minus this value
+	uint32_t decimRatio;						///< Decimation ratio recommended for PsiMsDaq_ShedAction_Decimate
+	uint32_t evalInterval;						///< Number of windows admitted between reading the occupancy (0 or 1 = every window)
+} PsiMsDaq_ShedConfig_t;
+
+/**
+ * @brief	Statistics of the load shedding
+ * @note	On targets without lock-free 64-bit atomics, the 64-bit fields are counted in 32 bits and wrap at 2^32.
+ */
+typedef struct {
+	PsiMsDaq_ShedAction_t level;				///< Current level
+	float pressure;								///< Current pressure
+	uint64_t escalations;						///< Number of level increases
+	uint64_t deescalations;						///< Number of level decreases
+	uint64_t windows[PSI_MS_DAQ_SHED_LEVELS];	///< Number of windows per action taken (for the stream requested)
+} PsiMsDaq_ShedStats_t;
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+
+/**
+ * @brief	Create a load shedding policy for an IP. All streams have priority 0 initially.
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	config_p	Configuration
+ * @return	Handle of the policy or NULL if the creation failed (e.g. thresholds not ascending)
+ */
+PsiMsDaq_ShedHandle PsiMsDaq_Shed_Create(	PsiMsDaq_IpHandle ipHandle,
+											const PsiMsDaq_ShedConfig_t* const config_p);
+
+/**
+ * @brief	Free all resources of a policy
+ *
+ * @param	shedHandle	Handle of the policy
+ */
+void PsiMsDaq_Shed_Destroy(PsiMsDaq_ShedHandle shedHandle);
+
+/**
+ * @brief	Set the priority of a stream
+ *
+ * @param	shedHandle	Handle of the policy
+ * @param	strNr		Stream number
+ * @param	priority	Priority (0 = degraded first, 3 or higher = never degraded)
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Shed_SetPriority(	PsiMsDaq_ShedHandle shedHandle,
+												const uint8_t strNr,
+												const uint8_t priority);
+
+/**
+ * @brief	Report the load of the downstream queues (e.g. the fill level of the fullest consumer queue)
+ *
+ * @param	shedHandle	Handle of the policy
+ * @param	load		Load (0.0 = empty ... 1.0 = full)
+ */
+void PsiMsDaq_Shed_SetQueueLoad(	PsiMsDaq_ShedHandle shedHandle,
+									const float load);
+
+/**
+ * @brief	Decide what to do with a window. If the action is PsiMsDaq_ShedAction_Drop, the window is freed already and
+ * 			must not be accessed anymore.
+ *
+ * @param	shedHandle	Handle of the policy
+ * @param	winInfo		Window information
+ * @param	action_p	Pointer to write the action into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Shed_Admit(	PsiMsDaq_ShedHandle shedHandle,
+										PsiMsDaq_WinInfo_t winInfo,
+										PsiMsDaq_ShedAction_t* const action_p);
+
+/**
+ * @brief	Get the statistics of the policy and the action counters of a stream
+ *
+ * @param	shedHandle	Handle of the policy
+ * @param	strNr		Stream number to get the action counters for
+ * @param	stats_p		Pointer to write the statistics into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Shed_GetStats(	PsiMsDaq_ShedHandle shedHandle,
+											const uint8_t strNr,
+											PsiMsDaq_ShedStats_t* const stats_p);
+
+#ifdef __cplusplus
+}
+#endif
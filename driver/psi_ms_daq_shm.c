@@ -0,0 +1,336 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#define _POSIX_C_SOURCE 200809L
+#include "psi_ms_daq_shm.h"
+#include "psi_ms_daq_atomic.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+//Shared memory layout: header, consumer cursors, slots (all cache line aligned)
+typedef struct {
+	uint32_t magic;
+	uint32_t slots;
+	uint32_t slotBytes;
+	uint32_t slotStride;
+	uint32_t maxConsumers;
+	atomic_uint_least64_t writeSeq;		//sequence number of the next window to publish
+} ShmHeader_t;
+
+typedef enum {
+	CursorState_Free		= 0,
+	CursorState_Claiming	= 1,
+	CursorState_Attached	= 2,
+	CursorState_Dropped		= 3
+} CursorState_t;
+
+typedef struct {
+	atomic_uint_least32_t state;
+	uint32_t policy;
+	atomic_uint_least64_t readSeq;		//sequence number of the next window to read
+} ShmCursor_t;
+
+typedef struct {
+	uint8_t* base_p;
+	size_t size;
+	ShmHeader_t* hdr_p;
+	ShmCursor_t* cursors_p;
+	uint8_t* slots_p;
+} ShmMap_t;
+
+typedef struct {
+	ShmMap_t map;
+	char* name;
+} PsiMsDaq_ShmInst_t;
+
+typedef struct {
+	ShmMap_t map;
+	ShmCursor_t* cursor_p;
+	uint32_t nr;
+} PsiMsDaq_ShmConsInst_t;
+
+//*******************************************************************************
+// Macros
+//*******************************************************************************
+#define SAFE_CALL(fctCall) { \
+		PsiMsDaq_RetCode_t r = fctCall; \
+		if (PsiMsDaq_RetCode_Success != r) {return r;}}
+
+#define SHM_MAGIC		0x50534D51	//"PSMQ"
+#define SHM_ALIGN		64
+#define ALIGN_UP(x)		(((x) + SHM_ALIGN - 1) / SHM_ALIGN * SHM_ALIGN)
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+static size_t CursorsOffset(void)
+{
+	return ALIGN_UP(sizeof(ShmHeader_t));
+}
+
+static size_t SlotsOffset(const uint32_t maxConsumers)
+{
+	return CursorsOffset() + ALIGN_UP(sizeof(ShmCursor_t)*maxConsumers);
+}
+
+static void SetupMap(ShmMap_t* const map_p, void* const base_p, const size_t size)
+{
+	map_p->base_p = (uint8_t*) base_p;
+	map_p->size = size;
+	map_p->hdr_p = (ShmHeader_t*) base_p;
+	map_p->cursors_p = (ShmCursor_t*)(map_p->base_p + CursorsOffset());
+	map_p->slots_p = map_p->base_p + SlotsOffset(map_p->hdr_p->maxConsumers);
+}
+
+static PsiMsDaq_ShmWinMeta_t* SlotMeta(const ShmMap_t* const map_p, const uint64_t seq)
+{
+	return (PsiMsDaq_ShmWinMeta_t*)(map_p->slots_p + (size_t)map_p->hdr_p->slotStride*(seq % map_p->hdr_p->slots));
+}
+
+static uint8_t* SlotData(const ShmMap_t* const map_p, const uint64_t seq)
+{
+	return (uint8_t*)SlotMeta(map_p, seq) + ALIGN_UP(sizeof(PsiMsDaq_ShmWinMeta_t));
+}
+
+//*******************************************************************************
+// Functions (publisher)
+//*******************************************************************************
+PsiMsDaq_ShmHandle PsiMsDaq_Shm_Create(	const char* const name,
+										const uint32_t slots,
+										const uint32_t slotBytes,
+										const uint32_t maxConsumers)
+{
+	//Checks
+	if ((0 == slots) || (0 == maxConsumers)) {
+		return NULL;
+	}
+	//Initialization and allocation
+	PsiMsDaq_ShmInst_t* inst_p = (PsiMsDaq_ShmInst_t*) malloc(sizeof(PsiMsDaq_ShmInst_t));
+	if (NULL == inst_p) {
+		return NULL;
+	}
+	inst_p->name = strdup(name);
+	const uint32_t slotStride = ALIGN_UP(sizeof(PsiMsDaq_ShmWinMeta_t)) + ALIGN_UP(slotBytes);
+	const size_t size = SlotsOffset(maxConsumers) + (size_t)slotStride*slots;
+	//An existing ring is not replaced, it may still be used by another publisher and its consumers
+	const int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	void* base_p = MAP_FAILED;
+	if ((fd >= 0) && (0 == ftruncate(fd, size))) {
+		base_p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	if (fd >= 0) {
+		close(fd);
+	}
+	if ((MAP_FAILED == base_p) || (NULL == inst_p->name)) {
+		if (MAP_FAILED != base_p) {
+			munmap(base_p, size);
+		}
+		if (fd >= 0) {
+			shm_unlink(name);
+		}
+		free(inst_p->name);
+		free(inst_p);
+		return NULL;
+	}
+	//Initialize shared memory (the magic number is written last, it marks the ring as valid)
+	ShmHeader_t* hdr_p = (ShmHeader_t*) base_p;
+	hdr_p->slots = slots;
+	hdr_p->slotBytes = slotBytes;
+	hdr_p->slotStride = slotStride;
+	hdr_p->maxConsumers = maxConsumers;
+	atomic_init(&hdr_p->writeSeq, 0);
+	SetupMap(&inst_p->map, base_p, size);
+	for (uint32_t i = 0; i < maxConsumers; i++) {
+		atomic_init(&inst_p->map.cursors_p[i].state, CursorState_Free);
+		atomic_init(&inst_p->map.cursors_p[i].readSeq, 0);
+	}
+	atomic_thread_fence(memory_order_release);
+	hdr_p->magic = SHM_MAGIC;
+	return (PsiMsDaq_ShmHandle) inst_p;
+}
+
+void PsiMsDaq_Shm_Destroy(PsiMsDaq_ShmHandle shmHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_ShmInst_t* inst_p = (PsiMsDaq_ShmInst_t*) shmHandle;
+	//Implementation
+	munmap(inst_p->map.base_p, inst_p->map.size);
+	shm_unlink(inst_p->name);
+	free(inst_p->name);
+	free(inst_p);
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Shm_Publish(	PsiMsDaq_ShmHandle shmHandle,
+											PsiMsDaq_WinInfo_t winInfo,
+											const uint32_t preTrigSamples,
+											const uint32_t postTrigSamples)	//including trigger
+{
+	//Pointer Cast
+	PsiMsDaq_ShmInst_t* inst_p = (PsiMsDaq_ShmInst_t*) shmHandle;
+	ShmMap_t* map_p = &inst_p->map;
+	const uint64_t seq = atomic_load_explicit(&map_p->hdr_p->writeSeq, memory_order_relaxed);
+	//Check if all consumers are done with the slot to overwrite
+	for (uint32_t i = 0; i < map_p->hdr_p->maxConsumers; i++) {
+		ShmCursor_t* cur_p = &map_p->cursors_p[i];
+		if ((CursorState_Attached != atomic_load_explicit(&cur_p->state, memory_order_acquire)) ||
+			(seq - atomic_load_explicit(&cur_p->readSeq, memory_order_acquire) < map_p->hdr_p->slots)) {
+			continue;
+		}
+		if (PsiMsDaq_ShmPolicy_Backpressure == cur_p->policy) {
+			return PsiMsDaq_RetCode_QueueFull;
+		}
+		uint_least32_t expected = CursorState_Attached;
+		atomic_compare_exchange_strong(&cur_p->state, &expected, CursorState_Dropped);
+	}
+	//Copy data and metadata
+	uint32_t samples, bytes;
+	SAFE_CALL(PsiMsDaq_StrWin_GetNoOfSamples(winInfo, &samples));
+	SAFE_CALL(PsiMsDaq_StrWin_GetNoOfBytes(winInfo, &bytes));
+	if (0 == samples) {
+		return PsiMsDaq_RetCode_NoTrigInWin;
+	}
+	PsiMsDaq_ShmWinMeta_t* meta_p = SlotMeta(map_p, seq);
+	SAFE_CALL(PsiMsDaq_StrWin_GetDataUnwrapped(winInfo, preTrigSamples, postTrigSamples, SlotData(map_p, seq), map_p->hdr_p->slotBytes));
+	SAFE_CALL(PsiMsDaq_StrWin_GetTimestamp(winInfo, &meta_p->timestamp));
+	SAFE_CALL(PsiMsDaq_Str_GetStrNr(winInfo.strHandle, &meta_p->strNr));
+	meta_p->seq = seq;
+	meta_p->bytes = (preTrigSamples + postTrigSamples)*(bytes/samples);
+	meta_p->preTrigSamples = preTrigSamples;
+	meta_p->postTrigSamples = postTrigSamples;
+	meta_p->winNr = winInfo.winNr;
+	//Publish
+	atomic_store_explicit(&map_p->hdr_p->writeSeq, seq+1, memory_order_release);
+	//Consumers only access the copy in the slot, so the window is freed right away. Taking and releasing a reference
+	//..frees it exactly once and respects references the caller took itself.
+	SAFE_CALL(PsiMsDaq_StrWin_Retain(winInfo));
+	SAFE_CALL(PsiMsDaq_StrWin_Release(winInfo));
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Shm_DropConsumer(	PsiMsDaq_ShmHandle shmHandle,
+												const uint32_t consumerNr)
+{
+	//Pointer Cast
+	PsiMsDaq_ShmInst_t* inst_p = (PsiMsDaq_ShmInst_t*) shmHandle;
+	//Checks
+	if (consumerNr >= inst_p->map.hdr_p->maxConsumers) {
+		return PsiMsDaq_RetCode_IllegalStrNr;
+	}
+	//Implementation
+	uint_least32_t expected = CursorState_Attached;
+	atomic_compare_exchange_strong(&inst_p->map.cursors_p[consumerNr].state, &expected, CursorState_Dropped);
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+//*******************************************************************************
+// Functions (consumer)
+//*******************************************************************************
+PsiMsDaq_ShmConsumerHandle PsiMsDaq_ShmConsumer_Attach(	const char* const name,
+														const PsiMsDaq_ShmPolicy_t policy)
+{
+	//Map shared memory
+	const int fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0) {
+		return NULL;
+	}
+	struct stat st;
+	void* base_p = MAP_FAILED;
+	if ((0 == fstat(fd, &st)) && ((size_t)st.st_size >= sizeof(ShmHeader_t))) {
+		base_p = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	close(fd);
+	if (MAP_FAILED == base_p) {
+		return NULL;
+	}
+	PsiMsDaq_ShmConsInst_t* inst_p = (PsiMsDaq_ShmConsInst_t*) malloc(sizeof(PsiMsDaq_ShmConsInst_t));
+	if ((NULL == inst_p) || (SHM_MAGIC != ((ShmHeader_t*)base_p)->magic)) {
+		munmap(base_p, st.st_size);
+		free(inst_p);
+		return NULL;
+	}
+	atomic_thread_fence(memory_order_acquire);
+	SetupMap(&inst_p->map, base_p, st.st_size);
+	//Claim a free cursor. The cursor only becomes visible to the publisher after it is initialized.
+	for (uint32_t i = 0; i < inst_p->map.hdr_p->maxConsumers; i++) {
+		ShmCursor_t* cur_p = &inst_p->map.cursors_p[i];
+		uint_least32_t expected = CursorState_Free;
+		if (atomic_compare_exchange_strong(&cur_p->state, &expected, CursorState_Claiming)) {
+			cur_p->policy = policy;
+			atomic_store(&cur_p->readSeq, atomic_load(&inst_p->map.hdr_p->writeSeq));
+			atomic_store_explicit(&cur_p->state, CursorState_Attached, memory_order_release);
+			inst_p->cursor_p = cur_p;
+			inst_p->nr = i;
+			return (PsiMsDaq_ShmConsumerHandle) inst_p;
+		}
+	}
+	munmap(base_p, st.st_size);
+	free(inst_p);
+	return NULL;
+}
+
+void PsiMsDaq_ShmConsumer_Detach(PsiMsDaq_ShmConsumerHandle consHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_ShmConsInst_t* inst_p = (PsiMsDaq_ShmConsInst_t*) consHandle;
+	//Implementation
+	atomic_store_explicit(&inst_p->cursor_p->state, CursorState_Free, memory_order_release);
+	munmap(inst_p->map.base_p, inst_p->map.size);
+	free(inst_p);
+}
+
+uint32_t PsiMsDaq_ShmConsumer_GetNr(PsiMsDaq_ShmConsumerHandle consHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_ShmConsInst_t* inst_p = (PsiMsDaq_ShmConsInst_t*) consHandle;
+	//Implementation
+	return inst_p->nr;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_ShmConsumer_Next(	PsiMsDaq_ShmConsumerHandle consHandle,
+												PsiMsDaq_ShmWinMeta_t* const meta_p,
+												const void** const data_p,
+												bool* const available_p)
+{
+	//Pointer Cast
+	PsiMsDaq_ShmConsInst_t* inst_p = (PsiMsDaq_ShmConsInst_t*) consHandle;
+	//Checks
+	if (CursorState_Dropped == atomic_load_explicit(&inst_p->cursor_p->state, memory_order_acquire)) {
+		return PsiMsDaq_RetCode_ConsumerDropped;
+	}
+	//Implementation
+	const uint64_t readSeq = atomic_load_explicit(&inst_p->cursor_p->readSeq, memory_order_relaxed);
+	if (readSeq == atomic_load_explicit(&inst_p->map.hdr_p->writeSeq, memory_order_acquire)) {
+		*available_p = false;
+		return PsiMsDaq_RetCode_Success;
+	}
+	*meta_p = *SlotMeta(&inst_p->map, readSeq);
+	*data_p = SlotData(&inst_p->map, readSeq);
+	*available_p = true;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_ShmConsumer_Done(PsiMsDaq_ShmConsumerHandle consHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_ShmConsInst_t* inst_p = (PsiMsDaq_ShmConsInst_t*) consHandle;
+	//Implementation
+	atomic_fetch_add_explicit(&inst_p->cursor_p->readSeq, 1, memory_order_release);
+	if (CursorState_Dropped == atomic_load_explicit(&inst_p->cursor_p->state, memory_order_acquire)) {
+		return PsiMsDaq_RetCode_ConsumerDropped;
+	}
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
@@ -0,0 +1,182 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Shared-memory fan-out of windows to several consumer processes (Linux only)
+*
+* The publisher (the process that runs the driver) copies every window it publishes once into a ring of
+* slots in POSIX shared memory. Any number of consumer processes (up to the maximum given at creation) attach
+* to the ring and read the data directly from shared memory without copying it again.
+*
+* Every published window gets a sequence number. Each consumer has its own read cursor (the sequence number of
+* the next window it reads) that it advances by calling PsiMsDaq_ShmConsumer_Done(). The publisher can only
+* overwrite a slot when all consumers have passed it. If a consumer is too slow, its policy decides what happens:
+* - PsiMsDaq_ShmPolicy_Backpressure: PsiMsDaq_Shm_Publish() returns PsiMsDaq_RetCode_QueueFull. The publisher keeps
+*   the window and tries again later. Since the hardware windows are not freed, the IP eventually stops recording.
+* - PsiMsDaq_ShmPolicy_Drop: The consumer is dropped and must attach again.
+*
+* Consumers only access the copy in the ring, so the publisher frees a window in the hardware as soon as it is copied.
+* A window is only accepted (and freed) if there is a slot no consumer with backpressure policy still needs, so no
+* window is lost for such a consumer. Since the hardware windows are not pinned by the ring, both the slots and the
+* hardware windows are available for buffering.
+*
+* Consumers poll for new windows (PsiMsDaq_ShmConsumer_Next() is non blocking). All synchronization is lock-free,
+* a crashed consumer with backpressure policy stalls the publisher until it is detached with
+* PsiMsDaq_Shm_DropConsumer().
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq.h"
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef void* PsiMsDaq_ShmHandle;			///< Handle to a publisher
+typedef void* PsiMsDaq_ShmConsumerHandle;	///< Handle to a consumer
+
+/**
+ * @brief	Policy for consumers that do not keep up
+ */
+typedef enum {
+	PsiMsDaq_ShmPolicy_Backpressure	= 0,	///< Stop publishing until the consumer is done
+	PsiMsDaq_ShmPolicy_Drop			= 1		///< Drop the consumer
+} PsiMsDaq_ShmPolicy_t;
+
+/**
+ * @brief	Metadata of a window in shared memory
+ */
+typedef struct {
+	uint64_t seq;				///< Sequence number
+	uint64_t timestamp;			///< Trigger timestamp
+	uint32_t bytes;				///< Number of data bytes
+	uint32_t preTrigSamples;	///< Number of pre-trigger samples in the data
+	uint32_t postTrigSamples;	///< Number of post-trigger samples in the data (including the trigger sample)
+	uint8_t strNr;				///< Stream number
+	uint8_t winNr;				///< Window number
+} PsiMsDaq_ShmWinMeta_t;
+
+//*******************************************************************************
+// Functions (publisher)
+//*******************************************************************************
+
+/**
+ * @brief	Create the shared memory ring. The shared memory object is only accessible by the user running the
+ * 			publisher (mode 0600). The creation fails if an object with the same name exists already (e.g. used by another
+ * 			publisher or left over by a crashed one, remove it with shm_unlink() after making sure it is unused).
+ *
+ * @param	name			Name of the shared memory object (see shm_open(), e.g. "/daq")
+ * @param	slots			Number of slots in the ring
+ * @param	slotBytes		Maximum number of data bytes per window
+ * @param	maxConsumers	Maximum number of consumers
+ * @return	Handle of the publisher or NULL if the creation failed
+ */
+PsiMsDaq_ShmHandle PsiMsDaq_Shm_Create(	const char* const name,
+										const uint32_t slots,
+										const uint32_t slotBytes,
+										const uint32_t maxConsumers);
+
+/**
+ * @brief	Unmap and remove the shared memory object
+ *
+ * @param	shmHandle	Handle of the publisher
+ */
+void PsiMsDaq_Shm_Destroy(PsiMsDaq_ShmHandle shmHandle);
+
+/**
+ * @brief	Publish a window. The data and metadata are copied into the ring and the window is freed. If this
+ * 			function succeeded, the window must not be freed using PsiMsDaq_StrWin_MarkAsFree() by the caller anymore
+ * 			(references the caller took itself must still be released, the window is freed with the last one).
+ * 			If it failed, the window is not freed.
+ *
+ * @param	shmHandle		Handle of the publisher
+ * @param	winInfo			Window information
+ * @param 	preTrigSamples	Number of pre trigger samples to publish
+ * @param 	postTrigSamples	Number of post trigger samples to publish (including the trigger sample)
+ * @return	Return Code (PsiMsDaq_RetCode_QueueFull if a consumer with backpressure policy is too slow)
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Shm_Publish(	PsiMsDaq_ShmHandle shmHandle,
+											PsiMsDaq_WinInfo_t winInfo,
+											const uint32_t preTrigSamples,
+											const uint32_t postTrigSamples);	//including trigger
+
+/**
+ * @brief	Forcibly detach a consumer (e.g. if the consumer process crashed)
+ *
+ * @param	shmHandle	Handle of the publisher
+ * @param	consumerNr	Number of the consumer (see PsiMsDaq_ShmConsumer_GetNr())
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Shm_DropConsumer(	PsiMsDaq_ShmHandle shmHandle,
+												const uint32_t consumerNr);
+
+//*******************************************************************************
+// Functions (consumer)
+//*******************************************************************************
+
+/**
+ * @brief	Attach to a shared memory ring. The consumer starts with the next window published.
+ *
+ * @param	name	Name of the shared memory object
+ * @param	policy	Policy applied if the consumer does not keep up
+ * @return	Handle of the consumer or NULL if attaching failed (e.g. no free consumer entry)
+ */
+PsiMsDaq_ShmConsumerHandle PsiMsDaq_ShmConsumer_Attach(	const char* const name,
+														const PsiMsDaq_ShmPolicy_t policy);
+
+/**
+ * @brief	Detach from the ring
+ *
+ * @param	consHandle	Handle of the consumer
+ */
+void PsiMsDaq_ShmConsumer_Detach(PsiMsDaq_ShmConsumerHandle consHandle);
+
+/**
+ * @brief	Get the number of the consumer (index of its read cursor)
+ *
+ * @param	consHandle	Handle of the consumer
+ * @return	Consumer number
+ */
+uint32_t PsiMsDaq_ShmConsumer_GetNr(PsiMsDaq_ShmConsumerHandle consHandle);
+
+/**
+ * @brief	Get the next window (non blocking). The data stays valid until PsiMsDaq_ShmConsumer_Done() is called.
+ *
+ * @param	consHandle	Handle of the consumer
+ * @param	meta_p		Pointer to write the window metadata into
+ * @param	data_p		Pointer to write the data pointer into
+ * @param	available_p	Pointer to write whether a window was available into
+ * @return	Return Code (PsiMsDaq_RetCode_ConsumerDropped if the consumer was dropped)
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_ShmConsumer_Next(	PsiMsDaq_ShmConsumerHandle consHandle,
+												PsiMsDaq_ShmWinMeta_t* const meta_p,
+												const void** const data_p,
+												bool* const available_p);
+
+/**
+ * @brief	Report that the window returned by the last PsiMsDaq_ShmConsumer_Next() is processed
+ *
+ * @param	consHandle	Handle of the consumer
+ * @return	Return Code (PsiMsDaq_RetCode_ConsumerDropped if the consumer was dropped while processing the window,
+ * 			in this case the data read may have been overwritten)
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_ShmConsumer_Done(PsiMsDaq_ShmConsumerHandle consHandle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,379 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#define _GNU_SOURCE
+#include "psi_ms_daq_tcp.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define TCP_HDR_BYTES		32
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef struct {
+	PsiMsDaq_WinInfo_t winInfo;
+	uint8_t hdr[TCP_HDR_BYTES];			//Serialized PsiMsDaq_TcpWinHdr_t
+	struct iovec data[2];
+} QueueEntry_t;
+
+typedef struct {
+	int fd;								//-1 if unused
+	uint32_t strMask;
+	uint8_t rxBuf[4];
+	uint32_t rxCnt;
+	QueueEntry_t* queue;
+	uint32_t head;
+	uint32_t count;
+	size_t headSent;					//Bytes of the first entry already sent
+} Client_t;
+
+typedef struct {
+	int sockFd;
+	uint32_t maxClients;
+	uint32_t queueDepth;
+	PsiMsDaq_TcpPolicy_t policy;
+	Client_t* clients;
+	uint64_t seq;
+	PsiMsDaq_TcpStats_t stats;
+} PsiMsDaq_TcpInst_t;
+
+//*******************************************************************************
+// Macros
+//*******************************************************************************
+#define SAFE_CALL(fctCall) { \
+		PsiMsDaq_RetCode_t r = fctCall; \
+		if (PsiMsDaq_RetCode_Success != r) {return r;}}
+
+#define TCP_BATCH_WINDOWS	64		//Maximum windows per vectored send (3 iovecs each, below IOV_MAX)
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+static size_t EntryBytes(const QueueEntry_t* const entry_p)
+{
+	return TCP_HDR_BYTES + entry_p->data[0].iov_len + entry_p->data[1].iov_len;
+}
+
+static void PutLe(uint8_t* const dst_p, const uint64_t value, const int bytes)
+{
+	for (int i = 0; i < bytes; i++) {
+		dst_p[i] = (uint8_t)(value >> (8*i));
+	}
+}
+
+static void SerializeHdr(const PsiMsDaq_TcpWinHdr_t* const hdr_p, uint8_t* const wire_p)
+{
+	PutLe(&wire_p[0], hdr_p->bytes, 4);
+	PutLe(&wire_p[4], hdr_p->strNr, 1);
+	PutLe(&wire_p[5], hdr_p->sampleBytes, 1);
+	PutLe(&wire_p[6], hdr_p->reserved, 2);
+	PutLe(&wire_p[8], hdr_p->seq, 8);
+	PutLe(&wire_p[16], hdr_p->timestamp, 8);
+	PutLe(&wire_p[24], hdr_p->preTrigSamples, 4);
+	PutLe(&wire_p[28], hdr_p->postTrigSamples, 4);
+}
+
+static void ReleaseHead(Client_t* const client_p, const uint32_t queueDepth)
+{
+	PsiMsDaq_StrWin_Release(client_p->queue[client_p->head].winInfo);
+	client_p->head = (client_p->head + 1) % queueDepth;
+	client_p->count--;
+	client_p->headSent = 0;
+}
+
+static void Disconnect(PsiMsDaq_TcpInst_t* const inst_p, Client_t* const client_p)
+{
+	while (client_p->count > 0) {
+		ReleaseHead(client_p, inst_p->queueDepth);
+	}
+	close(client_p->fd);
+	client_p->fd = -1;
+	inst_p->stats.clients--;
+}
+
+static void Accept(PsiMsDaq_TcpInst_t* const inst_p)
+{
+	int clientFd;
+	while ((clientFd = accept4(inst_p->sockFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+		Client_t* client_p = NULL;
+		for (uint32_t i = 0; i < inst_p->maxClients; i++) {
+			if (inst_p->clients[i].fd < 0) {
+				client_p = &inst_p->clients[i];
+				break;
+			}
+		}
+		if (NULL == client_p) {
+			close(clientFd);
+			continue;
+		}
+		const int one = 1;
+		setsockopt(clientFd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+		client_p->fd = clientFd;
+		client_p->strMask = 0xFFFFFFFF;
+		client_p->rxCnt = 0;
+		client_p->head = 0;
+		client_p->count = 0;
+		client_p->headSent = 0;
+		inst_p->stats.clients++;
+	}
+}
+
+//Returns false if the client disconnected
+static bool Receive(Client_t* const client_p)
+{
+	for (;;) {
+		const ssize_t n = recv(client_p->fd, client_p->rxBuf + client_p->rxCnt, sizeof(client_p->rxBuf) - client_p->rxCnt, MSG_DONTWAIT);
+		if (0 == n) {
+			return false;
+		}
+		if (n < 0) {
+			return (EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno);
+		}
+		client_p->rxCnt += n;
+		if (sizeof(client_p->rxBuf) == client_p->rxCnt) {
+			client_p->strMask = (uint32_t)client_p->rxBuf[0] | ((uint32_t)client_p->rxBuf[1] << 8) |
+								((uint32_t)client_p->rxBuf[2] << 16) | ((uint32_t)client_p->rxBuf[3] << 24);
+			client_p->rxCnt = 0;
+		}
+	}
+}
+
+//Returns false if the client disconnected
+static bool Send(PsiMsDaq_TcpInst_t* const inst_p, Client_t* const client_p)
+{
+	while (client_p->count > 0) {
+		//Collect queued windows into one vectored send (the first one may be partially sent)
+		struct iovec iov[3*TCP_BATCH_WINDOWS];
+		int iovCnt = 0;
+		size_t skip = client_p->headSent;
+		for (uint32_t i = 0; (i < client_p->count) && (i < TCP_BATCH_WINDOWS); i++) {
+			QueueEntry_t* const entry_p = &client_p->queue[(client_p->head + i) % inst_p->queueDepth];
+			const struct iovec parts[3] = {{entry_p->hdr, TCP_HDR_BYTES}, entry_p->data[0], entry_p->data[1]};
+			for (int p = 0; p < 3; p++) {
+				if (skip >= parts[p].iov_len) {
+					skip -= parts[p].iov_len;
+					continue;
+				}
+				iov[iovCnt].iov_base = (uint8_t*)parts[p].iov_base + skip;
+				iov[iovCnt].iov_len = parts[p].iov_len - skip;
+				iovCnt++;
+				skip = 0;
+			}
+		}
+		//sendmsg() instead of writev() to not get SIGPIPE if the client reset the connection
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = iov;
+		msg.msg_iovlen = iovCnt;
+		const ssize_t n = sendmsg(client_p->fd, &msg, MSG_NOSIGNAL);
+		if (n < 0) {
+			return (EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno);
+		}
+		inst_p->stats.sendCalls++;
+		inst_p->stats.bytesSent += n;
+		//Release all windows sent completely
+		size_t left = n;
+		while ((client_p->count > 0) && (client_p->headSent + left >= EntryBytes(&client_p->queue[client_p->head]))) {
+			left -= EntryBytes(&client_p->queue[client_p->head]) - client_p->headSent;
+			ReleaseHead(client_p, inst_p->queueDepth);
+		}
+		client_p->headSent += left;
+		//Socket buffer full
+		if (client_p->count > 0) {
+			size_t total = 0;
+			for (int i = 0; i < iovCnt; i++) {
+				total += iov[i].iov_len;
+			}
+			if ((size_t)n < total) {
+				return true;
+			}
+		}
+	}
+	return true;
+}
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+PsiMsDaq_TcpHandle PsiMsDaq_Tcp_Create(	const uint16_t port,
+										const uint32_t maxClients,
+										const uint32_t queueDepth,
+										const PsiMsDaq_TcpPolicy_t policy)
+{
+	//Checks
+	if ((0 == maxClients) || (0 == queueDepth)) {
+		return NULL;
+	}
+	//Initialization and allocation
+	PsiMsDaq_TcpInst_t* inst_p = (PsiMsDaq_TcpInst_t*) calloc(1, sizeof(PsiMsDaq_TcpInst_t));
+	if (NULL == inst_p) {
+		return NULL;
+	}
+	inst_p->maxClients = maxClients;
+	inst_p->queueDepth = queueDepth;
+	inst_p->policy = policy;
+	inst_p->clients = (Client_t*) calloc(maxClients, sizeof(Client_t));
+	bool allocOk = (NULL != inst_p->clients);
+	for (uint32_t i = 0; allocOk && (i < maxClients); i++) {
+		inst_p->clients[i].fd = -1;
+		inst_p->clients[i].queue = (QueueEntry_t*) malloc(sizeof(QueueEntry_t)*queueDepth);
+		allocOk = (NULL != inst_p->clients[i].queue);
+	}
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(port);
+	const int one = 1;
+	inst_p->sockFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if ((!allocOk) || (inst_p->sockFd < 0) ||
+		(0 != setsockopt(inst_p->sockFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one))) ||
+		(0 != bind(inst_p->sockFd, (struct sockaddr*)&addr, sizeof(addr))) ||
+		(0 != listen(inst_p->sockFd, 8))) {
+		if (inst_p->sockFd >= 0) {
+			close(inst_p->sockFd);
+		}
+		for (uint32_t i = 0; (NULL != inst_p->clients) && (i < maxClients); i++) {
+			free(inst_p->clients[i].queue);
+		}
+		free(inst_p->clients);
+		free(inst_p);
+		return NULL;
+	}
+	return (PsiMsDaq_TcpHandle) inst_p;
+}
+
+void PsiMsDaq_Tcp_Destroy(PsiMsDaq_TcpHandle tcpHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_TcpInst_t* inst_p = (PsiMsDaq_TcpInst_t*) tcpHandle;
+	//Implementation
+	for (uint32_t i = 0; i < inst_p->maxClients; i++) {
+		if (inst_p->clients[i].fd >= 0) {
+			Disconnect(inst_p, &inst_p->clients[i]);
+		}
+		free(inst_p->clients[i].queue);
+	}
+	close(inst_p->sockFd);
+	free(inst_p->clients);
+	free(inst_p);
+}
+
+int PsiMsDaq_Tcp_GetFd(PsiMsDaq_TcpHandle tcpHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_TcpInst_t* inst_p = (PsiMsDaq_TcpInst_t*) tcpHandle;
+	//Implementation
+	return inst_p->sockFd;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Tcp_Publish(	PsiMsDaq_TcpHandle tcpHandle,
+											PsiMsDaq_WinInfo_t winInfo,
+											const uint32_t preTrigSamples,
+											const uint32_t postTrigSamples)	//including trigger
+{
+	//Pointer Cast
+	PsiMsDaq_TcpInst_t* inst_p = (PsiMsDaq_TcpInst_t*) tcpHandle;
+	//Setup
+	uint8_t strNr;
+	SAFE_CALL(PsiMsDaq_Str_GetStrNr(winInfo.strHandle, &strNr));
+	const uint32_t strBit = (strNr < 32) ? (1u << strNr) : 0;
+	//Checks
+	if (PsiMsDaq_TcpPolicy_Backpressure == inst_p->policy) {
+		for (uint32_t i = 0; i < inst_p->maxClients; i++) {
+			const Client_t* const client_p = &inst_p->clients[i];
+			if ((client_p->fd >= 0) && (0 != (client_p->strMask & strBit)) && (client_p->count == inst_p->queueDepth)) {
+				return PsiMsDaq_RetCode_QueueFull;
+			}
+		}
+	}
+	//Build the entry (header and data spans, the data may wrap around the window end)
+	QueueEntry_t entry;
+	PsiMsDaq_TcpWinHdr_t hdr;
+	uint32_t samples, bytes, firstAddr, bufStart, winSize;
+	SAFE_CALL(PsiMsDaq_StrWin_GetNoOfSamples(winInfo, &samples));
+	SAFE_CALL(PsiMsDaq_StrWin_GetNoOfBytes(winInfo, &bytes));
+	if (0 == samples) {
+		return PsiMsDaq_RetCode_NoTrigInWin;
+	}
+	SAFE_CALL(PsiMsDaq_StrWin_GetDataRange(winInfo, preTrigSamples, postTrigSamples, &firstAddr, &hdr.bytes));
+	SAFE_CALL(PsiMsDaq_StrWin_GetTimestamp(winInfo, &hdr.timestamp));
+	SAFE_CALL(PsiMsDaq_Str_GetBufferLayout(winInfo.strHandle, &bufStart, &winSize));
+	const uint32_t winEnd = bufStart + winSize*(winInfo.winNr+1);
+	const uint32_t firstBytes = (firstAddr + hdr.bytes > winEnd) ? winEnd - firstAddr : hdr.bytes;
+	entry.winInfo = winInfo;
+	hdr.strNr = strNr;
+	hdr.sampleBytes = bytes/samples;
+	hdr.reserved = 0;
+	hdr.seq = inst_p->seq++;
+	hdr.preTrigSamples = preTrigSamples;
+	hdr.postTrigSamples = postTrigSamples;
+	SerializeHdr(&hdr, entry.hdr);
+	entry.data[0].iov_base = PsiMsDaq_AddrToPtr(winInfo.ipHandle, firstAddr);
+	entry.data[0].iov_len = firstBytes;
+	entry.data[1].iov_base = PsiMsDaq_AddrToPtr(winInfo.ipHandle, winEnd - winSize);
+	entry.data[1].iov_len = hdr.bytes - firstBytes;
+	//Queue for all subscribed clients. The reference of the caller is released at the end, so the window
+	//is freed immediately if no client subscribed to it.
+	SAFE_CALL(PsiMsDaq_StrWin_Retain(winInfo));
+	for (uint32_t i = 0; i < inst_p->maxClients; i++) {
+		Client_t* const client_p = &inst_p->clients[i];
+		if ((client_p->fd < 0) || (0 == (client_p->strMask & strBit))) {
+			continue;
+		}
+		if (client_p->count == inst_p->queueDepth) {
+			inst_p->stats.windowsDropped++;
+			continue;
+		}
+		PsiMsDaq_StrWin_Retain(winInfo);
+		client_p->queue[(client_p->head + client_p->count) % inst_p->queueDepth] = entry;
+		client_p->count++;
+		inst_p->stats.windowsQueued++;
+	}
+	SAFE_CALL(PsiMsDaq_StrWin_Release(winInfo));
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Tcp_Handle(PsiMsDaq_TcpHandle tcpHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_TcpInst_t* inst_p = (PsiMsDaq_TcpInst_t*) tcpHandle;
+	//Implementation
+	Accept(inst_p);
+	for (uint32_t i = 0; i < inst_p->maxClients; i++) {
+		Client_t* const client_p = &inst_p->clients[i];
+		if (client_p->fd < 0) {
+			continue;
+		}
+		if ((!Receive(client_p)) || (!Send(inst_p, client_p))) {
+			Disconnect(inst_p, client_p);
+		}
+	}
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Tcp_GetStats(	PsiMsDaq_TcpHandle tcpHandle,
+											PsiMsDaq_TcpStats_t* const stats_p)
+{
+	//Pointer Cast
+	PsiMsDaq_TcpInst_t* inst_p = (PsiMsDaq_TcpInst_t*) tcpHandle;
+	//Implementation
+	*stats_p = inst_p->stats;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
@@ -0,0 +1,154 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Batched TCP streaming of windows to remote consumers (Linux only)
+*
+* The server listens on a TCP port. Every window published is queued for all subscribed clients and sent
+* as a header (see PsiMsDaq_TcpWinHdr_t) followed by the raw window data. The data is not copied: the queue
+* entries point into the window buffer and all queued windows of a client are sent with a single vectored
+* send (sendmsg()) from the window spans directly. The window is retained until it was sent to every client
+* it was queued for.
+*
+* Clients are subscribed to all streams after connecting. A client can change its subscription at any
+* time by sending a 32-bit stream mask (bit N = stream N, little endian).
+*
+* If the queue of a client is full, the policy decides what happens:
+* - PsiMsDaq_TcpPolicy_Backpressure: PsiMsDaq_Tcp_Publish() returns PsiMsDaq_RetCode_QueueFull and the window is
+*   not queued for any client. The caller keeps the window and tries again later.
+* - PsiMsDaq_TcpPolicy_Drop: The window is not sent to this client. Clients detect dropped windows by gaps in the
+*   sequence number.
+*
+* The server does not create any threads. The user calls PsiMsDaq_Tcp_Handle() from its event loop, either
+* periodically or whenever the file descriptor returned by PsiMsDaq_Tcp_GetFd() is readable. Windows are only sent
+* in PsiMsDaq_Tcp_Handle(), so all windows published in between are sent as one batch.
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq.h"
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef void* PsiMsDaq_TcpHandle;	///< Handle to a TCP server
+
+/**
+ * @brief	Policy for clients that do not keep up
+ */
+typedef enum {
+	PsiMsDaq_TcpPolicy_Backpressure	= 0,	///< Stop publishing until the client queue has space again
+	PsiMsDaq_TcpPolicy_Drop			= 1		///< Do not send the window to the client
+} PsiMsDaq_TcpPolicy_t;
+
+/**
+ * @brief	Header sent in front of each window. On the wire, the fields are sent in this order without padding (32 bytes)
+ * 			in little endian byte order, independent of the host.
+ */
+typedef struct {
+	uint32_t bytes;				///< Number of data bytes following the header
+	uint8_t strNr;				///< Stream number
+	uint8_t sampleBytes;		///< Size of one sample in bytes
+	uint16_t reserved;			///< Reserved (0)
+	uint64_t seq;				///< Sequence number (incremented for every window published)
+	uint64_t timestamp;			///< Trigger timestamp
+	uint32_t preTrigSamples;	///< Number of pre-trigger samples in the data
+	uint32_t postTrigSamples;	///< Number of post-trigger samples in the data (including the trigger sample)
+} PsiMsDaq_TcpWinHdr_t;
+
+/**
+ * @brief	Statistics of a TCP server
+ */
+typedef struct {
+	uint32_t clients;			///< Number of connected clients
+	uint64_t windowsQueued;		///< Number of windows queued (counted per client)
+	uint64_t windowsDropped;	///< Number of windows not queued because of a full client queue (counted per client)
+	uint64_t bytesSent;			///< Number of bytes sent (including headers)
+	uint64_t sendCalls;			///< Number of vectored send calls
+} PsiMsDaq_TcpStats_t;
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+
+/**
+ * @brief	Create a TCP server
+ *
+ * @param	port			TCP port to listen on (all interfaces)
+ * @param	maxClients		Maximum number of clients (further connections are closed immediately)
+ * @param	queueDepth		Maximum number of windows queued per client
+ * @param	policy			Policy applied if the queue of a client is full
+ * @return	Handle of the server or NULL if the creation failed
+ */
+PsiMsDaq_TcpHandle PsiMsDaq_Tcp_Create(	const uint16_t port,
+										const uint32_t maxClients,
+										const uint32_t queueDepth,
+										const PsiMsDaq_TcpPolicy_t policy);
+
+/**
+ * @brief	Disconnect all clients, release all queued windows and free all resources of a server
+ *
+ * @param	tcpHandle	Handle of the server
+ */
+void PsiMsDaq_Tcp_Destroy(PsiMsDaq_TcpHandle tcpHandle);
+
+/**
+ * @brief	Get the listening socket (readable when a client connects)
+ *
+ * @param	tcpHandle	Handle of the server
+ * @return	File descriptor
+ */
+int PsiMsDaq_Tcp_GetFd(PsiMsDaq_TcpHandle tcpHandle);
+
+/**
+ * @brief	Queue a window for all subscribed clients. After this function succeeded, the window is freed by the
+ * 			server once it was sent to all of them, so it must not be freed using PsiMsDaq_StrWin_MarkAsFree() by the
+ * 			caller anymore (references the caller took itself must still be released).
+ *
+ * @param	tcpHandle		Handle of the server
+ * @param	winInfo			Window information
+ * @param 	preTrigSamples	Number of pre trigger samples to send
+ * @param 	postTrigSamples	Number of post trigger samples to send (including the trigger sample)
+ * @return	Return Code (PsiMsDaq_RetCode_QueueFull if a client queue is full and the policy is backpressure)
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Tcp_Publish(	PsiMsDaq_TcpHandle tcpHandle,
+											PsiMsDaq_WinInfo_t winInfo,
+											const uint32_t preTrigSamples,
+											const uint32_t postTrigSamples);	//including trigger
+
+/**
+ * @brief	Accept new clients, receive subscriptions and send all queued windows (non blocking)
+ *
+ * @param	tcpHandle	Handle of the server
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Tcp_Handle(PsiMsDaq_TcpHandle tcpHandle);
+
+/**
+ * @brief	Get the statistics of a server
+ *
+ * @param	tcpHandle	Handle of the server
+ * @param	stats_p		Pointer to write the statistics into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Tcp_GetStats(	PsiMsDaq_TcpHandle tcpHandle,
+											PsiMsDaq_TcpStats_t* const stats_p);
+
+#ifdef __cplusplus
+}
+#endif
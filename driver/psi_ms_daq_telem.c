@@ -0,0 +1,265 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#include "psi_ms_daq_telem.h"
+#include <stdlib.h>
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef struct {
+	bool isMonitored;
+	uint32_t bufferDepth;
+	uint32_t warnLevel;
+	uint32_t stallSamples;
+	uint32_t lastPtr;
+	uint32_t samplesNoProgress;
+	bool stallReported;
+	PsiMsDaq_TelemHist_t hist;
+} PsiMsDaq_TelemStr_t;
+
+typedef struct {
+	PsiMsDaq_IpHandle ipHandle;
+	uint8_t streams;
+	PsiMsDaq_TelemEvt_f* evtFct;
+	void* evtArg;
+	uint32_t* regs;
+	uint32_t* ctx;
+	PsiMsDaq_StrHandle* strHandles;
+	PsiMsDaq_TelemStr_t* str;
+} PsiMsDaq_TelemInst_t;
+
+//*******************************************************************************
+// Macros
+//*******************************************************************************
+#define SAFE_CALL(fctCall) { \
+		PsiMsDaq_RetCode_t r = fctCall; \
+		if (PsiMsDaq_RetCode_Success != r) {return r;}}
+
+//Registers per stream in the ACQCONF block (MAXLVL, POSTTRIG, MODE, LASTWIN)
+#define REGS_PER_STR	4
+#define REG_IDX_MAXLVL	0
+#define REG_IDX_MODE	2
+
+//Words per stream in the context memory (SCFG, BUFSTART, WINSIZE, PTR, WINEND, reserved)
+#define CTX_PER_STR		8
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+static PsiMsDaq_RetCode_t CheckMonStrNr(	PsiMsDaq_TelemInst_t* const inst_p,
+											const uint8_t streamNr)
+{
+	if (streamNr >= inst_p->streams) {
+		return PsiMsDaq_RetCode_IllegalStrNr;
+	}
+	return PsiMsDaq_RetCode_Success;
+}
+
+static void ClearHist(PsiMsDaq_TelemHist_t* const hist_p)
+{
+	memset(hist_p, 0, sizeof(PsiMsDaq_TelemHist_t));
+}
+
+static void FreeInst(PsiMsDaq_TelemInst_t* const inst_p)
+{
+	free(inst_p->regs);
+	free(inst_p->ctx);
+	free(inst_p->strHandles);
+	free(inst_p->str);
+	free(inst_p);
+}
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+PsiMsDaq_TelemHandle PsiMsDaq_Telem_Create(	PsiMsDaq_IpHandle ipHandle,
+											const uint8_t streams)
+{
+	//Initialization and allocation
+	PsiMsDaq_TelemInst_t* inst_p = (PsiMsDaq_TelemInst_t*) malloc(sizeof(PsiMsDaq_TelemInst_t));
+	if (NULL == inst_p) {
+		return NULL;
+	}
+	inst_p->regs = (uint32_t*) malloc(sizeof(uint32_t)*REGS_PER_STR*streams);
+	inst_p->ctx = (uint32_t*) malloc(sizeof(uint32_t)*CTX_PER_STR*streams);
+	inst_p->strHandles = (PsiMsDaq_StrHandle*) malloc(sizeof(PsiMsDaq_StrHandle)*streams);
+	inst_p->str = (PsiMsDaq_TelemStr_t*) malloc(sizeof(PsiMsDaq_TelemStr_t)*streams);
+	if ((NULL == inst_p->regs) || (NULL == inst_p->ctx) || (NULL == inst_p->strHandles) || (NULL == inst_p->str)) {
+		FreeInst(inst_p);
+		return NULL;
+	}
+	//Stream handles are looked up once, so sampling does not have to do it
+	for (int str = 0; str < streams; str++) {
+		if (PsiMsDaq_RetCode_Success != PsiMsDaq_GetStrHandle(ipHandle, str, &inst_p->strHandles[str])) {
+			FreeInst(inst_p);
+			return NULL;
+		}
+	}
+	inst_p->ipHandle = ipHandle;
+	inst_p->streams = streams;
+	inst_p->evtFct = NULL;
+	inst_p->evtArg = NULL;
+	for (int str = 0; str < streams; str++) {
+		inst_p->str[str].isMonitored = false;
+		ClearHist(&inst_p->str[str].hist);
+	}
+	return (PsiMsDaq_TelemHandle) inst_p;
+}
+
+void PsiMsDaq_Telem_Destroy(PsiMsDaq_TelemHandle telemHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_TelemInst_t* inst_p = (PsiMsDaq_TelemInst_t*) telemHandle;
+	//Implementation
+	FreeInst(inst_p);
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Telem_ConfigureStr(	PsiMsDaq_TelemHandle telemHandle,
+												const uint8_t streamNr,
+												const uint32_t bufferDepth,
+												const uint32_t warnLevel,
+												const uint32_t stallSamples)
+{
+	//Pointer Cast
+	PsiMsDaq_TelemInst_t* inst_p = (PsiMsDaq_TelemInst_t*) telemHandle;
+	//Checks
+	SAFE_CALL(CheckMonStrNr(inst_p, streamNr));
+	if (0 == bufferDepth) {
+		return PsiMsDaq_RetCode_IllegalBufferDepth;
+	}
+	//Implementation
+	PsiMsDaq_TelemStr_t* str_p = &inst_p->str[streamNr];
+	str_p->bufferDepth = bufferDepth;
+	str_p->warnLevel = warnLevel;
+	str_p->stallSamples = stallSamples;
+	str_p->lastPtr = 0;
+	str_p->samplesNoProgress = 0;
+	str_p->stallReported = false;
+	str_p->isMonitored = true;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Telem_SetCallback(	PsiMsDaq_TelemHandle telemHandle,
+												PsiMsDaq_TelemEvt_f* evtCb,
+												void* arg_p)
+{
+	//Pointer Cast
+	PsiMsDaq_TelemInst_t* inst_p = (PsiMsDaq_TelemInst_t*) telemHandle;
+	//Implementation
+	inst_p->evtFct = evtCb;
+	inst_p->evtArg = arg_p;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Telem_Sample(PsiMsDaq_TelemHandle telemHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_TelemInst_t* inst_p = (PsiMsDaq_TelemInst_t*) telemHandle;
+
+	//Read per-stream registers of all streams in one block
+	SAFE_CALL(PsiMsDaq_RegReadBlock(inst_p->ipHandle, PSI_MS_DAQ_REG_MAXLVL(0), inst_p->regs, REGS_PER_STR*inst_p->streams));
+
+	//Clear levels right after the read (only if required, to save register accesses). MAXLVL is not read-to-clear, so a
+	//..peak reached between the block read and the clear is lost. Clearing before any evaluation keeps this window at a
+	//..few register accesses.
+	bool needPtrs = false;
+	for (int str = 0; str < inst_p->streams; str++) {
+		const PsiMsDaq_TelemStr_t* str_p = &inst_p->str[str];
+		if (!str_p->isMonitored) {
+			continue;
+		}
+		if (0 != inst_p->regs[REGS_PER_STR*str+REG_IDX_MAXLVL]) {
+			SAFE_CALL(PsiMsDaq_Str_ClrMaxLvl(inst_p->strHandles[str]));
+		}
+		needPtrs |= (0 != str_p->stallSamples);
+	}
+
+	//Read the write pointers of all streams in one block from the context memory (only if stall detection is used)
+	if (needPtrs) {
+		SAFE_CALL(PsiMsDaq_RegReadBlock(inst_p->ipHandle, PSI_MS_DAQ_CTX_PTR(0), inst_p->ctx, CTX_PER_STR*(inst_p->streams-1)+1));
+	}
+
+	//Evaluate streams
+	for (int str = 0; str < inst_p->streams; str++) {
+		PsiMsDaq_TelemStr_t* str_p = &inst_p->str[str];
+		if (!str_p->isMonitored) {
+			continue;
+		}
+		PsiMsDaq_StrHandle strHandle = inst_p->strHandles[str];
+		const uint32_t maxLvl = inst_p->regs[REGS_PER_STR*str+REG_IDX_MAXLVL];
+		const bool isRecording = (0 != (inst_p->regs[REGS_PER_STR*str+REG_IDX_MODE] & PSI_MS_DAQ_REG_MODE_BIT_REC));
+
+		//Histogram
+		uint32_t bin = (uint32_t)(((uint64_t)maxLvl*PSI_MS_DAQ_TELEM_BINS)/str_p->bufferDepth);
+		if (bin >= PSI_MS_DAQ_TELEM_BINS) {
+			bin = PSI_MS_DAQ_TELEM_BINS-1;
+		}
+		str_p->hist.bins[bin]++;
+		if (maxLvl > str_p->hist.peakLvl) {
+			str_p->hist.peakLvl = maxLvl;
+		}
+
+		//Near overflow detection
+		if (maxLvl >= str_p->warnLevel) {
+			str_p->hist.nearOverflowCnt++;
+			if (NULL != inst_p->evtFct) {
+				inst_p->evtFct(strHandle, PsiMsDaq_TelemEvt_NearOverflow, maxLvl, inst_p->evtArg);
+			}
+		}
+
+		//Stall detection (reported once per stall)
+		if (0 != str_p->stallSamples) {
+			const uint32_t ptr = inst_p->ctx[CTX_PER_STR*str];
+			if (isRecording && (ptr == str_p->lastPtr)) {
+				str_p->samplesNoProgress++;
+			}
+			else {
+				str_p->samplesNoProgress = 0;
+				str_p->stallReported = false;
+			}
+			str_p->lastPtr = ptr;
+			if ((str_p->samplesNoProgress >= str_p->stallSamples) && !str_p->stallReported) {
+				str_p->stallReported = true;
+				str_p->hist.stallCnt++;
+				if (NULL != inst_p->evtFct) {
+					inst_p->evtFct(strHandle, PsiMsDaq_TelemEvt_Stalled, maxLvl, inst_p->evtArg);
+				}
+			}
+		}
+	}
+
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Telem_GetHistogram(	PsiMsDaq_TelemHandle telemHandle,
+												const uint8_t streamNr,
+												PsiMsDaq_TelemHist_t* const hist_p)
+{
+	//Pointer Cast
+	PsiMsDaq_TelemInst_t* inst_p = (PsiMsDaq_TelemInst_t*) telemHandle;
+	//Checks
+	SAFE_CALL(CheckMonStrNr(inst_p, streamNr));
+	//Implementation
+	*hist_p = inst_p->str[streamNr].hist;
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
+
+PsiMsDaq_RetCode_t PsiMsDaq_Telem_ClearHistograms(PsiMsDaq_TelemHandle telemHandle)
+{
+	//Pointer Cast
+	PsiMsDaq_TelemInst_t* inst_p = (PsiMsDaq_TelemInst_t*) telemHandle;
+	//Implementation
+	for (int str = 0; str < inst_p->streams; str++) {
+		ClearHist(&inst_p->str[str].hist);
+	}
+	//Done
+	return PsiMsDaq_RetCode_Success;
+}
@@ -0,0 +1,162 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Input buffer fill-level telemetry
+*
+* The telemetry sampler periodically reads and clears the maximum input buffer fill level (MAXLVL) of all
+* monitored streams and builds a fill-level histogram per stream. The per-stream registers of all
+* streams are read in one block (see PsiMsDaq_RegReadBlock()), this also returns the recording state. MAXLVL is only
+* cleared for streams where it is non-zero. For stall detection, the write pointers of all streams are read in a second
+* block from the context memory.
+*
+* MAXLVL is not cleared on read, so the sampler clears it right after the block read. A fill-level peak that
+* occurs between the read and the clear (a few register accesses) is not seen.
+*
+* Two kinds of events are reported to a user callback:
+* - Near overflow: The maximum fill level of a stream reached the warning level
+* - Stalled: A stream is recording but its write pointer did not move for a configurable number of samples
+*
+* The sampler does not create any threads. The user calls PsiMsDaq_Telem_Sample() periodically (e.g. from a timer).
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq.h"
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define PSI_MS_DAQ_TELEM_BINS		16		///< Number of histogram bins (equally spaced over the buffer depth)
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef void* PsiMsDaq_TelemHandle;	///< Handle to a telemetry sampler
+
+/**
+ * @brief	Telemetry events
+ */
+typedef enum {
+	PsiMsDaq_TelemEvt_NearOverflow	= 0,	///< The fill level reached the warning level
+	PsiMsDaq_TelemEvt_Stalled		= 1		///< The stream is recording but does not make progress
+} PsiMsDaq_TelemEvt_t;
+
+/**
+ * @brief	Telemetry event callback
+ *
+ * @param	strHandle	Handle of the stream the event belongs to
+ * @param	evt			Event
+ * @param	maxLvl		Maximum fill level seen in the last sampling period
+ * @param	arg			User argument
+ */
+typedef void PsiMsDaq_TelemEvt_f(PsiMsDaq_StrHandle strHandle, PsiMsDaq_TelemEvt_t evt, uint32_t maxLvl, void* arg);
+
+/**
+ * @brief	Fill-level statistics of a stream
+ */
+typedef struct {
+	uint32_t bins[PSI_MS_DAQ_TELEM_BINS];	///< Number of sampling periods per fill-level bin
+	uint32_t peakLvl;						///< Highest fill level seen
+	uint32_t nearOverflowCnt;				///< Number of sampling periods the warning level was reached
+	uint32_t stallCnt;						///< Number of stalls detected
+} PsiMsDaq_TelemHist_t;
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+
+/**
+ * @brief	Create a telemetry sampler
+ *
+ * @param	ipHandle	Driver handle for the whole IP
+ * @param	streams		Number of streams to monitor (streams 0 ... streams-1)
+ * @return	Handle of the sampler or NULL if the creation failed
+ *
+ * @note	Streams are only monitored after they are configured by PsiMsDaq_Telem_ConfigureStr()
+ */
+PsiMsDaq_TelemHandle PsiMsDaq_Telem_Create(	PsiMsDaq_IpHandle ipHandle,
+											const uint8_t streams);
+
+/**
+ * @brief	Destroy a telemetry sampler
+ *
+ * @param	telemHandle	Handle of the sampler
+ */
+void PsiMsDaq_Telem_Destroy(PsiMsDaq_TelemHandle telemHandle);
+
+/**
+ * @brief	Configure monitoring of a stream
+ *
+ * @param	telemHandle		Handle of the sampler
+ * @param	streamNr		Stream number
+ * @param	bufferDepth		Depth of the input buffer of the stream (StreamBuffer_g of the IP)
+ * @param	warnLevel		Fill level at which a PsiMsDaq_TelemEvt_NearOverflow event is fired
+ * @param	stallSamples	Number of consecutive samples without write pointer progress after which a
+ * 							PsiMsDaq_TelemEvt_Stalled event is fired (0 = no stall detection)
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Telem_ConfigureStr(	PsiMsDaq_TelemHandle telemHandle,
+												const uint8_t streamNr,
+												const uint32_t bufferDepth,
+												const uint32_t warnLevel,
+												const uint32_t stallSamples);
+
+/**
+ * @brief	Set the event callback
+ *
+ * @param	telemHandle		Handle of the sampler
+ * @param	evtCb			Callback function. Pass NULL to unregister the callback.
+ * @param	arg_p			Argument passed to the callback
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Telem_SetCallback(	PsiMsDaq_TelemHandle telemHandle,
+												PsiMsDaq_TelemEvt_f* evtCb,
+												void* arg_p);
+
+/**
+ * @brief	Take one sample of all monitored streams. Events are reported from within this function.
+ *
+ * @param	telemHandle		Handle of the sampler
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Telem_Sample(PsiMsDaq_TelemHandle telemHandle);
+
+/**
+ * @brief	Get the fill-level statistics of a stream
+ *
+ * @param	telemHandle		Handle of the sampler
+ * @param	streamNr		Stream number
+ * @param	hist_p			Pointer to write the statistics into
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Telem_GetHistogram(	PsiMsDaq_TelemHandle telemHandle,
+												const uint8_t streamNr,
+												PsiMsDaq_TelemHist_t* const hist_p);
+
+/**
+ * @brief	Clear the fill-level statistics of all streams
+ *
+ * @param	telemHandle		Handle of the sampler
+ * @return	Return Code
+ */
+PsiMsDaq_RetCode_t PsiMsDaq_Telem_ClearHistograms(PsiMsDaq_TelemHandle telemHandle);
+
+#ifdef __cplusplus
+}
+#endif
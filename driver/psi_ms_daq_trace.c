@@ -0,0 +1,776 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#define _POSIX_C_SOURCE 200809L
+#include "psi_ms_daq_trace.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define TRACE_MAGIC			"PMDTRC01"
+#define TRACE_MAGIC_LEN		8
+#define WRITER_BUF_SIZE		(64*1024)
+#define VARINT_MAX_BYTES	10
+#define MODEL_SIZE			(1 << 15)		//Entries of the register model (power of two, more than registers of the IP)
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef enum {
+	TraceMode_Idle,
+	TraceMode_Record,
+	TraceMode_Replay
+} TraceMode_t;
+
+typedef struct {
+	FILE* file_p;
+	uint8_t buf[2][WRITER_BUF_SIZE];	//One buffer is filled while the other one is written to the file
+	uint8_t cur;
+	size_t fill;
+	//File writer thread (file I/O is done without holding the trace lock)
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	uint8_t pendingBuf;
+	size_t pendingFill;		//0 if no buffer is waiting to be written
+	bool stop;
+	bool error;
+	uint64_t lastTime;
+	uint32_t lastAddr;
+	char* names[PSI_MS_DAQ_TRACE_MAX_NAMES];
+	uint32_t nameCnt;
+} TraceWriter_t;
+
+typedef struct {
+	uint32_t addr;
+	uint32_t value;
+	bool used;
+} ReplayRead_t;
+
+typedef struct {
+	uint32_t nameId;
+	uint32_t first;			//Index of the first read of the section
+	uint32_t end;			//Index after the last read of the section
+	uint32_t cursor;		//Reads before this index are used
+} ReplaySection_t;
+
+typedef struct {
+	uint32_t addr;
+	uint32_t value;
+	bool valid;
+} ModelEntry_t;
+
+typedef struct {
+	pthread_mutex_t lock;
+	TraceMode_t mode;
+	PsiMsDaq_AccessFct_t backend;
+	PsiMsDaq_RegReadBlock_f* backendBlk;
+	PsiMsDaq_RegReadBlock_f* blkFct;		//Block read function provided to the driver
+	TraceWriter_t* wr_p;	//NULL if no trace is written
+	PsiMsDaq_TraceStats_t stats;
+	//Replay
+	ReplayRead_t* reads;
+	uint32_t readCnt;
+	ReplaySection_t* sections;
+	uint32_t sectionCnt;
+	uint32_t curSection;
+	char* recNames[PSI_MS_DAQ_TRACE_MAX_NAMES+1];
+	ModelEntry_t* model;
+} TraceState_t;
+
+//*******************************************************************************
+// Variables
+//*******************************************************************************
+static TraceState_t trace = {.lock = PTHREAD_MUTEX_INITIALIZER, .mode = TraceMode_Idle};
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+static uint64_t Now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec*1000000000ull + ts.tv_nsec;
+}
+
+static bool NamesEqual(const char* const a, const char* const b)
+{
+	if ((NULL == a) || (NULL == b)) {
+		return a == b;
+	}
+	return 0 == strcmp(a, b);
+}
+
+//Standard access functions (used if recording without backend)
+static void StdDataCopy(void* dst, void* src, size_t n)
+{
+	memcpy(dst, src, n);
+}
+
+static void StdRegWrite(const uint32_t addr, const uint32_t value)
+{
+	volatile uint32_t* addr_p = (volatile uint32_t *)(size_t)addr;
+	*addr_p = value;
+}
+
+static uint32_t StdRegRead(const uint32_t addr)
+{
+	volatile uint32_t* addr_p = (volatile uint32_t *)(size_t)addr;
+	return *addr_p;
+}
+
+static void StdRegReadBlock(const uint32_t addr, uint32_t* const values_p, const uint32_t count)
+{
+	volatile uint32_t* addr_p = (volatile uint32_t *)(size_t)addr;
+	for (uint32_t i = 0; i < count; i++) {
+		values_p[i] = addr_p[i];
+	}
+}
+
+//Trace writer
+static void* WrThread(void* arg)
+{
+	TraceWriter_t* const wr_p = (TraceWriter_t*) arg;
+	pthread_mutex_lock(&wr_p->lock);
+	for (;;) {
+		while ((0 == wr_p->pendingFill) && (!wr_p->stop)) {
+			pthread_cond_wait(&wr_p->cond, &wr_p->lock);
+		}
+		if (0 == wr_p->pendingFill) {
+			break;
+		}
+		const uint8_t* const buf_p = wr_p->buf[wr_p->pendingBuf];
+		const size_t fill = wr_p->pendingFill;
+		pthread_mutex_unlock(&wr_p->lock);
+		const bool ok = (fwrite(buf_p, 1, fill, wr_p->file_p) == fill);
+		pthread_mutex_lock(&wr_p->lock);
+		wr_p->error = wr_p->error || !ok;
+		wr_p->pendingFill = 0;
+		pthread_cond_broadcast(&wr_p->cond);
+	}
+	pthread_mutex_unlock(&wr_p->lock);
+	return NULL;
+}
+
+static void WrFlush(TraceWriter_t* const wr_p)
+{
+	if (0 == wr_p->fill) {
+		return;
+	}
+	//Hand the buffer over to the writer thread (only waits if the file is slower than the trace is filled)
+	pthread_mutex_lock(&wr_p->lock);
+	while (0 != wr_p->pendingFill) {
+		pthread_cond_wait(&wr_p->cond, &wr_p->lock);
+	}
+	wr_p->pendingBuf = wr_p->cur;
+	wr_p->pendingFill = wr_p->fill;
+	pthread_cond_broadcast(&wr_p->cond);
+	pthread_mutex_unlock(&wr_p->lock);
+	trace.stats.fileBytes += wr_p->fill;
+	wr_p->cur ^= 1;
+	wr_p->fill = 0;
+}
+
+static void WrByte(TraceWriter_t* const wr_p, const uint8_t value)
+{
+	if (wr_p->fill >= WRITER_BUF_SIZE) {
+		WrFlush(wr_p);
+	}
+	wr_p->buf[wr_p->cur][wr_p->fill++] = value;
+}
+
+static void WrVarint(TraceWriter_t* const wr_p, uint64_t value)
+{
+	if (wr_p->fill + VARINT_MAX_BYTES > WRITER_BUF_SIZE) {
+		WrFlush(wr_p);
+	}
+	while (value >= 0x80) {
+		wr_p->buf[wr_p->cur][wr_p->fill++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	wr_p->buf[wr_p->cur][wr_p->fill++] = (uint8_t)value;
+}
+
+static void WrRecord(TraceWriter_t* const wr_p, const PsiMsDaq_TraceRec_t type, const uint64_t start)
+{
+	//Accesses from different threads may be logged out of order, time does not go backwards in the trace
+	WrByte(wr_p, (uint8_t)type);
+	WrVarint(wr_p, (start > wr_p->lastTime) ? start - wr_p->lastTime : 0);
+	wr_p->lastTime = (start > wr_p->lastTime) ? start : wr_p->lastTime;
+}
+
+static void WrAddr(TraceWriter_t* const wr_p, const uint32_t addr)
+{
+	const int64_t diff = (int64_t)addr - (int64_t)wr_p->lastAddr;
+	WrVarint(wr_p, ((uint64_t)diff << 1) ^ (uint64_t)(diff >> 63));
+	wr_p->lastAddr = addr;
+}
+
+static TraceWriter_t* WrOpen(const char* const path, const uint8_t flags)
+{
+	TraceWriter_t* wr_p = (TraceWriter_t*) calloc(1, sizeof(TraceWriter_t));
+	if (NULL == wr_p) {
+		return NULL;
+	}
+	wr_p->file_p = fopen(path, "wb");
+	if (NULL == wr_p->file_p) {
+		free(wr_p);
+		return NULL;
+	}
+	pthread_mutex_init(&wr_p->lock, NULL);
+	pthread_cond_init(&wr_p->cond, NULL);
+	if (0 != pthread_create(&wr_p->thread, NULL, WrThread, wr_p)) {
+		pthread_cond_destroy(&wr_p->cond);
+		pthread_mutex_destroy(&wr_p->lock);
+		fclose(wr_p->file_p);
+		free(wr_p);
+		return NULL;
+	}
+	wr_p->lastTime = Now();
+	memcpy(wr_p->buf[0], TRACE_MAGIC, TRACE_MAGIC_LEN);
+	wr_p->buf[0][TRACE_MAGIC_LEN] = flags;
+	wr_p->fill = TRACE_MAGIC_LEN+1;
+	return wr_p;
+}
+
+static bool WrClose(TraceWriter_t* const wr_p)
+{
+	WrFlush(wr_p);
+	pthread_mutex_lock(&wr_p->lock);
+	wr_p->stop = true;
+	pthread_cond_broadcast(&wr_p->cond);
+	pthread_mutex_unlock(&wr_p->lock);
+	pthread_join(wr_p->thread, NULL);
+	pthread_cond_destroy(&wr_p->cond);
+	pthread_mutex_destroy(&wr_p->lock);
+	bool ok = !wr_p->error;
+	ok = (0 == fclose(wr_p->file_p)) && ok;
+	for (uint32_t i = 0; i < wr_p->nameCnt; i++) {
+		free(wr_p->names[i]);
+	}
+	free(wr_p);
+	return ok;
+}
+
+//Logging of accesses (called with the lock held)
+static void LogAccess(const PsiMsDaq_TraceRec_t type, const uint32_t addr, const uint32_t value, const uint64_t start, const uint64_t duration)
+{
+	if (PsiMsDaq_TraceRec_Read == type) {
+		trace.stats.reads++;
+	}
+	else {
+		trace.stats.writes++;
+	}
+	if (NULL != trace.wr_p) {
+		WrRecord(trace.wr_p, type, start);
+		WrAddr(trace.wr_p, addr);
+		WrVarint(trace.wr_p, value);
+		WrVarint(trace.wr_p, duration);
+	}
+}
+
+static void LogBlock(const uint32_t addr, const uint32_t* const values_p, const uint32_t count, const uint64_t start, const uint64_t duration)
+{
+	trace.stats.reads += count;
+	trace.stats.blockReads++;
+	if (NULL != trace.wr_p) {
+		WrRecord(trace.wr_p, PsiMsDaq_TraceRec_ReadBlock, start);
+		WrAddr(trace.wr_p, addr);
+		WrVarint(trace.wr_p, count);
+		for (uint32_t i = 0; i < count; i++) {
+			WrVarint(trace.wr_p, values_p[i]);
+		}
+		WrVarint(trace.wr_p, duration);
+	}
+}
+
+static void LogCopy(const size_t bytes, const uint64_t start, const uint64_t duration)
+{
+	trace.stats.copyBytes += bytes;
+	if (NULL != trace.wr_p) {
+		WrRecord(trace.wr_p, PsiMsDaq_TraceRec_Copy, start);
+		WrVarint(trace.wr_p, bytes);
+		WrVarint(trace.wr_p, duration);
+	}
+}
+
+static void LogMark(const char* const api, const uint64_t start)
+{
+	trace.stats.marks++;
+	if (NULL == trace.wr_p) {
+		return;
+	}
+	TraceWriter_t* const wr_p = trace.wr_p;
+	//Get marker id (names are defined on first use)
+	uint32_t id = 0;
+	if (NULL != api) {
+		for (uint32_t i = 0; (0 == id) && (i < wr_p->nameCnt); i++) {
+			if (0 == strcmp(wr_p->names[i], api)) {
+				id = i+1;
+			}
+		}
+		if ((0 == id) && (wr_p->nameCnt < PSI_MS_DAQ_TRACE_MAX_NAMES)) {
+			const size_t len = strnlen(api, UINT8_MAX);
+			char* name_p = (char*) malloc(len+1);
+			if (NULL != name_p) {
+				memcpy(name_p, api, len);
+				name_p[len] = 0;
+				wr_p->names[wr_p->nameCnt++] = name_p;
+				id = wr_p->nameCnt;
+				WrRecord(wr_p, PsiMsDaq_TraceRec_Name, start);
+				WrVarint(wr_p, id);
+				WrByte(wr_p, (uint8_t)len);
+				for (size_t i = 0; i < len; i++) {
+					WrByte(wr_p, (uint8_t)name_p[i]);
+				}
+			}
+		}
+	}
+	WrRecord(wr_p, PsiMsDaq_TraceRec_Mark, start);
+	WrVarint(wr_p, id);
+}
+
+//Recording access functions
+static void RecDataCopy(void* dst, void* src, size_t n)
+{
+	const uint64_t start = Now();
+	trace.backend.dataCopy(dst, src, n);
+	const uint64_t duration = Now() - start;
+	pthread_mutex_lock(&trace.lock);
+	LogCopy(n, start, duration);
+	pthread_mutex_unlock(&trace.lock);
+}
+
+static void RecRegWrite(const uint32_t addr, const uint32_t value)
+{
+	const uint64_t start = Now();
+	trace.backend.regWrite(addr, value);
+	const uint64_t duration = Now() - start;
+	pthread_mutex_lock(&trace.lock);
+	LogAccess(PsiMsDaq_TraceRec_Write, addr, value, start, duration);
+	pthread_mutex_unlock(&trace.lock);
+}
+
+static uint32_t RecRegRead(const uint32_t addr)
+{
+	const uint64_t start = Now();
+	const uint32_t value = trace.backend.regRead(addr);
+	const uint64_t duration = Now() - start;
+	pthread_mutex_lock(&trace.lock);
+	LogAccess(PsiMsDaq_TraceRec_Read, addr, value, start, duration);
+	pthread_mutex_unlock(&trace.lock);
+	return value;
+}
+
+static void RecRegReadBlock(const uint32_t addr, uint32_t* const values_p, const uint32_t count)
+{
+	const uint64_t start = Now();
+	trace.backendBlk(addr, values_p, count);
+	const uint64_t duration = Now() - start;
+	pthread_mutex_lock(&trace.lock);
+	LogBlock(addr, values_p, count, start, duration);
+	pthread_mutex_unlock(&trace.lock);
+}
+
+//Register model for replay (called with the lock held)
+static ModelEntry_t* ModelFind(const uint32_t addr)
+{
+	uint32_t idx = ((addr >> 2) * 2654435761u) & (MODEL_SIZE-1);
+	for (uint32_t i = 0; i < MODEL_SIZE; i++) {
+		ModelEntry_t* const entry_p = &trace.model[idx];
+		if ((!entry_p->valid) || (entry_p->addr == addr)) {
+			return entry_p;
+		}
+		idx = (idx+1) & (MODEL_SIZE-1);
+	}
+	return NULL;
+}
+
+static void ModelSet(const uint32_t addr, const uint32_t value)
+{
+	ModelEntry_t* const entry_p = ModelFind(addr);
+	if (NULL != entry_p) {
+		entry_p->addr = addr;
+		entry_p->value = value;
+		entry_p->valid = true;
+	}
+}
+
+static uint32_t ReplayLookup(const uint32_t addr)
+{
+	//Search the first unused read of the address in the current section
+	if (trace.curSection < trace.sectionCnt) {
+		ReplaySection_t* const sec_p = &trace.sections[trace.curSection];
+		while ((sec_p->cursor < sec_p->end) && trace.reads[sec_p->cursor].used) {
+			sec_p->cursor++;
+		}
+		for (uint32_t i = sec_p->cursor; i < sec_p->end; i++) {
+			ReplayRead_t* const read_p = &trace.reads[i];
+			if ((!read_p->used) && (read_p->addr == addr)) {
+				read_p->used = true;
+				ModelSet(addr, read_p->value);
+				return read_p->value;
+			}
+		}
+	}
+	//Not recorded, use the last value seen
+	trace.stats.replayMisses++;
+	const ModelEntry_t* const entry_p = ModelFind(addr);
+	return ((NULL != entry_p) && entry_p->valid) ? entry_p->value : 0;
+}
+
+//Replay access functions
+static void ReplayDataCopy(void* dst, void* src, size_t n)
+{
+	(void)src;
+	memset(dst, 0, n);
+	pthread_mutex_lock(&trace.lock);
+	LogCopy(n, Now(), 0);
+	pthread_mutex_unlock(&trace.lock);
+}
+
+static void ReplayRegWrite(const uint32_t addr, const uint32_t value)
+{
+	pthread_mutex_lock(&trace.lock);
+	ModelSet(addr, value);
+	LogAccess(PsiMsDaq_TraceRec_Write, addr, value, Now(), 0);
+	pthread_mutex_unlock(&trace.lock);
+}
+
+static uint32_t ReplayRegRead(const uint32_t addr)
+{
+	pthread_mutex_lock(&trace.lock);
+	const uint32_t value = ReplayLookup(addr);
+	LogAccess(PsiMsDaq_TraceRec_Read, addr, value, Now(), 0);
+	pthread_mutex_unlock(&trace.lock);
+	return value;
+}
+
+static void ReplayRegReadBlock(const uint32_t addr, uint32_t* const values_p, const uint32_t count)
+{
+	pthread_mutex_lock(&trace.lock);
+	for (uint32_t i = 0; i < count; i++) {
+		values_p[i] = ReplayLookup(addr + 4*i);
+	}
+	LogBlock(addr, values_p, count, Now(), 0);
+	pthread_mutex_unlock(&trace.lock);
+}
+
+//Trace parsing for replay
+static bool RdVarint(const uint8_t* const data_p, const size_t size, size_t* const pos_p, uint64_t* const value_p)
+{
+	uint64_t value = 0;
+	for (uint32_t shift = 0; shift < 7*VARINT_MAX_BYTES; shift += 7) {
+		if (*pos_p >= size) {
+			return false;
+		}
+		const uint8_t b = data_p[(*pos_p)++];
+		value |= (uint64_t)(b & 0x7F) << shift;
+		if (0 == (b & 0x80)) {
+			*value_p = value;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool RdAddr(const uint8_t* const data_p, const size_t size, size_t* const pos_p, uint32_t* const addr_p)
+{
+	uint64_t zz;
+	if (!RdVarint(data_p, size, pos_p, &zz)) {
+		return false;
+	}
+	const int64_t diff = (int64_t)(zz >> 1) ^ -(int64_t)(zz & 1);
+	*addr_p = (uint32_t)((int64_t)*addr_p + diff);
+	return true;
+}
+
+static bool AddRead(const uint32_t addr, const uint32_t value, uint32_t* const cap_p)
+{
+	if (trace.readCnt == *cap_p) {
+		const uint32_t newCap = (0 == *cap_p) ? 1024 : 2*(*cap_p);
+		ReplayRead_t* reads = (ReplayRead_t*) realloc(trace.reads, newCap*sizeof(ReplayRead_t));
+		if (NULL == reads) {
+			return false;
+		}
+		trace.reads = reads;
+		*cap_p = newCap;
+	}
+	trace.reads[trace.readCnt++] = (ReplayRead_t){addr, value, false};
+	return true;
+}
+
+static bool AddSection(const uint32_t nameId, uint32_t* const cap_p)
+{
+	if (trace.sectionCnt > 0) {
+		trace.sections[trace.sectionCnt-1].end = trace.readCnt;
+	}
+	if (trace.sectionCnt == *cap_p) {
+		const uint32_t newCap = (0 == *cap_p) ? 256 : 2*(*cap_p);
+		ReplaySection_t* sections = (ReplaySection_t*) realloc(trace.sections, newCap*sizeof(ReplaySection_t));
+		if (NULL == sections) {
+			return false;
+		}
+		trace.sections = sections;
+		*cap_p = newCap;
+	}
+	trace.sections[trace.sectionCnt++] = (ReplaySection_t){nameId, trace.readCnt, trace.readCnt, trace.readCnt};
+	return true;
+}
+
+static bool ParseTrace(const uint8_t* const data_p, const size_t size)
+{
+	uint32_t readCap = 0;
+	uint32_t sectionCap = 0;
+	uint32_t addr = 0;
+	size_t pos = TRACE_MAGIC_LEN+1;
+	//Accesses before the first marker
+	if (!AddSection(0, &sectionCap)) {
+		return false;
+	}
+	while (pos < size) {
+		const uint8_t type = data_p[pos++];
+		uint64_t dt, value, count, duration;
+		if (!RdVarint(data_p, size, &pos, &dt)) {
+			return false;
+		}
+		switch (type) {
+			case PsiMsDaq_TraceRec_Read:
+			case PsiMsDaq_TraceRec_Write:
+				if ((!RdAddr(data_p, size, &pos, &addr)) || (!RdVarint(data_p, size, &pos, &value)) ||
+					(!RdVarint(data_p, size, &pos, &duration))) {
+					return false;
+				}
+				if ((PsiMsDaq_TraceRec_Read == type) && (!AddRead(addr, (uint32_t)value, &readCap))) {
+					return false;
+				}
+				break;
+			case PsiMsDaq_TraceRec_ReadBlock:
+				if ((!RdAddr(data_p, size, &pos, &addr)) || (!RdVarint(data_p, size, &pos, &count))) {
+					return false;
+				}
+				for (uint64_t i = 0; i < count; i++) {
+					if ((!RdVarint(data_p, size, &pos, &value)) || (!AddRead(addr + 4*(uint32_t)i, (uint32_t)value, &readCap))) {
+						return false;
+					}
+				}
+				if (!RdVarint(data_p, size, &pos, &duration)) {
+					return false;
+				}
+				break;
+			case PsiMsDaq_TraceRec_Copy:
+				if ((!RdVarint(data_p, size, &pos, &count)) || (!RdVarint(data_p, size, &pos, &duration))) {
+					return false;
+				}
+				break;
+			case PsiMsDaq_TraceRec_Name:
+				if ((!RdVarint(data_p, size, &pos, &value)) || (0 == value) || (value > PSI_MS_DAQ_TRACE_MAX_NAMES) ||
+					(pos >= size) || (pos + 1 + data_p[pos] > size) || (NULL != trace.recNames[value])) {
+					return false;
+				}
+				count = data_p[pos++];
+				trace.recNames[value] = (char*) malloc(count+1);
+				if (NULL == trace.recNames[value]) {
+					return false;
+				}
+				memcpy(trace.recNames[value], &data_p[pos], count);
+				trace.recNames[value][count] = 0;
+				pos += count;
+				break;
+			case PsiMsDaq_TraceRec_Mark:
+				if ((!RdVarint(data_p, size, &pos, &value)) || (value > PSI_MS_DAQ_TRACE_MAX_NAMES) ||
+					(!AddSection((uint32_t)value, &sectionCap))) {
+					return false;
+				}
+				break;
+			default:
+				return false;
+		}
+	}
+	trace.sections[trace.sectionCnt-1].end = trace.readCnt;
+	return true;
+}
+
+static void FreeReplay(void)
+{
+	free(trace.reads);
+	free(trace.sections);
+	free(trace.model);
+	for (int i = 0; i <= PSI_MS_DAQ_TRACE_MAX_NAMES; i++) {
+		free(trace.recNames[i]);
+		trace.recNames[i] = NULL;
+	}
+	trace.reads = NULL;
+	trace.sections = NULL;
+	trace.model = NULL;
+	trace.readCnt = 0;
+	trace.sectionCnt = 0;
+	trace.curSection = 0;
+}
+
+static uint8_t* LoadFile(const char* const path, size_t* const size_p)
+{
+	FILE* file_p = fopen(path, "rb");
+	if (NULL == file_p) {
+		return NULL;
+	}
+	uint8_t* data_p = NULL;
+	long size = -1;
+	if (0 == fseek(file_p, 0, SEEK_END)) {
+		size = ftell(file_p);
+	}
+	if ((size > TRACE_MAGIC_LEN) && (0 == fseek(file_p, 0, SEEK_SET))) {
+		data_p = (uint8_t*) malloc(size);
+		if ((NULL != data_p) && (fread(data_p, 1, size, file_p) != (size_t)size)) {
+			free(data_p);
+			data_p = NULL;
+		}
+	}
+	fclose(file_p);
+	if ((NULL != data_p) && (0 != memcmp(data_p, TRACE_MAGIC, TRACE_MAGIC_LEN))) {
+		free(data_p);
+		data_p = NULL;
+	}
+	*size_p = size;
+	return data_p;
+}
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+bool PsiMsDaq_Trace_StartRecord(	const char* const path,
+									const PsiMsDaq_AccessFct_t* const backend_p,
+									PsiMsDaq_RegReadBlock_f* backendBlk,
+									PsiMsDaq_AccessFct_t* const accessFct_p)
+{
+	//Checks
+	if (TraceMode_Idle != trace.mode) {
+		return false;
+	}
+	//Backend
+	if (NULL == backend_p) {
+		trace.backend = (PsiMsDaq_AccessFct_t){StdDataCopy, StdRegWrite, StdRegRead};
+		trace.backendBlk = StdRegReadBlock;
+	}
+	else {
+		trace.backend = *backend_p;
+		trace.backendBlk = backendBlk;
+	}
+	//Open trace
+	memset(&trace.stats, 0, sizeof(trace.stats));
+	trace.wr_p = WrOpen(path, (NULL != trace.backendBlk) ? PSI_MS_DAQ_TRACE_FLAG_BLOCK : 0);
+	if (NULL == trace.wr_p) {
+		return false;
+	}
+	//Access functions (address translation is not traced, it is set on the driver directly)
+	accessFct_p->dataCopy = RecDataCopy;
+	accessFct_p->regWrite = RecRegWrite;
+	accessFct_p->regRead = RecRegRead;
+	trace.blkFct = (NULL != trace.backendBlk) ? RecRegReadBlock : NULL;
+	trace.mode = TraceMode_Record;
+	return true;
+}
+
+bool PsiMsDaq_Trace_StartReplay(	const char* const tracePath,
+									const char* const outPath,
+									PsiMsDaq_AccessFct_t* const accessFct_p)
+{
+	//Checks
+	if (TraceMode_Idle != trace.mode) {
+		return false;
+	}
+	//Load recording
+	size_t size;
+	uint8_t* data_p = LoadFile(tracePath, &size);
+	if (NULL == data_p) {
+		return false;
+	}
+	const uint8_t flags = data_p[TRACE_MAGIC_LEN];
+	trace.model = (ModelEntry_t*) calloc(MODEL_SIZE, sizeof(ModelEntry_t));
+	const bool ok = (NULL != trace.model) && ParseTrace(data_p, size);
+	free(data_p);
+	if (!ok) {
+		FreeReplay();
+		return false;
+	}
+	//Open output trace
+	memset(&trace.stats, 0, sizeof(trace.stats));
+	trace.wr_p = NULL;
+	if (NULL != outPath) {
+		trace.wr_p = WrOpen(outPath, (flags & PSI_MS_DAQ_TRACE_FLAG_BLOCK) | PSI_MS_DAQ_TRACE_FLAG_REPLAY);
+		if (NULL == trace.wr_p) {
+			FreeReplay();
+			return false;
+		}
+	}
+	//Access functions
+	accessFct_p->dataCopy = ReplayDataCopy;
+	accessFct_p->regWrite = ReplayRegWrite;
+	accessFct_p->regRead = ReplayRegRead;
+	trace.blkFct = (0 != (flags & PSI_MS_DAQ_TRACE_FLAG_BLOCK)) ? ReplayRegReadBlock : NULL;
+	trace.mode = TraceMode_Replay;
+	return true;
+}
+
+PsiMsDaq_RegReadBlock_f* PsiMsDaq_Trace_GetRegReadBlock(void)
+{
+	return (TraceMode_Idle != trace.mode) ? trace.blkFct : NULL;
+}
+
+void PsiMsDaq_Trace_Mark(const char* const api)
+{
+	//Checks
+	if (TraceMode_Idle == trace.mode) {
+		return;
+	}
+	//Implementation
+	pthread_mutex_lock(&trace.lock);
+	LogMark(api, Now());
+	if (TraceMode_Replay == trace.mode) {
+		//Continue with the next section of the same name (stay in the current section if there is none)
+		uint32_t next = trace.curSection+1;
+		while ((next < trace.sectionCnt) && (!NamesEqual(trace.recNames[trace.sections[next].nameId], api))) {
+			next++;
+		}
+		if (next != trace.curSection+1) {
+			trace.stats.markMismatches++;
+		}
+		if (next < trace.sectionCnt) {
+			trace.curSection = next;
+		}
+	}
+	pthread_mutex_unlock(&trace.lock);
+}
+
+bool PsiMsDaq_Trace_Stop(PsiMsDaq_TraceStats_t* const stats_p)
+{
+	//Checks
+	if (TraceMode_Idle == trace.mode) {
+		return false;
+	}
+	//Implementation
+	pthread_mutex_lock(&trace.lock);
+	bool ok = true;
+	if (NULL != trace.wr_p) {
+		ok = WrClose(trace.wr_p);
+		trace.wr_p = NULL;
+	}
+	if (TraceMode_Replay == trace.mode) {
+		FreeReplay();
+	}
+	trace.mode = TraceMode_Idle;
+	if (NULL != stats_p) {
+		*stats_p = trace.stats;
+	}
+	pthread_mutex_unlock(&trace.lock);
+	//Done
+	return ok;
+}
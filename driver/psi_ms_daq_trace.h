@@ -0,0 +1,154 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*******************************************************************************
+// Documentation
+//*******************************************************************************
+/**
+* @file
+*
+* @brief Register access trace recording and replay
+*
+* Recording wraps the access functions of the driver (PsiMsDaq_AccessFct_t) and writes every register access
+* (address, value, read/write, time since the previous access and duration) and the size of every data copy into a
+* compact binary trace file. This is cheap enough to be used in production: the file is written by a separate thread,
+* so register accesses do not wait for file I/O.
+*
+* Replay provides access functions that feed the recorded read values back to a driver running offline (e.g. a new
+* driver version built on a PC). The accesses of the replayed driver can be written into a trace again, so both runs
+* of the same workload can be compared with scripts/trace_diff.py (access count, read/write mix and cost per API).
+* Data copies return zeros during replay, since only register accesses are recorded.
+*
+* Accesses are attributed to the API call of the application that caused them by markers:
+* PsiMsDaq_Trace_Mark() starts a section and all accesses until the next marker belong to it. The application calls
+* it with the same names when recording and replaying:
+* @code
+* PsiMsDaq_Trace_Mark("HandleIrq");
+* PsiMsDaq_HandleIrq(ipHandle);
+* @endcode
+* During replay, read values are looked up in the section of the current marker, so a driver version with a different
+* access order still gets the recorded values. Reads of addresses not recorded in the section return the value last
+* read from or written to that address (replay miss). Markers that do not match the recording are skipped to the next
+* section with the same name (marker mismatch).
+*
+* Only one trace can be active per process (the access functions do not have a context argument). All functions are
+* thread safe.
+*
+* File format (all numbers are unsigned LEB128 varints unless noted):
+* - Header: "PMDTRC01" (8 bytes), flags (1 byte, see PSI_MS_DAQ_TRACE_FLAG_xxx)
+* - Records: Type (1 byte, see PsiMsDaq_TraceRec_t), time since the previous record in ns, fields:
+*   - Read / Write: address (zigzag coded difference to the previous address), value, duration in ns
+*   - ReadBlock: address (as above), count, count values, duration in ns
+*   - Copy: bytes, duration in ns
+*   - Name: marker id, length (1 byte), name (without termination)
+*   - Mark: marker id (0 = no name)
+*/
+
+//*******************************************************************************
+// Includes
+//*******************************************************************************
+#include "psi_ms_daq.h"
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define PSI_MS_DAQ_TRACE_MAX_NAMES			64		///< Maximum number of marker names (further names are recorded as unnamed)
+#define PSI_MS_DAQ_TRACE_FLAG_BLOCK			0x01	///< Flag: Block reads were available to the driver
+#define PSI_MS_DAQ_TRACE_FLAG_REPLAY		0x02	///< Flag: Trace written during replay (durations are zero)
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+/**
+ * @brief	Record types of the trace file
+ */
+typedef enum {
+	PsiMsDaq_TraceRec_Read		= 1,	///< Register read
+	PsiMsDaq_TraceRec_Write		= 2,	///< Register write
+	PsiMsDaq_TraceRec_ReadBlock	= 3,	///< Block read
+	PsiMsDaq_TraceRec_Copy		= 4,	///< Data copy
+	PsiMsDaq_TraceRec_Name		= 5,	///< Definition of a marker name
+	PsiMsDaq_TraceRec_Mark		= 6		///< Marker
+} PsiMsDaq_TraceRec_t;
+
+/**
+ * @brief	Statistics of a trace
+ */
+typedef struct {
+	uint64_t reads;				///< Number of register reads (including registers read in blocks)
+	uint64_t writes;			///< Number of register writes
+	uint64_t blockReads;		///< Number of block reads
+	uint64_t copyBytes;			///< Number of bytes copied
+	uint64_t marks;				///< Number of markers
+	uint64_t fileBytes;			///< Size of the trace written
+	uint64_t replayMisses;		///< Number of reads not found in the recording (replay only)
+	uint64_t markMismatches;	///< Number of markers not matching the recording (replay only)
+} PsiMsDaq_TraceStats_t;
+
+//*******************************************************************************
+// Functions
+//*******************************************************************************
+
+/**
+ * @brief	Start recording and fill an access function struct for PsiMsDaq_Init(). If block reads are recorded, pass
+ * 			PsiMsDaq_Trace_GetRegReadBlock() to PsiMsDaq_SetRegReadBlock() after PsiMsDaq_Init().
+ *
+ * @param	path			Path of the trace file to write
+ * @param	backend_p		Access functions to record (NULL for the standard access functions)
+ * @param	backendBlk		Block read function to record (NULL if not available, ignored if backend_p is NULL because the
+ * 							standard block read function is used then)
+ * @param	accessFct_p		Pointer to write the recording access functions into
+ * @return	true if the recording was started
+ */
+bool PsiMsDaq_Trace_StartRecord(	const char* const path,
+									const PsiMsDaq_AccessFct_t* const backend_p,
+									PsiMsDaq_RegReadBlock_f* backendBlk,
+									PsiMsDaq_AccessFct_t* const accessFct_p);
+
+/**
+ * @brief	Start replaying a trace and fill an access function struct for PsiMsDaq_Init(). Block reads are only
+ * 			provided if they were available during recording (see PsiMsDaq_Trace_GetRegReadBlock()).
+ *
+ * @param	tracePath		Path of the trace file to replay
+ * @param	outPath			Path of the trace file to write the accesses of the replayed driver into (NULL if not required)
+ * @param	accessFct_p		Pointer to write the replay access functions into
+ * @return	true if the replay was started
+ */
+bool PsiMsDaq_Trace_StartReplay(	const char* const tracePath,
+									const char* const outPath,
+									PsiMsDaq_AccessFct_t* const accessFct_p);
+
+/**
+ * @brief	Get the block read function of the active recording or replay, to be passed to PsiMsDaq_SetRegReadBlock()
+ *
+ * @return	Block read function (NULL if no trace is active or block reads are not available)
+ */
+PsiMsDaq_RegReadBlock_f* PsiMsDaq_Trace_GetRegReadBlock(void);
+
+/**
+ * @brief	Start a new section of the trace (does nothing if no trace is active)
+ *
+ * @param	api		Name of the API call the following accesses belong to (NULL for accesses not belonging to any API call)
+ */
+void PsiMsDaq_Trace_Mark(const char* const api);
+
+/**
+ * @brief	Stop recording or replaying and close all files. The access functions must not be used anymore afterwards.
+ *
+ * @param	stats_p		Pointer to write the statistics into (NULL if not required)
+ * @return	true if the trace was written completely
+ */
+bool PsiMsDaq_Trace_Stop(PsiMsDaq_TraceStats_t* const stats_p);
+
+#ifdef __cplusplus
+}
+#endif
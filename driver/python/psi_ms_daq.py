@@ -0,0 +1,193 @@
+##############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+##############################################################################
+
+##############################################################################
+# Zero-copy NumPy access to recorded windows
+#
+# Thin ctypes binding on top of the C driver compiled as shared library, e.g.:
+#   gcc -shared -fPIC -O2 -o libpsi_ms_daq.so psi_ms_daq.c <your access functions> -lm
+#
+# Window data is exposed as ndarray views directly on the DMA memory (see PsiMsDaq_AddrToPtr(), so on Linux an
+# address translation function must be passed to PsiMsDaq_Init()). Every view holds a reference on the window
+# (PsiMsDaq_StrWin_Retain()), so the window is only freed after Window.free() was called and all views are gone.
+#
+# Usage:
+#   lib = psi_ms_daq.load("./libpsi_ms_daq.so")
+#   str = psi_ms_daq.Stream(lib, strHandle, numpy.int16)
+#   def on_window(win):
+#       with win:
+#           spans = win.spans(1000, 100)    # one or two views, no copy
+#           ts = win.timestamp
+#   str.set_window_callback(on_window)
+##############################################################################
+
+import ctypes
+import weakref
+import numpy as np
+
+##############################################################################
+# C Types
+##############################################################################
+class WinInfo(ctypes.Structure):
+	_fields_ = [("winNr", ctypes.c_uint8),
+				("ipHandle", ctypes.c_void_p),
+				("strHandle", ctypes.c_void_p)]
+
+WinIrq_f = ctypes.CFUNCTYPE(None, WinInfo, ctypes.c_void_p)
+
+class DaqError(Exception):
+	def __init__(self, fct, code):
+		Exception.__init__(self, "{} failed with return code {}".format(fct, code))
+		self.code = code
+
+##############################################################################
+# Library
+##############################################################################
+def load(path = "libpsi_ms_daq.so"):
+	"""
+	Load the driver library and declare the function prototypes used by this module
+	"""
+	lib = ctypes.CDLL(path)
+	u32_p = ctypes.POINTER(ctypes.c_uint32)
+	protos = {"PsiMsDaq_StrWin_GetDataRange" : [WinInfo, ctypes.c_uint32, ctypes.c_uint32, u32_p, u32_p],
+			  "PsiMsDaq_StrWin_GetDataUnwrapped" : [WinInfo, ctypes.c_uint32, ctypes.c_uint32, ctypes.c_void_p, ctypes.c_size_t],
+			  "PsiMsDaq_StrWin_GetTimestamp" : [WinInfo, ctypes.POINTER(ctypes.c_uint64)],
+			  "PsiMsDaq_StrWin_GetPreTrigSamples" : [WinInfo, u32_p],
+			  "PsiMsDaq_StrWin_GetNoOfSamples" : [WinInfo, u32_p],
+			  "PsiMsDaq_StrWin_Retain" : [WinInfo],
+			  "PsiMsDaq_StrWin_Release" : [WinInfo],
+			  "PsiMsDaq_Str_GetBufferLayout" : [ctypes.c_void_p, u32_p, u32_p],
+			  "PsiMsDaq_Str_SetIrqCallbackWin" : [ctypes.c_void_p, WinIrq_f, ctypes.c_void_p]}
+	for name, args in protos.items():
+		fct = getattr(lib, name)
+		fct.argtypes = args
+		fct.restype = ctypes.c_int
+	lib.PsiMsDaq_AddrToPtr.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+	lib.PsiMsDaq_AddrToPtr.restype = ctypes.c_void_p
+	return lib
+
+def _call(lib, name, *args):
+	r = getattr(lib, name)(*args)
+	if r != 0:
+		raise DaqError(name, r)
+
+##############################################################################
+# Window
+##############################################################################
+class Window:
+	"""
+	A recorded window. The window is retained until free() is called (or the with-block is left or the Window object
+	is garbage collected) and all views returned by spans() and array() are garbage collected.
+	"""
+	def __init__(self, lib, info, dtype):
+		self._lib = lib
+		self._info = WinInfo(info.winNr, info.ipHandle, info.strHandle)
+		self._dtype = np.dtype(dtype)
+		_call(lib, "PsiMsDaq_StrWin_Retain", self._info)
+		#Release the reference of the constructor also if the Window is dropped without calling free()
+		self._finalizer = weakref.finalize(self, lib.PsiMsDaq_StrWin_Release, WinInfo(info.winNr, info.ipHandle, info.strHandle))
+
+	def __enter__(self):
+		return self
+
+	def __exit__(self, *args):
+		self.free()
+
+	def free(self):
+		if self._finalizer.alive:
+			r = self._finalizer()
+			if r != 0:
+				raise DaqError("PsiMsDaq_StrWin_Release", r)
+
+	@property
+	def number(self):
+		return self._info.winNr
+
+	@property
+	def timestamp(self):
+		ts = ctypes.c_uint64()
+		_call(self._lib, "PsiMsDaq_StrWin_GetTimestamp", self._info, ctypes.byref(ts))
+		return ts.value
+
+	@property
+	def pre_trig_samples(self):
+		spl = ctypes.c_uint32()
+		_call(self._lib, "PsiMsDaq_StrWin_GetPreTrigSamples", self._info, ctypes.byref(spl))
+		return spl.value
+
+	@property
+	def samples(self):
+		spl = ctypes.c_uint32()
+		_call(self._lib, "PsiMsDaq_StrWin_GetNoOfSamples", self._info, ctypes.byref(spl))
+		return spl.value
+
+	def _view(self, addr, bytes):
+		"""
+		Create an ndarray view on IP memory that holds its own reference on the window
+		"""
+		if not self._finalizer.alive:
+			raise RuntimeError("Window already freed")
+		ptr = self._lib.PsiMsDaq_AddrToPtr(self._info.ipHandle, addr)
+		buf = (ctypes.c_uint8 * bytes).from_address(ptr)
+		_call(self._lib, "PsiMsDaq_StrWin_Retain", self._info)
+		weakref.finalize(buf, self._lib.PsiMsDaq_StrWin_Release, WinInfo(self._info.winNr, self._info.ipHandle, self._info.strHandle))
+		arr = np.frombuffer(buf, dtype = self._dtype)
+		arr.flags.writeable = False
+		return arr
+
+	def _range(self, preTrigSamples, postTrigSamples):
+		"""
+		Get address and size of the data and the bounds of the window
+		"""
+		first = ctypes.c_uint32()
+		bytes = ctypes.c_uint32()
+		_call(self._lib, "PsiMsDaq_StrWin_GetDataRange", self._info, preTrigSamples, postTrigSamples, ctypes.byref(first), ctypes.byref(bytes))
+		bufStart = ctypes.c_uint32()
+		winSize = ctypes.c_uint32()
+		_call(self._lib, "PsiMsDaq_Str_GetBufferLayout", self._info.strHandle, ctypes.byref(bufStart), ctypes.byref(winSize))
+		winStart = bufStart.value + winSize.value * self._info.winNr
+		return first.value, bytes.value, winStart, winStart + winSize.value
+
+	def spans(self, preTrigSamples, postTrigSamples):
+		"""
+		Return the data as list of one (not wrapped) or two (wrapped) read-only views, in time order
+		"""
+		first, bytes, winStart, winEnd = self._range(preTrigSamples, postTrigSamples)
+		if first + bytes <= winEnd:
+			return [self._view(first, bytes)]
+		firstBytes = winEnd - first
+		return [self._view(first, firstBytes), self._view(winStart, bytes - firstBytes)]
+
+	def array(self, preTrigSamples, postTrigSamples):
+		"""
+		Return the data as one contiguous array. This is a view if the data is not wrapped and a copy otherwise.
+		"""
+		first, bytes, winStart, winEnd = self._range(preTrigSamples, postTrigSamples)
+		if first + bytes <= winEnd:
+			return self._view(first, bytes)
+		out = np.empty(bytes // self._dtype.itemsize, dtype = self._dtype)
+		_call(self._lib, "PsiMsDaq_StrWin_GetDataUnwrapped", self._info, preTrigSamples, postTrigSamples,
+			  out.ctypes.data_as(ctypes.c_void_p), out.nbytes)
+		return out
+
+##############################################################################
+# Stream
+##############################################################################
+class Stream:
+	"""
+	Delivers the windows of a stream (window based IRQ scheme) as Window objects
+	"""
+	def __init__(self, lib, strHandle, dtype):
+		self._lib = lib
+		self._strHandle = strHandle
+		self._dtype = dtype
+		self._cb = None
+
+	def set_window_callback(self, fct):
+		def irq(info, arg):
+			fct(Window(self._lib, info, self._dtype))
+		self._cb = WinIrq_f(irq)
+		_call(self._lib, "PsiMsDaq_Str_SetIrqCallbackWin", self._strHandle, self._cb, None)
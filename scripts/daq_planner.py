@@ -0,0 +1,205 @@
+##############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+##############################################################################
+
+##############################################################################
+# Offline throughput and buffer planner for psi_ms_daq
+#
+# The planner simulates the data path of the IP for a given configuration:
+# - Input FIFOs (StreamBuffer_g words of IntDataWidth_g bits) filled at the stream data rate
+# - The three level priority arbitration of psi_ms_daq_daq_sm (strict priority between levels,
+#   round-robin within a level, only streams with at least MinBurstSize_g words are arbitrated)
+# - DMA bursts of up to MaxBurstSize_g words, split at 4k boundaries and window ends, with a fixed
+#   state machine overhead per burst
+# - Partial bursts at the end of each triggered window (frame end flush)
+#
+# The trigger rate headroom of a stream is the factor by which its trigger rate can be increased until
+# - any stream overflows in the simulation, or
+# - triggers fall into the post-trigger phase of the previous window (they are ignored by the IP), or
+# - software cannot keep up with freeing windows (only if "swWinTime" [s per window] is given)
+#
+# Usage:
+#   python daq_planner.py <config.json>
+#
+# Example configuration:
+# {
+#   "ip":      {"MinBurstSize_g": 512, "MaxBurstSize_g": 512, "AxiDataWidth_g": 64, "IntDataWidth_g": 64,
+#               "ClkFreq": 200e6, "AxiEfficiency": 0.8, "BufStartAddr": "0x10000000", "SimTime": 0.01},
+#   "streams": [{"width": 16, "sampleRate": 100e6, "triggerRate": 1e3, "prio": 1, "buffer": 1024,
+#                "preTrig": 1000, "postTrig": 1000, "windows": 8, "ringbuf": true, "swWinTime": 50e-6}]
+# }
+##############################################################################
+
+import json
+import math
+import sys
+
+#Constants
+SM_CYCLES_PER_BURST = 30	#State machine cycles per burst (command and response handling)
+BOUNDARY_4K = 4096
+DEFAULTS_IP = {"MinBurstSize_g" : 512, "MaxBurstSize_g" : 512, "AxiDataWidth_g" : 64, "IntDataWidth_g" : 64,
+			   "ClkFreq" : 200e6, "AxiEfficiency" : 0.8, "BufStartAddr" : "0x10000000", "SimTime" : 0.01}
+DEFAULTS_STR = {"triggerRate" : 0.0, "prio" : 1, "buffer" : 1024, "preTrig" : 0, "postTrig" : 1, "windows" : 2,
+				"ringbuf" : True, "overwrite" : False, "recMode" : "PsiMsDaqn_RecMode_Continuous", "swWinTime" : 0.0}
+
+##############################################################################
+# Helpers
+##############################################################################
+def AlignUp(value, alignment):
+	return (value + alignment - 1) // alignment * alignment
+
+def WinSizeBytes(str):
+	#Windows must be a multiple of 8 bytes and of the sample size (e.g. 24 bit streams)
+	sampleBytes = str["width"] // 8
+	alignment = 8 * sampleBytes // math.gcd(8, sampleBytes)
+	return AlignUp((str["preTrig"] + str["postTrig"]) * sampleBytes, alignment)
+
+##############################################################################
+# Simulation
+##############################################################################
+def Simulate(ip, streams, trigScale = None):
+	"""
+	Run the data path simulation. Returns per stream maximum FIFO occupancy (words) and whether it overflowed.
+	trigScale optionally scales the trigger rate of one stream: (streamIndex, factor)
+	"""
+	intBytes = ip["IntDataWidth_g"] // 8
+	bytesPerSec = min(ip["AxiDataWidth_g"], ip["IntDataWidth_g"]) / 8 * ip["ClkFreq"] * ip["AxiEfficiency"]
+	overheadSec = SM_CYCLES_PER_BURST / ip["ClkFreq"]
+	n = len(streams)
+	level = [0.0] * n
+	maxLevel = [0.0] * n
+	overflow = [False] * n
+	ptr = [0] * n				#Byte offset within the window (for 4k and window end splitting)
+	toTrigger = [0.0] * n		#Bytes until the next frame end
+	frameBytes = [0.0] * n
+	rrNext = {1 : 0, 2 : 0, 3 : 0}
+	for i, str in enumerate(streams):
+		rate = str["triggerRate"] * (trigScale[1] if (trigScale is not None and trigScale[0] == i) else 1.0)
+		bytesPerSec_i = str["sampleRate"] * str["width"] / 8
+		frameBytes[i] = bytesPerSec_i / rate if rate > 0 else float("inf")
+		toTrigger[i] = frameBytes[i]
+	fillRate = [s["sampleRate"] * s["width"] / 8 / intBytes for s in streams]	#words per second
+	t = 0.0
+	while t < ip["SimTime"]:
+		#Arbitration: strict priority, round robin within a priority level
+		sel = None
+		for prio in (1, 2, 3):
+			cands = [i for i in range(n) if streams[i]["prio"] == prio and level[i] >= ip["MinBurstSize_g"]]
+			if cands:
+				cands.sort(key = lambda i: (i - rrNext[prio]) % n)
+				sel = cands[0]
+				rrNext[prio] = sel + 1
+				break
+		#Frame ends are flushed when no full burst is available
+		if sel is None:
+			ends = [i for i in range(n) if toTrigger[i] <= level[i] * intBytes and level[i] > 0]
+			if ends:
+				sel = ends[0]
+		if sel is None:
+			dt = overheadSec
+			words = 0
+		else:
+			str = streams[sel]
+			winSize = WinSizeBytes(str)
+			maxBytes = min(ip["MaxBurstSize_g"] * ip["AxiDataWidth_g"] // 8, BOUNDARY_4K - (ptr[sel] % BOUNDARY_4K), winSize - ptr[sel], int(level[sel]) * intBytes)
+			maxBytes = min(maxBytes, max(int(toTrigger[sel]), intBytes))
+			words = max(maxBytes // intBytes, 1)
+			dt = overheadSec + words * intBytes / bytesPerSec
+		#Advance time
+		for i in range(n):
+			level[i] += fillRate[i] * dt
+			if level[i] > streams[i]["buffer"]:
+				overflow[i] = True
+				level[i] = streams[i]["buffer"]
+			maxLevel[i] = max(maxLevel[i], level[i])
+		if sel is not None:
+			level[sel] = max(level[sel] - words, 0.0)
+			bytes = words * intBytes
+			ptr[sel] = (ptr[sel] + bytes) % WinSizeBytes(streams[sel])
+			toTrigger[sel] -= bytes
+			if toTrigger[sel] <= 0:
+				toTrigger[sel] = frameBytes[sel]
+				ptr[sel] = 0
+		t += dt
+	return maxLevel, overflow
+
+def TriggerHeadroom(ip, streams, idx):
+	"""
+	Factor by which the trigger rate of a stream can be increased (see header for limiting factors)
+	"""
+	str = streams[idx]
+	if str["triggerRate"] <= 0:
+		return None
+	limit = str["sampleRate"] / str["postTrig"] / str["triggerRate"]
+	if str["swWinTime"] > 0:
+		limit = min(limit, 1 / str["swWinTime"] / str["triggerRate"])
+	_, ovf = Simulate(ip, streams, (idx, limit))
+	if not any(ovf):
+		return limit
+	_, ovf = Simulate(ip, streams)
+	if any(ovf):
+		return 0.0
+	lo, hi = 1.0, limit
+	for _ in range(8):
+		mid = (lo + hi) / 2
+		_, ovf = Simulate(ip, streams, (idx, mid))
+		if any(ovf):
+			hi = mid
+		else:
+			lo = mid
+	return lo
+
+##############################################################################
+# Output
+##############################################################################
+def EmitConfigs(ip, streams):
+	addr = int(str(ip["BufStartAddr"]), 0)
+	lines = []
+	for i, s in enumerate(streams):
+		winSize = WinSizeBytes(s)
+		lines.append("PsiMsDaq_StrConfig_t cfgStr{} = {{".format(i))
+		lines.append("\t.postTrigSamples = {},".format(s["postTrig"]))
+		lines.append("\t.recMode = {},".format(s["recMode"]))
+		lines.append("\t.winAsRingbuf = {},".format("true" if s["ringbuf"] else "false"))
+		lines.append("\t.winOverwrite = {},".format("true" if s["overwrite"] else "false"))
+		lines.append("\t.winCnt = {},".format(s["windows"]))
+		lines.append("\t.bufStartAddr = 0x{:08X},".format(addr))
+		lines.append("\t.winSize = {},".format(winSize))
+		lines.append("\t.streamWidthBits = {}".format(s["width"]))
+		lines.append("};")
+		addr = AlignUp(addr + winSize * s["windows"], BOUNDARY_4K)
+	return "\n".join(lines)
+
+def Main(cfgFile):
+	with open(cfgFile) as f:
+		cfg = json.load(f)
+	ip = dict(DEFAULTS_IP, **cfg.get("ip", {}))
+	streams = [dict(DEFAULTS_STR, **s) for s in cfg["streams"]]
+
+	#Bandwidth summary
+	bwAvail = min(ip["AxiDataWidth_g"], ip["IntDataWidth_g"]) / 8 * ip["ClkFreq"] * ip["AxiEfficiency"]
+	bwReq = sum(s["sampleRate"] * s["width"] / 8 for s in streams)
+	print("Memory bandwidth: required {:.1f} MB/s, available {:.1f} MB/s ({:.1f}% load)".format(bwReq / 1e6, bwAvail / 1e6, 100 * bwReq / bwAvail))
+
+	#Per stream report
+	maxLevel, overflow = Simulate(ip, streams)
+	print("")
+	print("{:>6} {:>5} {:>10} {:>10} {:>10} {:>10} {:>12}".format("Stream", "Prio", "Buffer", "MaxLevel", "Margin", "Overflow", "TrigHeadroom"))
+	for i, s in enumerate(streams):
+		headroom = TriggerHeadroom(ip, streams, i)
+		print("{:>6} {:>5} {:>10} {:>10.0f} {:>10.0f} {:>10} {:>12}".format(
+			i, s["prio"], s["buffer"], maxLevel[i], s["buffer"] - maxLevel[i], "YES" if overflow[i] else "no",
+			"-" if headroom is None else "{:.1f}x".format(headroom)))
+
+	#Configuration
+	print("")
+	print(EmitConfigs(ip, streams))
+	return 1 if any(overflow) else 0
+
+if __name__ == "__main__":
+	if len(sys.argv) != 2:
+		print("Usage: python daq_planner.py <config.json>")
+		exit(-1)
+	exit(Main(sys.argv[1]))
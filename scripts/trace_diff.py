@@ -0,0 +1,207 @@
+##############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+##############################################################################
+
+##############################################################################
+# Register access trace comparison for psi_ms_daq
+#
+# Compares two traces of the same workload written by driver/psi_ms_daq_trace.c, usually a recording of the
+# current driver and a replay of a new driver version (see PsiMsDaq_Trace_StartReplay()). The report contains
+# - Total access count and read/write mix
+# - Per API (marker name): number of calls and accesses per call
+# - Estimated MMIO time per call
+#
+# Replayed traces do not contain access durations. The MMIO time of both traces is therefore estimated with a
+# cost model (average duration of a read, a write, a register in a block read and a copied byte) taken from the
+# first trace that was recorded on hardware. So differences in the estimated time are caused by the accesses only.
+#
+# Usage:
+#   python trace_diff.py <traceA> <traceB>
+##############################################################################
+
+import sys
+
+#Constants
+MAGIC = b"PMDTRC01"
+FLAG_BLOCK = 0x01
+FLAG_REPLAY = 0x02
+REC_READ, REC_WRITE, REC_BLOCK, REC_COPY, REC_NAME, REC_MARK = 1, 2, 3, 4, 5, 6
+NO_API = "(none)"
+
+##############################################################################
+# Parsing
+##############################################################################
+class ApiStats:
+	def __init__(self):
+		self.calls = 0
+		self.reads = 0
+		self.writes = 0
+		self.blockReads = 0
+		self.blockRegs = 0
+		self.copyBytes = 0
+		self.readNs = 0
+		self.writeNs = 0
+		self.blockNs = 0
+		self.copyNs = 0
+
+	def Add(self, other):
+		for k, v in vars(other).items():
+			setattr(self, k, getattr(self, k) + v)
+
+	def Accesses(self):
+		return self.reads + self.writes + self.blockReads
+
+	def EstNs(self, cost):
+		return self.reads * cost["read"] + self.writes * cost["write"] + self.blockRegs * cost["blockReg"] + self.copyBytes * cost["copyByte"]
+
+class Trace:
+	def __init__(self, path):
+		with open(path, "rb") as f:
+			data = f.read()
+		if data[:len(MAGIC)] != MAGIC:
+			raise Exception("{} is not a psi_ms_daq trace".format(path))
+		self.path = path
+		self.flags = data[len(MAGIC)]
+		self.apis = {NO_API : ApiStats()}
+		self.truncated = False
+		self.pos = len(MAGIC) + 1
+		self.data = data
+		names = {0 : NO_API}
+		cur = self.apis[NO_API]
+		try:
+			while self.pos < len(data):
+				recType = self.Byte()
+				self.Varint()	#Time since previous record
+				if recType in (REC_READ, REC_WRITE):
+					self.Varint()
+					self.Varint()
+					ns = self.Varint()
+					if recType == REC_READ:
+						cur.reads += 1
+						cur.readNs += ns
+					else:
+						cur.writes += 1
+						cur.writeNs += ns
+				elif recType == REC_BLOCK:
+					self.Varint()
+					count = self.Varint()
+					for i in range(count):
+						self.Varint()
+					cur.blockReads += 1
+					cur.blockRegs += count
+					cur.blockNs += self.Varint()
+				elif recType == REC_COPY:
+					cur.copyBytes += self.Varint()
+					cur.copyNs += self.Varint()
+				elif recType == REC_NAME:
+					id = self.Varint()
+					length = self.Byte()
+					names[id] = data[self.pos:self.pos + length].decode("utf-8", "replace")
+					self.pos += length
+				elif recType == REC_MARK:
+					name = names.get(self.Varint(), NO_API)
+					cur = self.apis.setdefault(name, ApiStats())
+					cur.calls += 1
+				else:
+					raise IndexError()
+		except IndexError:
+			self.truncated = True
+		del self.data
+
+	def Byte(self):
+		b = self.data[self.pos]
+		self.pos += 1
+		return b
+
+	def Varint(self):
+		value = 0
+		shift = 0
+		while True:
+			b = self.Byte()
+			value |= (b & 0x7F) << shift
+			shift += 7
+			if not (b & 0x80):
+				return value
+
+	def IsReplay(self):
+		return (self.flags & FLAG_REPLAY) != 0
+
+	def Total(self):
+		total = ApiStats()
+		for s in self.apis.values():
+			total.Add(s)
+		return total
+
+##############################################################################
+# Report
+##############################################################################
+def CostModel(traces):
+	for t in traces:
+		if not t.IsReplay():
+			s = t.Total()
+			return {"read" : s.readNs / s.reads if s.reads else 0.0,
+					"write" : s.writeNs / s.writes if s.writes else 0.0,
+					"blockReg" : s.blockNs / s.blockRegs if s.blockRegs else (s.readNs / s.reads if s.reads else 0.0),
+					"copyByte" : s.copyNs / s.copyBytes if s.copyBytes else 0.0}, t
+	return None, None
+
+def Delta(a, b):
+	if a == 0:
+		return "-" if b == 0 else "new"
+	return "{:+.1f}%".format(100.0 * (b - a) / a)
+
+def Main(pathA, pathB):
+	a = Trace(pathA)
+	b = Trace(pathB)
+	for t in (a, b):
+		print("{}: {}{}{}".format("A" if t is a else "B", t.path, " (replay)" if t.IsReplay() else " (recorded)",
+			", TRUNCATED" if t.truncated else ""))
+	cost, costSrc = CostModel((a, b))
+	if cost is None:
+		print("No recorded trace, MMIO time is not estimated")
+		cost = {"read" : 0.0, "write" : 0.0, "blockReg" : 0.0, "copyByte" : 0.0}
+	else:
+		print("Cost model from {}: read {:.0f} ns, write {:.0f} ns, block read {:.0f} ns/register, copy {:.2f} ns/byte".format(
+			costSrc.path, cost["read"], cost["write"], cost["blockReg"], cost["copyByte"]))
+
+	#Totals
+	ta, tb = a.Total(), b.Total()
+	print("")
+	print("{:<24} {:>12} {:>12} {:>10}".format("Total", "A", "B", "Delta"))
+	rows = [("Accesses", ta.Accesses(), tb.Accesses()),
+			("Reads (registers)", ta.reads + ta.blockRegs, tb.reads + tb.blockRegs),
+			("  Single reads", ta.reads, tb.reads),
+			("  Block reads", ta.blockReads, tb.blockReads),
+			("Writes", ta.writes, tb.writes),
+			("Bytes copied", ta.copyBytes, tb.copyBytes),
+			("Est. MMIO time [us]", ta.EstNs(cost) / 1e3, tb.EstNs(cost) / 1e3)]
+	for name, va, vb in rows:
+		print("{:<24} {:>12.6g} {:>12.6g} {:>10}".format(name, va, vb, Delta(va, vb)))
+	for t, s in ((a, ta), (b, tb)):
+		regs = s.reads + s.blockRegs + s.writes
+		print("Read/write mix {}: {:.1f}% / {:.1f}%".format("A" if t is a else "B", 100.0 * (s.reads + s.blockRegs) / regs if regs else 0.0,
+			100.0 * s.writes / regs if regs else 0.0))
+
+	#Per API
+	print("")
+	print("{:<24} {:>7} {:>7} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}".format(
+		"API (per call)", "Calls A", "Calls B", "Access A", "Access B", "Delta", "Est.ns A", "Est.ns B", "Delta"))
+	for name in sorted(set(a.apis) | set(b.apis), key = lambda n: -a.apis.get(n, ApiStats()).EstNs(cost)):
+		sa = a.apis.get(name, ApiStats())
+		sb = b.apis.get(name, ApiStats())
+		if sa.Accesses() + sb.Accesses() + sa.calls + sb.calls == 0:
+			continue
+		perCall = lambda s, v: v / max(s.calls, 1)
+		accA, accB = perCall(sa, sa.Accesses()), perCall(sb, sb.Accesses())
+		nsA, nsB = perCall(sa, sa.EstNs(cost)), perCall(sb, sb.EstNs(cost))
+		print("{:<24} {:>7} {:>7} {:>10.1f} {:>10.1f} {:>10} {:>10.0f} {:>10.0f} {:>10}".format(
+			name[:24], sa.calls, sb.calls, accA, accB, Delta(accA, accB), nsA, nsB, Delta(nsA, nsB)))
+	return 0
+
+if __name__ == "__main__":
+	if len(sys.argv) != 3:
+		print("Usage: python trace_diff.py <traceA> <traceB>")
+		exit(-1)
+	exit(Main(sys.argv[1], sys.argv[2]))
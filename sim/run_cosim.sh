@@ -0,0 +1,79 @@
+#!/bin/bash
+##############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+##############################################################################
+
+# Co-simulation of the C driver against psi_ms_daq_axi (GHDL, Linux only)
+# Usage: ./run_cosim.sh [windows per stream] [trigger period]
+# Must be called from the sim directory (same library layout as config.tcl)
+
+set -e
+
+LibPath="../../../VHDL"
+Windows=${1:-100}
+TrigPeriod=${2:-1000}
+WorkDir="cosim_work"
+GhdlFlags="--std=08 -frelaxed --workdir=$WorkDir --work=psi_ms_daq"
+
+mkdir -p $WorkDir
+
+# Library
+for f in \
+	psi_common/hdl/psi_common_array_pkg.vhd \
+	psi_common/hdl/psi_common_math_pkg.vhd \
+	psi_common/hdl/psi_common_logic_pkg.vhd \
+	psi_common/hdl/psi_common_sdp_ram.vhd \
+	psi_common/hdl/psi_common_pulse_cc.vhd \
+	psi_common/hdl/psi_common_bit_cc.vhd \
+	psi_common/hdl/psi_common_simple_cc.vhd \
+	psi_common/hdl/psi_common_status_cc.vhd \
+	psi_common/hdl/psi_common_async_fifo.vhd \
+	psi_common/hdl/psi_common_arb_priority.vhd \
+	psi_common/hdl/psi_common_sync_fifo.vhd \
+	psi_common/hdl/psi_common_tdp_ram.vhd \
+	psi_common/hdl/psi_common_axi_master_simple.vhd \
+	psi_common/hdl/psi_common_wconv_n2xn.vhd \
+	psi_common/hdl/psi_common_axi_master_full.vhd \
+	psi_common/hdl/psi_common_pl_stage.vhd \
+	psi_common/hdl/psi_common_axi_slave_ipif.vhd
+do
+	ghdl -a $GhdlFlags $LibPath/$f
+done
+
+# project sources
+for f in \
+	psi_ms_daq_pkg.vhd \
+	psi_ms_daq_input.vhd \
+	psi_ms_daq_daq_sm.vhd \
+	psi_ms_daq_daq_dma.vhd \
+	psi_ms_daq_axi_if.vhd \
+	psi_ms_daq_reg_axi.vhd \
+	psi_ms_daq_axi.vhd
+do
+	ghdl -a $GhdlFlags ../hdl/$f
+done
+
+# testbench
+ghdl -a $GhdlFlags ../tb/psi_ms_daq_cosim/psi_ms_daq_cosim_pkg.vhd
+ghdl -a $GhdlFlags ../tb/psi_ms_daq_cosim/psi_ms_daq_cosim_tb.vhd
+
+# bridge (simulator side) and driver side
+gcc -std=c11 -D_GNU_SOURCE -O2 -c ../tb/psi_ms_daq_cosim/psi_ms_daq_cosim_bridge.c -o $WorkDir/psi_ms_daq_cosim_bridge.o
+ghdl -e $GhdlFlags -Wl,$WorkDir/psi_ms_daq_cosim_bridge.o -Wl,-lrt -o $WorkDir/psi_ms_daq_cosim_tb psi_ms_daq_cosim_tb
+gcc -std=c11 -D_GNU_SOURCE -O2 -I../driver -o $WorkDir/psi_ms_daq_cosim_main \
+	../tb/psi_ms_daq_cosim/psi_ms_daq_cosim_main.c ../driver/psi_ms_daq.c ../driver/psi_ms_daq_cosim.c -lm -lrt
+
+# run (the simulation waits for the driver to connect)
+rm -f /tmp/psi_ms_daq_cosim.sock
+./$WorkDir/psi_ms_daq_cosim_tb -gTrigPeriod_g=$TrigPeriod &
+SimPid=$!
+while [ ! -S /tmp/psi_ms_daq_cosim.sock ]; do
+	sleep 0.1
+done
+set +e
+./$WorkDir/psi_ms_daq_cosim_main $Windows $TrigPeriod
+Result=$?
+wait $SimPid
+exit $Result
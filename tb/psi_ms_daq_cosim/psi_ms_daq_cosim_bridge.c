@@ -0,0 +1,160 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+#define _POSIX_C_SOURCE 200809L
+
+//Simulator side of the co-simulation bridge, linked into the GHDL simulation (see psi_ms_daq_cosim_pkg.vhd).
+//The driver side is implemented in driver/psi_ms_daq_cosim.c, the protocol is defined in driver/psi_ms_daq_cosim.h.
+
+#include "../../driver/psi_ms_daq_cosim.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define CYCLE_WRAP		(1ull << 30)	//Must match CosimCycleWrap_c
+
+//*******************************************************************************
+// Variables
+//*******************************************************************************
+static int listenFd = -1;
+static int connFd = -1;
+static uint8_t* mem_p = NULL;
+static size_t memSize = 0;
+static PsiMsDaq_CosimReq_t req;
+static bool irqWaiting = false;
+static uint64_t irqDeadline = 0;
+static uint64_t cycle = 0;
+static uint32_t lastCycle = 0;
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+static void Fatal(const char* const msg)
+{
+	fprintf(stderr, "psi_ms_daq_cosim_bridge: %s\n", msg);
+	exit(EXIT_FAILURE);
+}
+
+static void UpdateCycle(const int32_t cycleLow)
+{
+	//Extend the wrapping cycle counter of the simulation to 64 bits
+	const uint32_t now = (uint32_t)cycleLow;
+	cycle += (now - lastCycle) & (CYCLE_WRAP - 1);
+	lastCycle = now;
+}
+
+static void Respond(const uint32_t data)
+{
+	const PsiMsDaq_CosimRsp_t rsp = {data, 0, cycle};
+	if (sizeof(rsp) != send(connFd, &rsp, sizeof(rsp), MSG_NOSIGNAL)) {
+		Fatal("connection to driver lost");
+	}
+}
+
+//*******************************************************************************
+// Functions called from VHDL
+//*******************************************************************************
+int32_t cosim_init(const int32_t memBytes)
+{
+	//Memory model
+	shm_unlink(PSI_MS_DAQ_COSIM_SHM);
+	const int fd = shm_open(PSI_MS_DAQ_COSIM_SHM, O_RDWR | O_CREAT, 0600);
+	if ((fd < 0) || (0 != ftruncate(fd, memBytes))) {
+		return -1;
+	}
+	mem_p = mmap(NULL, memBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (MAP_FAILED == mem_p) {
+		return -1;
+	}
+	memSize = memBytes;
+	//Socket
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, PSI_MS_DAQ_COSIM_SOCKET, sizeof(addr.sun_path) - 1);
+	unlink(PSI_MS_DAQ_COSIM_SOCKET);
+	listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if ((listenFd < 0) || (0 != bind(listenFd, (struct sockaddr*)&addr, sizeof(addr))) || (0 != listen(listenFd, 1))) {
+		return -1;
+	}
+	printf("psi_ms_daq_cosim_bridge: waiting for driver on %s\n", PSI_MS_DAQ_COSIM_SOCKET);
+	fflush(stdout);
+	connFd = accept(listenFd, NULL, NULL);
+	return (connFd >= 0) ? 0 : -1;
+}
+
+int32_t cosim_poll(const int32_t irq, const int32_t cycleLow)
+{
+	UpdateCycle(cycleLow);
+	//Pending IRQ wait: let the simulation run until the IRQ is asserted or the timeout expired
+	if (irqWaiting) {
+		if ((0 != irq) || (cycle >= irqDeadline)) {
+			irqWaiting = false;
+			Respond(0 != irq);
+		}
+		return 0;
+	}
+	//Otherwise the driver is running, the simulation waits for the next request
+	size_t done = 0;
+	while (done < sizeof(req)) {
+		const ssize_t n = recv(connFd, (uint8_t*)&req + done, sizeof(req) - done, 0);
+		if (n <= 0) {
+			//Driver terminated without stop request
+			return PsiMsDaq_CosimCmd_Stop;
+		}
+		done += n;
+	}
+	if (PsiMsDaq_CosimCmd_WaitIrq == req.cmd) {
+		if (0 != irq) {
+			Respond(1);
+		} else {
+			irqWaiting = true;
+			irqDeadline = cycle + req.data;
+		}
+		return 0;
+	}
+	return req.cmd;
+}
+
+int32_t cosim_req_addr(void)
+{
+	return req.addr;
+}
+
+int32_t cosim_req_data(void)
+{
+	return req.data;
+}
+
+void cosim_respond(const int32_t data, const int32_t cycleLow)
+{
+	UpdateCycle(cycleLow);
+	Respond(data);
+}
+
+void cosim_mem_write(const int32_t addr, const int32_t dataLo, const int32_t dataHi, const int32_t strb)
+{
+	const uint64_t data = ((uint64_t)(uint32_t)dataHi << 32) | (uint32_t)dataLo;
+	for (int byte = 0; byte < 8; byte++) {
+		if (0 == (strb & (1 << byte))) {
+			continue;
+		}
+		const size_t a = (size_t)(uint32_t)addr + byte;
+		if (a >= memSize) {
+			Fatal("AXI write outside of memory model");
+		}
+		mem_p[a] = (uint8_t)(data >> (8 * byte));
+	}
+}
@@ -0,0 +1,178 @@
+/*############################################################################
+#  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+#  All rights reserved.
+#  Authors: psi_ms_daq contributors
+############################################################################*/
+
+//Driver side of the co-simulation (see sim/run_cosim.sh). Records windows of both streams of psi_ms_daq_cosim_tb,
+//checks the data and reports IRQ-to-callback latency and throughput in register clock cycles.
+//Usage: psi_ms_daq_cosim_main [windows per stream] [trigger period]
+
+#include "../../driver/psi_ms_daq_cosim.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+//*******************************************************************************
+// Constants
+//*******************************************************************************
+#define STREAMS			2
+#define MAX_WINDOWS		16				//Must match MaxWindows_g
+#define WIN_CNT			4
+#define WIN_SIZE		0x2000
+#define POST_TRIG		100
+#define CLK_FREQ		166.0e6			//Register clock frequency of the testbench
+#define IRQ_TIMEOUT		1000000			//Cycles
+
+//*******************************************************************************
+// Types
+//*******************************************************************************
+typedef struct {
+	uint32_t windows;
+	uint64_t bytes;
+	uint32_t errors;
+	bool hasLastTrig;
+	uint16_t lastTrig;
+} StrState_t;
+
+//*******************************************************************************
+// Variables
+//*******************************************************************************
+static StrState_t strState[STREAMS];
+static uint32_t trigPeriod = 1000;
+static uint64_t irqCycle = 0;
+static uint64_t latMin = UINT64_MAX;
+static uint64_t latMax = 0;
+static uint64_t latSum = 0;
+static uint64_t latCnt = 0;
+
+//*******************************************************************************
+// Private Functions
+//*******************************************************************************
+static void WinCallback(PsiMsDaq_WinInfo_t winInfo, void* arg)
+{
+	StrState_t* const str_p = (StrState_t*) arg;
+	static uint16_t data[WIN_SIZE / 2];
+	uint32_t samples = 0;
+	uint32_t preTrig = 0;
+	//Latency from the IRQ being asserted to the callback
+	const uint64_t lat = PsiMsDaq_Cosim_GetCycle(NULL) - irqCycle;
+	latMin = (lat < latMin) ? lat : latMin;
+	latMax = (lat > latMax) ? lat : latMax;
+	latSum += lat;
+	latCnt++;
+	//Read data
+	if ((PsiMsDaq_RetCode_Success != PsiMsDaq_StrWin_GetNoOfSamples(winInfo, &samples)) ||
+		(PsiMsDaq_RetCode_Success != PsiMsDaq_StrWin_GetPreTrigSamples(winInfo, &preTrig)) ||
+		(PsiMsDaq_RetCode_Success != PsiMsDaq_StrWin_GetDataUnwrapped(winInfo, preTrig, samples - preTrig, data, sizeof(data)))) {
+		printf("ERROR: Stream %p window %d could not be read\n", winInfo.strHandle, winInfo.winNr);
+		str_p->errors++;
+		PsiMsDaq_StrWin_MarkAsFree(winInfo);
+		return;
+	}
+	//Counter data must be consecutive
+	for (uint32_t i = 1; i < samples; i++) {
+		if ((uint16_t)(data[i-1] + 1) != data[i]) {
+			printf("ERROR: Window %d: sample %u is 0x%04x, expected 0x%04x\n", winInfo.winNr, i, data[i], (uint16_t)(data[i-1] + 1));
+			str_p->errors++;
+			break;
+		}
+	}
+	//Triggers must be a multiple of the trigger period apart
+	const uint16_t trig = data[preTrig];
+	if (str_p->hasLastTrig && (0 != (uint16_t)(trig - str_p->lastTrig) % trigPeriod)) {
+		printf("ERROR: Window %d: trigger sample 0x%04x does not match previous trigger 0x%04x\n", winInfo.winNr, trig, str_p->lastTrig);
+		str_p->errors++;
+	}
+	str_p->hasLastTrig = true;
+	str_p->lastTrig = trig;
+	str_p->windows++;
+	str_p->bytes += samples * 2;
+	PsiMsDaq_StrWin_MarkAsFree(winInfo);
+}
+
+//*******************************************************************************
+// Main
+//*******************************************************************************
+int main(int argc, char** argv)
+{
+	const uint32_t windows = (argc > 1) ? (uint32_t)atoi(argv[1]) : 100;
+	trigPeriod = (argc > 2) ? (uint32_t)atoi(argv[2]) : trigPeriod;
+
+	//Connect
+	PsiMsDaq_AccessFct_t accessFct;
+	if (!PsiMsDaq_Cosim_Connect(NULL, NULL, &accessFct)) {
+		printf("ERROR: Connection to simulation failed\n");
+		return EXIT_FAILURE;
+	}
+	if (PsiMsDaq_Cosim_GetMemSize() < STREAMS * WIN_CNT * WIN_SIZE) {
+		printf("ERROR: Memory model too small\n");
+		PsiMsDaq_Cosim_Disconnect(true);
+		return EXIT_FAILURE;
+	}
+	PsiMsDaq_IpHandle ip = PsiMsDaq_Init(0, STREAMS, MAX_WINDOWS, &accessFct);
+	PsiMsDaq_SetAddrTranslate(ip, PsiMsDaq_Cosim_AddrTranslate);
+	PsiMsDaq_SetTimeSource(ip, PsiMsDaq_Cosim_GetCycle, NULL);
+
+	//Configure streams
+	for (int i = 0; i < STREAMS; i++) {
+		PsiMsDaq_StrHandle str;
+		PsiMsDaq_StrConfig_t cfg = {
+			.postTrigSamples = POST_TRIG,
+			.recMode = PsiMsDaqn_RecMode_Continuous,
+			.winAsRingbuf = true,
+			.winOverwrite = false,
+			.winCnt = WIN_CNT,
+			.bufStartAddr = i * WIN_CNT * WIN_SIZE,
+			.winSize = WIN_SIZE,
+			.streamWidthBits = 16
+		};
+		if ((PsiMsDaq_RetCode_Success != PsiMsDaq_GetStrHandle(ip, i, &str)) ||
+			(PsiMsDaq_RetCode_Success != PsiMsDaq_Str_Configure(str, &cfg)) ||
+			(PsiMsDaq_RetCode_Success != PsiMsDaq_Str_SetIrqCallbackWin(str, WinCallback, &strState[i]))) {
+			printf("ERROR: Configuration of stream %d failed\n", i);
+			PsiMsDaq_Cosim_Disconnect(true);
+			return EXIT_FAILURE;
+		}
+	}
+	PsiMsDaq_Grp_SetIrqEnable(ip, (1 << STREAMS) - 1, true);
+	PsiMsDaq_Grp_SetEnable(ip, (1 << STREAMS) - 1, true);
+
+	//Record
+	const uint64_t startCycle = PsiMsDaq_Cosim_GetCycle(NULL);
+	bool timeout = false;
+	while ((strState[0].windows < windows) || (strState[1].windows < windows)) {
+		bool irq;
+		PsiMsDaq_Cosim_WaitIrq(IRQ_TIMEOUT, &irq);
+		if (!irq) {
+			timeout = true;
+			break;
+		}
+		irqCycle = PsiMsDaq_Cosim_GetCycle(NULL);
+		PsiMsDaq_HandleIrq(ip);
+	}
+	const uint64_t cycles = PsiMsDaq_Cosim_GetCycle(NULL) - startCycle;
+
+	//Report
+	uint32_t errors = timeout ? 1 : 0;
+	uint64_t bytes = 0;
+	for (int i = 0; i < STREAMS; i++) {
+		printf("Stream %d: %u windows, %llu bytes, %u errors\n", i, strState[i].windows,
+				(unsigned long long)strState[i].bytes, strState[i].errors);
+		errors += strState[i].errors;
+		bytes += strState[i].bytes;
+	}
+	if (timeout) {
+		printf("ERROR: No IRQ within %u cycles\n", IRQ_TIMEOUT);
+	}
+	if (latCnt > 0) {
+		printf("IRQ-to-callback latency [cycles]: min %llu, avg %.1f, max %llu\n", (unsigned long long)latMin,
+				(double)latSum / latCnt, (unsigned long long)latMax);
+	}
+	if (cycles > 0) {
+		printf("Throughput: %llu bytes in %llu cycles (%.1f MB/s at %.0f MHz)\n", (unsigned long long)bytes,
+				(unsigned long long)cycles, bytes * CLK_FREQ / cycles / 1e6, CLK_FREQ / 1e6);
+	}
+	PsiMsDaq_Cosim_Disconnect(true);
+	printf("%s\n", (0 == errors) ? "Co-simulation passed" : "Co-simulation FAILED");
+	return (0 == errors) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,111 @@
+------------------------------------------------------------------------------
+--  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+--  All rights reserved.
+--  Authors: psi_ms_daq contributors
+------------------------------------------------------------------------------
+
+------------------------------------------------------------
+-- Description
+------------------------------------------------------------
+-- Interface to the co-simulation bridge (psi_ms_daq_cosim_bridge.c) that
+-- connects the C driver to the simulation. The functions are implemented in
+-- C and linked into the simulation (GHDL VHPIDIRECT), the VHDL bodies are
+-- never executed.
+
+------------------------------------------------------------
+-- Libraries
+------------------------------------------------------------
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+------------------------------------------------------------
+-- Package Header
+------------------------------------------------------------
+package psi_ms_daq_cosim_pkg is
+
+	-- Requests returned by cosim_poll (must match PsiMsDaq_CosimCmd_t)
+	constant CosimReq_None_c	: integer	:= 0;
+	constant CosimReq_Read_c	: integer	:= 1;
+	constant CosimReq_Write_c	: integer	:= 2;
+	constant CosimReq_Stop_c	: integer	:= 4;
+
+	-- Cycle counter wraps at this value (extended to 64 bits by the bridge)
+	constant CosimCycleWrap_c	: integer	:= 2**30;
+
+	-- Create the shared memory and wait for the driver to connect (returns 0 on success)
+	impure function cosim_init(	memBytes	: integer) return integer;
+	attribute foreign of cosim_init : function is "VHPIDIRECT cosim_init";
+
+	-- Called every register clock cycle, returns the next register access to execute (CosimReq_xxx_c).
+	-- Blocks while the driver is busy, so simulation time only advances while the driver waits for the simulation.
+	impure function cosim_poll(	irq			: integer;
+								cycle		: integer) return integer;
+	attribute foreign of cosim_poll : function is "VHPIDIRECT cosim_poll";
+
+	-- Address and data of the request returned by the last cosim_poll call
+	impure function cosim_req_addr return integer;
+	attribute foreign of cosim_req_addr : function is "VHPIDIRECT cosim_req_addr";
+
+	impure function cosim_req_data return integer;
+	attribute foreign of cosim_req_data : function is "VHPIDIRECT cosim_req_data";
+
+	-- Complete the request returned by the last cosim_poll call
+	procedure cosim_respond(	data		: integer;
+								cycle		: integer);
+	attribute foreign of cosim_respond : procedure is "VHPIDIRECT cosim_respond";
+
+	-- Write one 64-bit beat into the memory model (strb: one bit per byte)
+	procedure cosim_mem_write(	addr		: integer;
+								dataLo		: integer;
+								dataHi		: integer;
+								strb		: integer);
+	attribute foreign of cosim_mem_write : procedure is "VHPIDIRECT cosim_mem_write";
+
+end psi_ms_daq_cosim_pkg;
+
+------------------------------------------------------------
+-- Package Body
+------------------------------------------------------------
+package body psi_ms_daq_cosim_pkg is
+
+	impure function cosim_init(	memBytes	: integer) return integer is
+	begin
+		assert false report "cosim_init: VHPIDIRECT bridge not linked" severity failure;
+		return -1;
+	end function;
+
+	impure function cosim_poll(	irq			: integer;
+								cycle		: integer) return integer is
+	begin
+		assert false report "cosim_poll: VHPIDIRECT bridge not linked" severity failure;
+		return CosimReq_Stop_c;
+	end function;
+
+	impure function cosim_req_addr return integer is
+	begin
+		assert false report "cosim_req_addr: VHPIDIRECT bridge not linked" severity failure;
+		return 0;
+	end function;
+
+	impure function cosim_req_data return integer is
+	begin
+		assert false report "cosim_req_data: VHPIDIRECT bridge not linked" severity failure;
+		return 0;
+	end function;
+
+	procedure cosim_respond(	data		: integer;
+								cycle		: integer) is
+	begin
+		assert false report "cosim_respond: VHPIDIRECT bridge not linked" severity failure;
+	end procedure;
+
+	procedure cosim_mem_write(	addr		: integer;
+								dataLo		: integer;
+								dataHi		: integer;
+								strb		: integer) is
+	begin
+		assert false report "cosim_mem_write: VHPIDIRECT bridge not linked" severity failure;
+	end procedure;
+
+end psi_ms_daq_cosim_pkg;
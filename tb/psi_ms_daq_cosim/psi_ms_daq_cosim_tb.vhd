@@ -0,0 +1,396 @@
+------------------------------------------------------------------------------
+--  Copyright (c) 2026 by Paul Scherrer Institute, Switzerland
+--  All rights reserved.
+--  Authors: psi_ms_daq contributors
+------------------------------------------------------------------------------
+
+------------------------------------------------------------
+-- Description
+------------------------------------------------------------
+-- Co-simulation of the C driver against psi_ms_daq_axi (GHDL only, see
+-- sim/run_cosim.sh). Register accesses are requested by the driver through
+-- the bridge and executed on the AXI slave interface. The AXI master writes
+-- into a memory model that lives in shared memory, so the driver reads the
+-- recorded data directly. Each stream delivers a 16-bit counter and a trigger
+-- every TrigPeriod_g samples. The timestamp is the register clock cycle count,
+-- so it has the same time base as the cycle count reported to the driver.
+
+------------------------------------------------------------
+-- Libraries
+------------------------------------------------------------
+library ieee;
+	use ieee.std_logic_1164.all;
+	use ieee.numeric_std.all;
+
+library work;
+	use work.psi_common_math_pkg.all;
+	use work.psi_common_array_pkg.all;
+	use work.psi_ms_daq_pkg.all;
+	use work.psi_ms_daq_cosim_pkg.all;
+
+------------------------------------------------------------
+-- Entity Declaration
+------------------------------------------------------------
+entity psi_ms_daq_cosim_tb is
+	generic (
+		MemBytes_g		: positive	:= 65536;
+		TrigPeriod_g	: positive	:= 1000;
+		SplPeriod_g		: positive	:= 1
+	);
+end entity;
+
+------------------------------------------------------------
+-- Architecture
+------------------------------------------------------------
+architecture sim of psi_ms_daq_cosim_tb is
+
+	-- TB Control
+	signal TbRunning 	: boolean 	:= true;
+
+	-- Constants
+	constant StrCount_c	: integer	:= 2;
+	constant ClkFreq_c	: t_areal	:= (100.0e6, 125.0e6);
+
+	-- Port signals
+	signal Str_Clk			: std_logic_vector(StrCount_c-1 downto 0)	:= (others => '0');
+	signal Str_Data			: t_aslv64(StrCount_c-1 downto 0)			:= (others => (others => '0'));
+	signal Timestamp		: t_aslv64(StrCount_c-1 downto 0)			:= (others => (others => '0'));
+	signal Str_Vld			: std_logic_vector(StrCount_c-1 downto 0)	:= (others => '0');
+	signal Str_Rdy			: std_logic_vector(StrCount_c-1 downto 0)	:= (others => '0');
+	signal Str_Trig			: std_logic_vector(StrCount_c-1 downto 0)	:= (others => '0');
+	signal M_Axi_Aclk		: std_logic									:= '0';
+	signal S_Axi_Aclk		: std_logic									:= '0';
+	signal M_Axi_Aresetn	: std_logic									:= '0';
+	signal S_Axi_Aresetn	: std_logic									:= '0';
+	signal Irq				: std_logic									:= '0';
+
+	-- Register AXI (single beat accesses only)
+	signal S_ArAddr			: std_logic_vector(15 downto 0)				:= (others => '0');
+	signal S_ArValid		: std_logic									:= '0';
+	signal S_ArReady		: std_logic									:= '0';
+	signal S_RData			: std_logic_vector(31 downto 0)				:= (others => '0');
+	signal S_RValid			: std_logic									:= '0';
+	signal S_RReady			: std_logic									:= '0';
+	signal S_AwAddr			: std_logic_vector(15 downto 0)				:= (others => '0');
+	signal S_AwValid		: std_logic									:= '0';
+	signal S_AwReady		: std_logic									:= '0';
+	signal S_WData			: std_logic_vector(31 downto 0)				:= (others => '0');
+	signal S_WValid			: std_logic									:= '0';
+	signal S_WReady			: std_logic									:= '0';
+	signal S_BValid			: std_logic									:= '0';
+	signal S_BReady			: std_logic									:= '0';
+
+	-- Memory AXI (write only)
+	signal M_AwAddr			: std_logic_vector(31 downto 0)				:= (others => '0');
+	signal M_AwLen			: std_logic_vector(7 downto 0)				:= (others => '0');
+	signal M_AwValid		: std_logic									:= '0';
+	signal M_AwReady		: std_logic									:= '0';
+	signal M_WData			: std_logic_vector(63 downto 0)				:= (others => '0');
+	signal M_WStrb			: std_logic_vector(7 downto 0)				:= (others => '0');
+	signal M_WLast			: std_logic									:= '0';
+	signal M_WValid			: std_logic									:= '0';
+	signal M_WReady			: std_logic									:= '0';
+	signal M_BValid			: std_logic									:= '0';
+	signal M_BReady			: std_logic									:= '0';
+
+	-- Cycle counter of the register clock
+	signal CycleCnt			: unsigned(63 downto 0)						:= (others => '0');
+	signal Cycle			: integer range 0 to CosimCycleWrap_c-1		:= 0;
+
+	procedure RegWrite(	Address	: in	integer;
+						Value	: in	integer;
+						signal	AwAddr	: out	std_logic_vector;
+						signal	AwValid	: out	std_logic;
+						signal	AwReady	: in	std_logic;
+						signal	WData	: out	std_logic_vector;
+						signal	WValid	: out	std_logic;
+						signal	WReady	: in	std_logic;
+						signal	BValid	: in	std_logic;
+						signal	BReady	: out	std_logic) is
+		variable AwDone_v	: boolean	:= false;
+		variable WDone_v	: boolean	:= false;
+	begin
+		AwAddr	<= std_logic_vector(to_unsigned(Address, AwAddr'length));
+		AwValid	<= '1';
+		WData	<= std_logic_vector(to_signed(Value, WData'length));
+		WValid	<= '1';
+		while not (AwDone_v and WDone_v) loop
+			wait until rising_edge(S_Axi_Aclk);
+			if AwReady = '1' then
+				AwValid 	<= '0';
+				AwDone_v	:= true;
+			end if;
+			if WReady = '1' then
+				WValid		<= '0';
+				WDone_v		:= true;
+			end if;
+		end loop;
+		BReady <= '1';
+		wait until rising_edge(S_Axi_Aclk) and BValid = '1';
+		BReady <= '0';
+	end procedure;
+
+	procedure RegRead(	Address	: in	integer;
+						Value	: out	integer;
+						signal	ArAddr	: out	std_logic_vector;
+						signal	ArValid	: out	std_logic;
+						signal	ArReady	: in	std_logic;
+						signal	RData	: in	std_logic_vector;
+						signal	RValid	: in	std_logic;
+						signal	RReady	: out	std_logic) is
+	begin
+		ArAddr	<= std_logic_vector(to_unsigned(Address, ArAddr'length));
+		ArValid	<= '1';
+		wait until rising_edge(S_Axi_Aclk) and ArReady = '1';
+		ArValid	<= '0';
+		RReady	<= '1';
+		wait until rising_edge(S_Axi_Aclk) and RValid = '1';
+		Value	:= to_integer(signed(RData));
+		RReady	<= '0';
+	end procedure;
+
+begin
+	------------------------------------------------------------
+	-- DUT Instantiation
+	------------------------------------------------------------
+	i_dut : entity work.psi_ms_daq_axi
+		generic map (
+			Streams_g				=> StrCount_c,
+			StreamWidth_g			=> (16, 16),
+			StreamPrio_g			=> (1, 1),
+			StreamBuffer_g			=> (1024, 1024),
+			StreamTimeout_g			=> (5.0e-6, 5.0e-6),
+			StreamClkFreq_g			=> ClkFreq_c,
+			StreamTsFifoDepth_g		=> (16, 16),
+			StreamUseTs_g			=> (true, true),
+			MaxWindows_g			=> 16,
+			MinBurstSize_g			=> 16,
+			MaxBurstSize_g			=> 128,
+			AxiFifoDepth_g			=> 512,
+			AxiSlaveIdWidth_g		=> 1
+		)
+		port map (
+			Str_Clk						=> Str_Clk,
+			Str_Data					=> Str_Data,
+			Str_Ts						=> Timestamp,
+			Str_Vld						=> Str_Vld,
+			Str_Rdy						=> Str_Rdy,
+			Str_Trig					=> Str_Trig,
+			Irq							=> Irq,
+			S_Axi_Aclk					=> S_Axi_Aclk,
+			S_Axi_Aresetn				=> S_Axi_Aresetn,
+			S_Axi_ArId					=> "0",
+			S_Axi_ArAddr				=> S_ArAddr,
+			S_Axi_Arlen					=> X"00",
+			S_Axi_ArSize				=> "010",
+			S_Axi_ArBurst				=> "01",
+			S_Axi_ArLock				=> '0',
+			S_Axi_ArCache				=> "0000",
+			S_Axi_ArProt				=> "000",
+			S_Axi_ArValid				=> S_ArValid,
+			S_Axi_ArReady				=> S_ArReady,
+			S_Axi_RId					=> open,
+			S_Axi_RData					=> S_RData,
+			S_Axi_RResp					=> open,
+			S_Axi_RLast					=> open,
+			S_Axi_RValid				=> S_RValid,
+			S_Axi_RReady				=> S_RReady,
+			S_Axi_AwId					=> "0",
+			S_Axi_AwAddr				=> S_AwAddr,
+			S_Axi_AwLen					=> X"00",
+			S_Axi_AwSize				=> "010",
+			S_Axi_AwBurst				=> "01",
+			S_Axi_AwLock				=> '0',
+			S_Axi_AwCache				=> "0000",
+			S_Axi_AwProt				=> "000",
+			S_Axi_AwValid				=> S_AwValid,
+			S_Axi_AwReady				=> S_AwReady,
+			S_Axi_WData					=> S_WData,
+			S_Axi_WStrb					=> "1111",
+			S_Axi_WLast					=> '1',
+			S_Axi_WValid				=> S_WValid,
+			S_Axi_WReady				=> S_WReady,
+			S_Axi_BId					=> open,
+			S_Axi_BResp					=> open,
+			S_Axi_BValid				=> S_BValid,
+			S_Axi_BReady				=> S_BReady,
+			M_Axi_Aclk					=> M_Axi_Aclk,
+			M_Axi_Aresetn				=> M_Axi_Aresetn,
+			M_Axi_AwAddr				=> M_AwAddr,
+			M_Axi_AwLen					=> M_AwLen,
+			M_Axi_AwSize				=> open,
+			M_Axi_AwBurst				=> open,
+			M_Axi_AwLock				=> open,
+			M_Axi_AwCache				=> open,
+			M_Axi_AwProt				=> open,
+			M_Axi_AwValid				=> M_AwValid,
+			M_Axi_AwReady				=> M_AwReady,
+			M_Axi_WData					=> M_WData,
+			M_Axi_WStrb					=> M_WStrb,
+			M_Axi_WLast					=> M_WLast,
+			M_Axi_WValid				=> M_WValid,
+			M_Axi_WReady				=> M_WReady,
+			M_Axi_BResp					=> "00",
+			M_Axi_BValid				=> M_BValid,
+			M_Axi_BReady				=> M_BReady,
+			M_Axi_ArAddr				=> open,
+			M_Axi_ArLen					=> open,
+			M_Axi_ArSize				=> open,
+			M_Axi_ArBurst				=> open,
+			M_Axi_ArLock				=> open,
+			M_Axi_ArCache				=> open,
+			M_Axi_ArProt				=> open,
+			M_Axi_ArValid				=> open,
+			M_Axi_ArReady				=> '0',
+			M_Axi_RData					=> (others => '0'),
+			M_Axi_RResp					=> "00",
+			M_Axi_RLast					=> '0',
+			M_Axi_RValid				=> '0',
+			M_Axi_RReady				=> open
+		);
+
+	------------------------------------------------------------
+	-- Emulate Memory (content in shared memory)
+	------------------------------------------------------------
+	p_mem : process
+		variable Address_v		: integer;
+		variable Size_v			: integer;
+	begin
+		wait until rising_edge(M_Axi_Aclk);
+		while TbRunning loop
+			M_AwReady <= '1';
+			wait until (rising_edge(M_Axi_Aclk) and M_AwValid = '1') or (not TbRunning);
+			if TbRunning then
+				M_AwReady	<= '0';
+				M_WReady	<= '1';
+				Address_v	:= to_integer(unsigned(M_AwAddr));
+				Size_v		:= to_integer(unsigned(M_AwLen))+1;
+				for qw in 0 to Size_v-1 loop
+					wait until rising_edge(M_Axi_Aclk) and M_WValid = '1';
+					cosim_mem_write(Address_v+qw*8,
+									to_integer(signed(M_WData(31 downto 0))),
+									to_integer(signed(M_WData(63 downto 32))),
+									to_integer(unsigned(M_WStrb)));
+				end loop;
+				assert M_WLast = '1' report "###ERROR###: Last not received at end of burst" severity error;
+				M_WReady	<= '0';
+				M_BValid	<= '1';
+				wait until rising_edge(M_Axi_Aclk) and M_BReady = '1';
+				M_BValid	<= '0';
+			end if;
+		end loop;
+		wait;
+	end process;
+
+	------------------------------------------------------------
+	-- Clocks
+	------------------------------------------------------------
+	p_clk_axi_mem : process
+		constant Frequency_c : real := real(200e6);
+	begin
+		while TbRunning loop
+			wait for 0.5*(1 sec)/Frequency_c;
+			M_Axi_Aclk <= not M_Axi_Aclk;
+		end loop;
+		wait;
+	end process;
+
+	p_clk_axi_reg : process
+		constant Frequency_c : real := real(166e6);
+	begin
+		while TbRunning loop
+			wait for 0.5*(1 sec)/Frequency_c;
+			S_Axi_Aclk <= not S_Axi_Aclk;
+		end loop;
+		wait;
+	end process;
+
+	g_clk_str : for i in 0 to StrCount_c-1 generate
+		p_clk_str : process
+		begin
+			while TbRunning loop
+				wait for 0.5*(1 sec)/(ClkFreq_c(i)+0.1e6);
+				Str_Clk(i) <= not Str_Clk(i);
+			end loop;
+			wait;
+		end process;
+	end generate;
+
+	------------------------------------------------------------
+	-- Cycle Counter / Timestamp
+	------------------------------------------------------------
+	p_cycle : process(S_Axi_Aclk)
+	begin
+		if rising_edge(S_Axi_Aclk) then
+			CycleCnt	<= CycleCnt + 1;
+			Cycle		<= to_integer(CycleCnt(29 downto 0));
+		end if;
+	end process;
+	Timestamp <= (others => std_logic_vector(CycleCnt));
+
+	------------------------------------------------------------
+	-- Bridge Process
+	------------------------------------------------------------
+	p_bridge : process
+		variable Req_v		: integer;
+		variable Data_v		: integer;
+		variable IrqInt_v	: integer;
+	begin
+		assert cosim_init(MemBytes_g) = 0 report "###ERROR###: co-simulation bridge initialization failed" severity failure;
+		wait for 1 us;
+		S_Axi_Aresetn <= '1';
+		M_Axi_Aresetn <= '1';
+		wait until rising_edge(S_Axi_Aclk);
+
+		while TbRunning loop
+			wait until rising_edge(S_Axi_Aclk);
+			if Irq = '1' then
+				IrqInt_v := 1;
+			else
+				IrqInt_v := 0;
+			end if;
+			Req_v := cosim_poll(IrqInt_v, Cycle);
+			case Req_v is
+				when CosimReq_Read_c =>
+					RegRead(cosim_req_addr, Data_v, S_ArAddr, S_ArValid, S_ArReady, S_RData, S_RValid, S_RReady);
+					cosim_respond(Data_v, Cycle);
+				when CosimReq_Write_c =>
+					RegWrite(cosim_req_addr, cosim_req_data, S_AwAddr, S_AwValid, S_AwReady, S_WData, S_WValid, S_WReady, S_BValid, S_BReady);
+					cosim_respond(0, Cycle);
+				when CosimReq_Stop_c =>
+					TbRunning <= false;
+				when others => null;
+			end case;
+		end loop;
+		wait;
+	end process;
+
+	------------------------------------------------------------
+	-- Data Generation Processes
+	------------------------------------------------------------
+	g_str : for i in 0 to StrCount_c-1 generate
+		p_str : process
+			variable Spl_v	: integer	:= 0;
+		begin
+			wait until rising_edge(Str_Clk(i)) and S_Axi_Aresetn = '1';
+			while TbRunning loop
+				Str_Data(i)(15 downto 0)	<= std_logic_vector(to_unsigned(Spl_v mod 2**16, 16));
+				Str_Vld(i)					<= '1';
+				if Spl_v mod TrigPeriod_g = TrigPeriod_g-1 then
+					Str_Trig(i)	<= '1';
+				else
+					Str_Trig(i)	<= '0';
+				end if;
+				wait until rising_edge(Str_Clk(i));
+				Str_Vld(i)	<= '0';
+				Str_Trig(i)	<= '0';
+				Spl_v		:= Spl_v + 1;
+				for c in 1 to SplPeriod_g-1 loop
+					wait until rising_edge(Str_Clk(i));
+				end loop;
+			end loop;
+			wait;
+		end process;
+	end generate;
+
+end;